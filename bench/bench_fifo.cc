@@ -0,0 +1,159 @@
+#include "bench_helper.h"
+#include "core/fifo.h"
+#include "core/mpmc_queue.h"
+#include "core/unbounded_queue.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr static uint32_t queue_size = 1024;
+constexpr static size_t   batch_size = 16;
+
+/// half of threads produce and half consume the same count of items,
+/// a single thread pushes and pops in turns.
+template <typename queue_type, typename push_type, typename pop_type>
+void bench_threads(esim_bench::bench_state &state, std::string_view label, size_t items,
+                   push_type &&push, pop_type &&pop) noexcept {
+  for (size_t threads : {1, 2, 4, 8, 16}) {
+    size_t pairs = std::max<size_t>(1, threads / 2);
+    size_t per_thread = items / pairs;
+    state.measure(std::string(label) + " x" + std::to_string(threads),
+                  static_cast<double>(per_thread * pairs), [&]() {
+      queue_type queue{queue_size};
+      if (1 == threads) {
+        for (size_t i = 0; i < per_thread; i += batch_size) {
+          push(queue, i);
+          pop(queue);
+        }
+
+        return;
+      }
+
+      std::vector<std::thread> workers;
+      for (size_t t = 0; t < pairs; ++t) {
+        workers.emplace_back([&]() {
+          for (size_t i = 0; i < per_thread; i += batch_size) {
+            push(queue, i);
+          }
+        });
+        workers.emplace_back([&]() {
+          for (size_t i = 0; i < per_thread; i += batch_size) {
+            pop(queue);
+          }
+        });
+      }
+      for (auto &worker : workers) {
+        worker.join();
+      }
+    });
+  }
+}
+
+/// a call moves batch_size items one by one.
+template <typename queue_type>
+void push_each(queue_type &queue, size_t first) noexcept {
+  for (size_t i = 0; i < batch_size; ++i) {
+    queue.push(first + i);
+  }
+}
+
+template <typename queue_type>
+void pop_each(queue_type &queue) noexcept {
+  size_t value;
+  for (size_t i = 0; i < batch_size; ++i) {
+    queue.pop(value);
+  }
+}
+
+/// a call moves batch_size items by batches, retried until all moved.
+void push_batch(esim::core::mpmc_queue<size_t> &queue, size_t first) noexcept {
+  size_t values[batch_size];
+  for (size_t i = 0; i < batch_size; ++i) {
+    values[i] = first + i;
+  }
+  for (size_t pushed = 0; pushed < batch_size;) {
+    size_t n = queue.try_push_n(values + pushed, batch_size - pushed);
+    if (0 == n) {
+      std::this_thread::yield();
+    }
+    pushed += n;
+  }
+}
+
+void pop_batch(esim::core::mpmc_queue<size_t> &queue) noexcept {
+  size_t values[batch_size];
+  for (size_t popped = 0; popped < batch_size;) {
+    size_t n = queue.try_pop_n(values + popped, batch_size - popped);
+    if (0 == n) {
+      std::this_thread::yield();
+    }
+    popped += n;
+  }
+}
+
+/// per-op cost in one thread, then streamed and ping-ponged between two threads.
+template <typename queue_type>
+void bench_latency(esim_bench::bench_state &state, std::string_view label, size_t items) noexcept {
+  state.measure(std::string(label) + " push+pop", static_cast<double>(items), [&]() {
+    queue_type queue{queue_size};
+    size_t     value;
+    for (size_t i = 0; i < items; ++i) {
+      queue.push(i);
+      queue.pop(value);
+    }
+  });
+  state.measure(std::string(label) + " stream", static_cast<double>(items), [&]() {
+    queue_type  queue{queue_size};
+    std::thread consumer([&]() {
+      size_t value;
+      for (size_t i = 0; i < items; ++i) {
+        queue.pop(value);
+      }
+    });
+    for (size_t i = 0; i < items; ++i) {
+      queue.push(i);
+    }
+    consumer.join();
+  });
+  state.measure(std::string(label) + " round trip", static_cast<double>(items / 64), [&]() {
+    queue_type  ping{queue_size}, pong{queue_size};
+    std::thread echo([&]() {
+      size_t value;
+      for (size_t i = 0; i < items / 64; ++i) {
+        ping.pop(value);
+        pong.push(value);
+      }
+    });
+    size_t value;
+    for (size_t i = 0; i < items / 64; ++i) {
+      ping.push(i);
+      pong.pop(value);
+    }
+    echo.join();
+  });
+}
+
+} // namespace
+
+BENCH(fifo_spsc_latency) {
+  constexpr static size_t items = 1 << 20;
+  using esim::core::fifo;
+  bench_latency<fifo<size_t>>(state, "fifo mpmc", items);
+  bench_latency<fifo<size_t, esim::core::spsc>>(state, "fifo spsc", items);
+}
+
+BENCH(fifo_mpmc_throughput) {
+  constexpr static size_t items = 1 << 18;
+  using esim::core::fifo;
+  using esim::core::mpmc_queue;
+  using esim::core::unbounded_queue;
+  bench_threads<fifo<size_t>>(state, "fifo", items, push_each<fifo<size_t>>, pop_each<fifo<size_t>>);
+  bench_threads<mpmc_queue<size_t>>(state, "mpmc_queue", items,
+                                    push_each<mpmc_queue<size_t>>, pop_each<mpmc_queue<size_t>>);
+  bench_threads<mpmc_queue<size_t>>(state, "mpmc_queue batch", items, push_batch, pop_batch);
+  bench_threads<unbounded_queue<size_t>>(state, "unbounded_queue", items,
+                                         push_each<unbounded_queue<size_t>>, pop_each<unbounded_queue<size_t>>);
+}
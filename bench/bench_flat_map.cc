@@ -0,0 +1,81 @@
+#include "bench_helper.h"
+#include "core/flat_map.h"
+#include "core/transform.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+/// the previous hash of maptile, kept for comparison.
+struct legacy_maptile_hash {
+  std::size_t operator()(const esim::geo::maptile &tile) const noexcept {
+
+    return (tile.x << 31) + tile.y;
+  }
+};
+
+/// a 100k tiles of a deep zoom region, as the basemap storage sees it.
+std::vector<esim::geo::maptile> gen_tiles(size_t count) noexcept {
+  std::vector<esim::geo::maptile> tiles;
+  const uint32_t side = static_cast<uint32_t>(std::sqrt(static_cast<double>(count))) + 1;
+  const uint32_t origin_x = 93000, origin_y = 214000;
+  for (uint32_t x = 0; x < side && tiles.size() < count; ++x) {
+    for (uint32_t y = 0; y < side && tiles.size() < count; ++y) {
+      tiles.emplace_back(esim::geo::maptile{18, origin_x + x, origin_y + y});
+    }
+  }
+  std::shuffle(tiles.begin(), tiles.end(), std::mt19937_64(42));
+
+  return tiles;
+}
+
+template <typename map_type>
+void bench_lookup(esim_bench::bench_state &state, std::string_view label,
+                  const std::vector<esim::geo::maptile> &tiles) noexcept {
+  map_type map;
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    map[tiles[i]] = i;
+  }
+
+  std::vector<esim::geo::maptile> misses(tiles);
+  for (auto &tile : misses) {
+    tile.lod = 17;
+  }
+
+  size_t sink = 0;
+  state.measure(std::string(label) + " hit", static_cast<double>(tiles.size()), [&]() {
+    for (auto &tile : tiles) {
+      sink += map.find(tile)->second;
+    }
+  });
+  state.measure(std::string(label) + " miss", static_cast<double>(misses.size()), [&]() {
+    for (auto &tile : misses) {
+      sink += map.count(tile);
+    }
+  });
+  state.measure(std::string(label) + " build", static_cast<double>(tiles.size()), [&]() {
+    map_type fresh;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+      fresh[tiles[i]] = i;
+    }
+    sink += fresh.size();
+  });
+
+  if (sink == 0) {
+    std::printf("  unexpected empty result\n");
+  }
+}
+
+} // namespace
+
+BENCH(maptile_map_100k) {
+  auto tiles = gen_tiles(100000);
+  bench_lookup<std::unordered_map<esim::geo::maptile, size_t, legacy_maptile_hash>>(
+      state, "unordered_map legacy hash", tiles);
+  bench_lookup<std::unordered_map<esim::geo::maptile, size_t>>(
+      state, "unordered_map morton hash", tiles);
+  bench_lookup<esim::core::flat_map<esim::geo::maptile, size_t>>(
+      state, "flat_map morton hash", tiles);
+}
@@ -0,0 +1,83 @@
+#ifndef __ESIM_BENCH_BENCH_HELPER_H_
+#define __ESIM_BENCH_BENCH_HELPER_H_
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace esim_bench {
+
+/**
+ * @brief Measures the repeated runs of a benchmark body.
+ *
+ */
+class bench_state {
+public:
+  /**
+   * @brief Run the body repeatedly for at least the minimum time and report.
+   *
+   * @param label specifies the label of measurement.
+   * @param items specifies the items processed per run, for throughput.
+   * @param fn specifies the body to measure.
+   */
+  template <typename fn_type>
+  void measure(std::string_view label, double items, fn_type &&fn) noexcept {
+    using namespace std::chrono;
+    fn(); /// warm up.
+
+    size_t runs = 0;
+    auto   start = steady_clock::now();
+    auto   elapsed = steady_clock::duration::zero();
+    do {
+      fn();
+      ++runs;
+      elapsed = steady_clock::now() - start;
+    } while (elapsed < min_time_);
+
+    double seconds = duration<double>(elapsed).count();
+    std::printf("  %-40.*s %12.3f us/run %14.1f items/s\n",
+                static_cast<int>(label.size()), label.data(),
+                seconds * 1e6 / runs, items * runs / seconds);
+  }
+
+  /**
+   * @brief Obtain the minimum time of a measurement.
+   *
+   * @return the minimum time.
+   */
+  std::chrono::milliseconds min_time() const noexcept { return min_time_; }
+
+  explicit bench_state(std::chrono::milliseconds min_time) noexcept : min_time_{min_time} {}
+
+private:
+  std::chrono::milliseconds min_time_;
+};
+
+struct bench_case {
+  std::string                       name;
+  std::function<void(bench_state &)> fn;
+};
+
+inline std::vector<bench_case> &registry() noexcept {
+  static std::vector<bench_case> cases;
+
+  return cases;
+}
+
+struct bench_registrar {
+  bench_registrar(std::string name, std::function<void(bench_state &)> fn) noexcept {
+    registry().emplace_back(bench_case{std::move(name), std::move(fn)});
+  }
+};
+
+} // namespace esim_bench
+
+#define BENCH(name)                                                                  \
+  static void name(esim_bench::bench_state &);                                       \
+  static esim_bench::bench_registrar name##_registrar{#name, name};                  \
+  static void name(esim_bench::bench_state &state)
+
+#endif
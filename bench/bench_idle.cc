@@ -0,0 +1,179 @@
+#include "bench_helper.h"
+#include "core/executor.h"
+#include "core/triple_buffer.h"
+#include "core/unbounded_queue.h"
+#include "esim_controller_opaque.h"
+#include <atomic>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// the paused renderer parks this long unless the window events are waited.
+constexpr static std::chrono::milliseconds park_interval{4};
+/// the longest the renderer blocks while idle, woken up by the requests.
+constexpr static std::chrono::milliseconds idle_timeout{500};
+/// the controller handler parks this long without events.
+constexpr static std::chrono::milliseconds handler_interval{100};
+
+/// the controller pushed a key.
+esim::protocol::event key_press(esim::protocol::keycode_type key) noexcept {
+  esim::protocol::event ev;
+  ev.type = esim::protocol::EVENT_KEYPRESS;
+  ev.key = key;
+
+  return ev;
+}
+
+/// the process cpu time over the wall time while nothing requested,
+/// 100% per core kept busy. The loops run until the window passed.
+template <typename setup_type>
+void report_idle(esim_bench::bench_state &state, std::string_view label, setup_type &&setup) noexcept {
+  std::atomic<bool> working{true};
+  std::vector<std::thread> loops;
+  /// returns the wake up of the loops, invoked once stopped.
+  auto wake = setup(working, loops);
+
+  auto wall = std::chrono::steady_clock::now();
+  auto cpu = std::clock();
+  std::this_thread::sleep_for(state.min_time());
+  auto used = static_cast<double>(std::clock() - cpu) / CLOCKS_PER_SEC;
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall).count();
+
+  working.store(false, std::memory_order_release);
+  wake();
+  for (auto &loop : loops) {
+    loop.join();
+  }
+  std::printf("  %-40.*s %12.3f ms cpu %13.2f %% cpu\n", static_cast<int>(label.size()), label.data(),
+              used * 1e3, used * 100.0 / elapsed);
+}
+
+} // namespace
+
+BENCH(idle_render_loop) {
+  /// the requests polled without waiting, as the renderer drawing every frame.
+  esim::core::triple_buffer<int> spin;
+  report_idle(state, "spin on requests", [&](std::atomic<bool> &working, std::vector<std::thread> &loops) {
+    loops.emplace_back([&]() {
+      while (working.load(std::memory_order_acquire)) {
+        spin.acquire();
+      }
+    });
+
+    return []() {};
+  });
+
+  /// the paused renderer without the window events waited.
+  esim::core::triple_buffer<int> parked;
+  report_idle(state, "park on requests 4ms", [&](std::atomic<bool> &working, std::vector<std::thread> &loops) {
+    loops.emplace_back([&]() {
+      while (working.load(std::memory_order_acquire)) {
+        parked.acquire_for(park_interval);
+      }
+    });
+
+    return [&]() { parked.publish(0); };
+  });
+
+  /// the idle renderer blocked until woken up, as glfwWaitEventsTimeout.
+  esim::core::triple_buffer<int> blocked;
+  report_idle(state, "block until woken up", [&](std::atomic<bool> &working, std::vector<std::thread> &loops) {
+    loops.emplace_back([&]() {
+      while (working.load(std::memory_order_acquire)) {
+        blocked.acquire_for(idle_timeout);
+      }
+    });
+
+    return [&]() { blocked.publish(0); };
+  });
+}
+
+BENCH(idle_engine) {
+  /// everything running while the globe stays still: the renderer blocked,
+  /// the controller handler parked on its events and the workers parked.
+  esim::core::triple_buffer<int> requests;
+  esim::core::unbounded_queue<int> events;
+  esim::core::executor workers{std::max(2U, std::thread::hardware_concurrency())};
+  report_idle(state, "renderer, handler and workers", [&](std::atomic<bool> &working,
+                                                         std::vector<std::thread> &loops) {
+    loops.emplace_back([&]() {
+      while (working.load(std::memory_order_acquire)) {
+        requests.acquire_for(idle_timeout);
+      }
+    });
+    loops.emplace_back([&]() {
+      int event;
+      while (working.load(std::memory_order_acquire)) {
+        events.try_pop_for(event, handler_interval);
+      }
+    });
+
+    return [&]() {
+      requests.publish(0);
+      events.push(0);
+    };
+  });
+}
+
+BENCH(idle_wake_up) {
+  /// a request handed to the blocked renderer, then a frame answered back.
+  esim::core::triple_buffer<int> requests, frames;
+  std::atomic<bool> working{true};
+  std::thread renderer([&]() {
+    while (working.load(std::memory_order_acquire)) {
+      if (requests.acquire_for(idle_timeout)) {
+        frames.publish(requests.read_buffer());
+      }
+    }
+  });
+
+  int round = 0;
+  state.measure("request to frame", 1.0, [&]() {
+    requests.publish(++round);
+    while (!frames.acquire_for(idle_timeout)) {}
+  });
+
+  working.store(false, std::memory_order_release);
+  requests.publish(0);
+  renderer.join();
+}
+
+BENCH(idle_controller) {
+  /// the real event handler, the frames requested answered at once by a
+  /// renderer drawing nothing, the globe otherwise still.
+  auto report = [&](std::string_view label, std::vector<esim::protocol::event> events) {
+    esim::esim_controller::opaque controller;
+    esim::core::triple_buffer<esim::scene::frame_info> requests;
+    controller.requests()->subscribe([&](const esim::core::snapshot<esim::scene::frame_info> &info) {
+      requests.publish(*info);
+    });
+    report_idle(state, label, [&](std::atomic<bool> &working, std::vector<std::thread> &loops) {
+      loops.emplace_back([&]() {
+        while (working.load(std::memory_order_acquire)) {
+          if (requests.acquire_for(idle_timeout)) {
+            controller.receive_last_frame(requests.read_buffer());
+          }
+        }
+      });
+      controller.start();
+      for (auto &event : events) {
+        controller.push_event(event);
+      }
+
+      return [&]() {
+        controller.stop();
+        requests.publish(esim::scene::frame_info{});
+      };
+    });
+  };
+
+  report("handler without events", {});
+  report("handler playing", {key_press(esim::protocol::KEY_P)});
+  report("handler holding ctrl", {key_press(esim::protocol::KEY_CTRL)});
+  report("handler playing, holding ctrl", {key_press(esim::protocol::KEY_P),
+                                           key_press(esim::protocol::KEY_CTRL)});
+}
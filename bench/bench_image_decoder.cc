@@ -0,0 +1,97 @@
+#include "bench_helper.h"
+#include "core/bitmap.h"
+#include "core/buffer_pool.h"
+#include "core/compressed_bitmap.h"
+#include "core/image_decoder.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+std::string read_asset(const char *name) noexcept {
+  std::ifstream f(std::string(ESIM_BENCH_ASSETS) + "/" + name, std::ios::binary);
+  std::stringstream ss;
+  ss << f.rdbuf();
+
+  return ss.str();
+}
+
+void bench_decoder(esim_bench::bench_state &state,
+                   esim::rptr<const esim::core::image_decoder> decoder,
+                   const std::string &data) noexcept {
+  using namespace esim::core;
+  image_info info{};
+  if (!decoder->probe(data.data(), data.size(), info)) {
+    std::printf("  %s cannot decode the asset\n", decoder->name().data());
+    return;
+  }
+  const double pixels = static_cast<double>(info.width) * info.height;
+  const std::string name(decoder->name());
+
+  /// a fresh heap buffer and a copy per image, as the previous bitmap did.
+  state.measure(name + " copy", pixels, [&]() {
+    bitmap b;
+    decoder->decode(data.data(), data.size(), b, [](size_t size) {
+      return bitmap::allocate(size);
+    });
+  });
+
+  state.measure(name + " adopt", pixels, [&]() {
+    bitmap b;
+    decoder->decode(data.data(), data.size(), b, bitmap::allocator_type{});
+  });
+
+  buffer_pool pool(static_cast<size_t>(info.width) * info.height * 4, 16);
+  auto        alloc = pool.allocator();
+  state.measure(name + " pooled", pixels, [&]() {
+    bitmap b;
+    decoder->decode(data.data(), data.size(), b, alloc);
+  });
+
+  const size_t threads = std::max(2u, std::thread::hardware_concurrency());
+  const size_t per_thread = 8;
+  state.measure(name + " pooled x" + std::to_string(threads), pixels * threads * per_thread, [&]() {
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i) {
+      workers.emplace_back([&]() {
+        for (size_t n = 0; n < per_thread; ++n) {
+          bitmap b;
+          decoder->decode(data.data(), data.size(), b, alloc);
+        }
+      });
+    }
+    for (auto &w : workers) {
+      w.join();
+    }
+  });
+}
+
+} // namespace
+
+BENCH(image_decoder_tile) {
+  auto data = read_asset("img/test_base000.jpg");
+  bench_decoder(state, esim::core::stb_image_decoder::get(), data);
+#if defined(ESIM_ENABLE_LIBJPEG)
+  bench_decoder(state, esim::core::jpeg_image_decoder::get(), data);
+#endif
+}
+
+BENCH(image_decoder_starmap) {
+  auto data = read_asset("img/starmap_g4k.jpg");
+  bench_decoder(state, esim::core::select_image_decoder(data.data(), data.size()), data);
+}
+
+BENCH(bc1_transcode_tile) {
+  auto data = read_asset("img/test_base000.jpg");
+  esim::core::bitmap image;
+  if (!image.load(data.data(), data.size())) {
+    return;
+  }
+
+  esim::core::compressed_bitmap compressed;
+  state.measure("bc1 with mipmaps", static_cast<double>(image.width()) * image.height(), [&]() {
+    compressed.encode(image);
+  });
+  std::printf("  %zu bytes rgb, %zu bytes bc1 with mipmaps\n", image.size(), compressed.size());
+}
@@ -0,0 +1,71 @@
+#include "bench_helper.h"
+#include "core/bitmap.h"
+#include "core/image_ops.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> noise(size_t size) noexcept {
+  std::mt19937 rng{42};
+  std::vector<uint8_t> pixels(size);
+  for (auto &p : pixels) {
+    p = static_cast<uint8_t>(rng() & 0xFF);
+  }
+
+  return pixels;
+}
+
+void bench_image_ops(esim_bench::bench_state &state, int width, int height) noexcept {
+  using namespace esim::core;
+  const double pixels = static_cast<double>(width) * height;
+  const std::string size = std::to_string(width) + "x" + std::to_string(height);
+  auto rgb = noise(static_cast<size_t>(width) * height * 3);
+  std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+  std::vector<uint8_t> half(static_cast<size_t>(width / 2) * (height / 2) * 4);
+
+  state.measure("expand rgb to rgba " + size, pixels, [&]() {
+    image_ops::expand_rgb_to_rgba(rgb.data(), rgba.data(), static_cast<size_t>(width) * height);
+  });
+
+  state.measure("box " + size, pixels, [&]() {
+    image_ops::downsample_box(rgba.data(), width, height, 4, half.data());
+  });
+
+  state.measure("box srgb " + size, pixels, [&]() {
+    image_ops::downsample_box(rgba.data(), width, height, 4, half.data(), true);
+  });
+
+  state.measure("kaiser srgb " + size, pixels, [&]() {
+    image_ops::downsample_kaiser(rgba.data(), width, height, 4, half.data(), true);
+  });
+
+  state.measure("flip " + size, pixels, [&]() {
+    image_ops::flip_vertical(rgba.data(), width, height, 4);
+  });
+
+  bitmap image;
+  auto buffer = bitmap::allocate(rgb.size());
+  std::copy(rgb.begin(), rgb.end(), buffer.get());
+  image.adopt(width, height, 3, std::move(buffer));
+  mip_chain chain;
+  state.measure("mip chain box srgb " + size, pixels, [&]() {
+    image_ops::generate_mip_chain(image, chain, mip_filter::box, true);
+  });
+  state.measure("mip chain kaiser srgb " + size, pixels, [&]() {
+    image_ops::generate_mip_chain(image, chain, mip_filter::kaiser, true);
+  });
+}
+
+} // namespace
+
+BENCH(image_ops_tile) {
+  /// a basemap tile.
+  bench_image_ops(state, 256, 256);
+}
+
+BENCH(image_ops_starmap) {
+  /// the 4k starmap.
+  bench_image_ops(state, 4096, 2048);
+}
@@ -0,0 +1,20 @@
+#include "bench_helper.h"
+#include <cstdlib>
+#include <cstring>
+
+/// usage: esim_bench [filter] [min-time-ms]
+int main(int argc, char **argv) {
+  const char *filter = argc > 1 ? argv[1] : "";
+  std::chrono::milliseconds min_time{argc > 2 ? std::atoi(argv[2]) : 500};
+
+  esim_bench::bench_state state(min_time);
+  for (auto &c : esim_bench::registry()) {
+    if (nullptr == std::strstr(c.name.c_str(), filter)) {
+      continue;
+    }
+    std::printf("[%s]\n", c.name.c_str());
+    c.fn(state);
+  }
+
+  return 0;
+}
@@ -5,10 +5,9 @@ layout (location = 0) out vec4 FragColor;
 layout (location = 1) out vec4 FragOccluders;
 layout (location = 2) out vec4 FragWorldPos;
 
-uniform bool      u_UseBaseMap;
-uniform vec2      u_TexOffset;
-uniform float     u_TexScale;
-uniform sampler2D u_BaseMap;
+// offset in xy, scale in z and layer in w, no basemap if the layer is negative.
+uniform vec4           u_TexTransform;
+uniform sampler2DArray u_BaseMap;
 
 in vec3 v_Normal;
 in vec2 v_TexCoord;
@@ -24,10 +23,10 @@ void main() {
 
   CalcLightScale(light_scale, normalize(-v_FragPos), v_Normal, 32.0);
 
-  texcoord = u_TexOffset + (v_TexCoord * u_TexScale);
+  texcoord = u_TexTransform.xy + (v_TexCoord * u_TexTransform.z);
 
-  if (u_UseBaseMap) {
-    base_color = texture2D(u_BaseMap, texcoord).rgb;
+  if (u_TexTransform.w >= 0.0) {
+    base_color = texture(u_BaseMap, vec3(texcoord, u_TexTransform.w)).rgb;
   } else {
     base_color = vec3(texcoord, 1.0);
   }
@@ -38,4 +37,4 @@ void main() {
   FragColor = vec4(base_color, 1.0);
   FragOccluders = vec4(0.0, 1.0, 0.0, 1.0);
   FragWorldPos = vec4(v_FragPos, 1.0);
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#version 460
+precision highp float;
+
+layout (location = 0) out uvec4 FragPage;
+
+// lod, x and y of the tile drawn.
+uniform uvec3 u_Tile;
+uniform uint  u_MaxLod;
+// log2 of the downscale of feedback.
+uniform float u_LodBias;
+
+in vec2 v_TexCoord;
+
+void main() {
+  // texels of the tile basemap covered by a pixel of the full viewport.
+  vec2  texels = v_TexCoord * 256.0;
+  vec2  dx = dFdx(texels);
+  vec2  dy = dFdy(texels);
+  float mip = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-8)) - u_LodBias;
+
+  // every minified level halves the page needed, never finer than the tile.
+  uint coarser = uint(clamp(floor(mip), 0.0, float(u_Tile.x)));
+  uint lod = min(u_Tile.x - coarser, u_MaxLod);
+  uint shift = u_Tile.x - lod;
+
+  // zero is left by the clear where nothing is sampled.
+  FragPage = uvec4(lod + 1u, u_Tile.y >> shift, u_Tile.z >> shift, 0u);
+}
@@ -2,6 +2,7 @@
 #define __ESIM_CORE_BITMAP_H_
 
 #include "core/utils.h"
+#include <functional>
 #include <string_view>
 
 namespace esim {
@@ -10,16 +11,68 @@ namespace core {
 
 class bitmap {
 public:
+  /**
+   * @brief The pixels buffer owned by bitmap, released by its deleter.
+   *
+   */
+  typedef std::unique_ptr<char[], std::function<void(char *)>> buffer_type;
+
+  /**
+   * @brief The allocator providing the pixels buffer of requested bytes,
+   * e.g. a pooled buffer or a mapped upload buffer.
+   *
+   */
+  typedef std::function<buffer_type(size_t)> allocator_type;
+
   int width() const noexcept;
 
   int height() const noexcept;
 
+  int channel() const noexcept;
+
+  size_t size() const noexcept;
+
   const char *buffer() const noexcept;
 
   bool load_from_file(std::string_view file) noexcept;
 
   bool load(const char *buffer, size_t size) noexcept;
 
+  /**
+   * @brief Decode the image straight into the buffer provided by allocator.
+   *
+   * @param buffer specifies the encoded image.
+   * @param size specifies the size of encoded image.
+   * @param alloc specifies the allocator of pixels buffer.
+   * @return true if decoded successfully, false otherwise.
+   */
+  bool load(const char *buffer, size_t size, const allocator_type &alloc) noexcept;
+
+  /**
+   * @brief Take the ownership of decoded pixels without copying.
+   *
+   * @param width specifies the width of pixels.
+   * @param height specifies the height of pixels.
+   * @param channel specifies the channel of pixels.
+   * @param buffer specifies the pixels buffer.
+   */
+  void adopt(int width, int height, int channel, buffer_type buffer) noexcept;
+
+  /**
+   * @brief Release the ownership of pixels buffer.
+   *
+   * @return the pixels buffer.
+   */
+  buffer_type release() noexcept;
+
+  /**
+   * @brief Allocate a pixels buffer from heap.
+   *
+   * @param size specifies the bytes of buffer.
+   * @return the pixels buffer.
+   */
+  static buffer_type allocate(size_t size) noexcept;
+
   bitmap() noexcept;
 
   ~bitmap() noexcept;
@@ -33,4 +86,4 @@ private:
 
 } // namespace esim
 
-#endif
\ No newline at end of file
+#endif
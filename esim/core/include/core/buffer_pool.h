@@ -0,0 +1,81 @@
+#ifndef __ESIM_CORE_BUFFER_POOL_H_
+#define __ESIM_CORE_BUFFER_POOL_H_
+
+#include "core/bitmap.h"
+#include "core/utils.h"
+#include <mutex>
+#include <vector>
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief Thread-safety pool recycling fixed-size pixels buffers.
+ *
+ * @note buffers may outlive the pool, they are freed when returned then.
+ */
+class buffer_pool {
+public:
+  /**
+   * @brief Acquire a buffer from the pool.
+   *
+   * @param size specifies the bytes requested, the buffer is allocated
+   * from heap without recycling if exceeds the block size.
+   * @return the buffer returning to the pool when released.
+   */
+  bitmap::buffer_type acquire(size_t size) noexcept;
+
+  /**
+   * @brief Obtain an allocator which acquires from the pool.
+   *
+   * @return the allocator for decoding bitmap.
+   */
+  bitmap::allocator_type allocator() noexcept;
+
+  /**
+   * @brief Obtain the bytes of each block.
+   *
+   * @return the block size.
+   */
+  size_t block_size() const noexcept;
+
+  /**
+   * @brief Obtain the count of idle blocks in the pool.
+   *
+   * @return the count of idle blocks.
+   */
+  size_t available() const noexcept;
+
+  /**
+   * @brief Construct a new buffer pool object.
+   *
+   * @param block_size specifies the bytes of each block.
+   * @param capacity specifies the maximum count of idle blocks kept.
+   */
+  buffer_pool(size_t block_size, size_t capacity) noexcept;
+
+  ~buffer_pool() noexcept;
+
+private:
+  struct blocks {
+    const size_t       block_size;
+    const size_t       capacity;
+    std::mutex         mutex;
+    std::vector<char*> idle;
+
+    void recycle(char *p) noexcept;
+
+    blocks(size_t block_size, size_t capacity) noexcept;
+
+    ~blocks() noexcept;
+  };
+
+  sptr<blocks> blocks_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#endif
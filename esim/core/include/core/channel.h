@@ -0,0 +1,206 @@
+#ifndef __ESIM_CORE_CORE_CHANNEL_H_
+#define __ESIM_CORE_CORE_CHANNEL_H_
+
+#include "executor.h"
+#include "object_pool.h"
+#include "utils.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace esim {
+
+namespace core {
+
+template <typename type>
+class channel;
+
+namespace details {
+
+template <typename type>
+struct snapshot_node {
+  std::atomic<uint32_t>                refs;
+  rptr<object_pool<snapshot_node>>     pool;
+  const type                           value;
+
+  template <typename... types>
+  explicit snapshot_node(rptr<object_pool<snapshot_node>> owner, types &&...args) noexcept;
+};
+
+} // namespace details
+
+/**
+ * @brief Immutable message shared by reference counting, copying a snapshot
+ * never copies the value, the last one released returns it into the pool.
+ *
+ * @tparam type specifies the type of value.
+ * @note the snapshots must be released before the channel made them.
+ */
+template <typename type>
+class snapshot {
+public:
+  const type &operator*() const noexcept;
+
+  rptr<const type> operator->() const noexcept;
+
+  rptr<const type> get() const noexcept;
+
+  explicit operator bool() const noexcept;
+
+  /**
+   * @brief Obtain the count of snapshots sharing the value.
+   *
+   * @return the count of references, 0 if empty.
+   */
+  size_t use_count() const noexcept;
+
+  snapshot() noexcept;
+
+  snapshot(const snapshot &other) noexcept;
+
+  snapshot(snapshot &&other) noexcept;
+
+  snapshot &operator=(const snapshot &other) noexcept;
+
+  snapshot &operator=(snapshot &&other) noexcept;
+
+  ~snapshot() noexcept;
+
+private:
+  friend class channel<type>;
+
+  explicit snapshot(rptr<details::snapshot_node<type>> node) noexcept;
+
+  void release() noexcept;
+
+private:
+  rptr<details::snapshot_node<type>> node_;
+};
+
+/**
+ * @brief How a subscriber receives the messages.
+ *
+ */
+enum class delivery : uint8_t {
+  /// invoked by the publishing thread, in order.
+  sync,
+  /// submitted to the executor of channel, never blocks the publisher.
+  async,
+};
+
+/**
+ * @brief Typed publish-subscribe channel, the messages are immutable
+ * snapshots made from the pool of channel.
+ *
+ * Publishing to many subscribers costs the one snapshot made, each of them
+ * receives a reference to the same value, the asynchronous ones share it
+ * by reference counting until delivered.
+ *
+ *   publisher:  publish(make(args...)), or emplace(args...).
+ *   subscriber: subscribe([](const snapshot<type> &msg) { ... }).
+ *
+ * @tparam type specifies the type of messages.
+ * @note thread-safety, the subscriptions are copied on write and swapped
+ * atomically, publishing never waits for subscribing.
+ */
+template <typename type>
+class channel {
+public:
+  typedef std::function<void(const snapshot<type> &)> handler_type;
+
+  /**
+   * @brief Make a message from the pool.
+   *
+   * @param args specifies the arguments of constructor.
+   * @return the snapshot of message.
+   */
+  template <typename... types>
+  snapshot<type> make(types &&...args) noexcept;
+
+  /**
+   * @brief Deliver the message to all subscribers.
+   *
+   * @param message specifies the snapshot, shared by the subscribers.
+   */
+  void publish(const snapshot<type> &message) noexcept;
+
+  /**
+   * @brief Make a message from the pool then publish it.
+   *
+   * @param args specifies the arguments of constructor.
+   */
+  template <typename... types>
+  void emplace(types &&...args) noexcept;
+
+  /**
+   * @brief Subscribe the channel.
+   *
+   * @param handler specifies the handler of messages.
+   * @param mode specifies how the messages delivered.
+   * @return the id of subscription.
+   */
+  size_t subscribe(handler_type handler, delivery mode = delivery::sync) noexcept;
+
+  /**
+   * @brief Unsubscribe the channel, the asynchronous deliveries in flight
+   * are still invoked.
+   *
+   * @param id specifies the id of subscription.
+   */
+  void unsubscribe(size_t id) noexcept;
+
+  /**
+   * @brief Obtain the count of subscribers.
+   *
+   * @return the count of subscribers.
+   */
+  size_t subscribers() const noexcept;
+
+  /**
+   * @brief Construct a new channel object
+   *
+   * @param target specifies the executor of asynchronous deliveries.
+   * @param slab_size specifies the count of snapshots in each slab of pool.
+   */
+  explicit channel(rptr<executor> target = executor::get(), uint32_t slab_size = 16) noexcept;
+
+  /**
+   * @brief Wait for the asynchronous deliveries, then destroy the channel.
+   *
+   */
+  ~channel() noexcept;
+
+  channel(const channel &) = delete;
+
+  channel &operator=(const channel &) = delete;
+
+private:
+  struct subscriber {
+    size_t       id;
+    handler_type handler;
+    delivery     mode;
+  };
+
+  typedef std::vector<subscriber> subscribers_type;
+
+private:
+  object_pool<details::snapshot_node<type>> pool_;
+  /// serializes the writers of subscriptions, never taken by publishing.
+  std::mutex                                mutex_;
+  /// replaced atomically on subscribing, the deliveries hold the one they started with.
+  sptr<const subscribers_type>              subscribers_;
+  size_t                                    next_id_;
+  /// joined before the pool destroyed.
+  task_group                                deliveries_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#include "channel.inl"
+
+#endif
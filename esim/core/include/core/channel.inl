@@ -0,0 +1,181 @@
+#include <algorithm>
+
+namespace esim {
+
+namespace core {
+
+namespace details {
+
+template <typename type>
+template <typename... types>
+inline snapshot_node<type>::snapshot_node(rptr<object_pool<snapshot_node>> owner, types &&...args) noexcept
+    : refs{1}, pool{owner}, value(std::forward<types>(args)...) {}
+
+} // namespace details
+
+template <typename type>
+inline const type &snapshot<type>::operator*() const noexcept {
+  assert(nullptr != node_);
+
+  return node_->value;
+}
+
+template <typename type>
+inline rptr<const type> snapshot<type>::operator->() const noexcept {
+
+  return get();
+}
+
+template <typename type>
+inline rptr<const type> snapshot<type>::get() const noexcept {
+
+  return nullptr != node_ ? &node_->value : nullptr;
+}
+
+template <typename type>
+inline snapshot<type>::operator bool() const noexcept {
+
+  return nullptr != node_;
+}
+
+template <typename type>
+inline size_t snapshot<type>::use_count() const noexcept {
+
+  return nullptr != node_ ? node_->refs.load(std::memory_order_relaxed) : 0;
+}
+
+template <typename type>
+inline snapshot<type>::snapshot() noexcept
+    : node_{nullptr} {}
+
+template <typename type>
+inline snapshot<type>::snapshot(const snapshot &other) noexcept
+    : node_{other.node_} {
+  if (nullptr != node_) {
+    node_->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+template <typename type>
+inline snapshot<type>::snapshot(snapshot &&other) noexcept
+    : node_{other.node_} {
+  other.node_ = nullptr;
+}
+
+template <typename type>
+inline snapshot<type> &snapshot<type>::operator=(const snapshot &other) noexcept {
+  if (node_ != other.node_) {
+    release();
+    node_ = other.node_;
+    if (nullptr != node_) {
+      node_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  return *this;
+}
+
+template <typename type>
+inline snapshot<type> &snapshot<type>::operator=(snapshot &&other) noexcept {
+  if (this != &other) {
+    release();
+    node_ = other.node_;
+    other.node_ = nullptr;
+  }
+
+  return *this;
+}
+
+template <typename type>
+inline snapshot<type>::~snapshot() noexcept {
+  release();
+}
+
+template <typename type>
+inline snapshot<type>::snapshot(rptr<details::snapshot_node<type>> node) noexcept
+    : node_{node} {}
+
+template <typename type>
+inline void snapshot<type>::release() noexcept {
+  /// the readers of all other references happen before destroyed.
+  if (nullptr != node_ && 1 == node_->refs.fetch_sub(1, std::memory_order_acq_rel)) {
+    node_->pool->destroy(node_);
+  }
+  node_ = nullptr;
+}
+
+template <typename type>
+template <typename... types>
+inline snapshot<type> channel<type>::make(types &&...args) noexcept {
+
+  return snapshot<type>{pool_.create(&pool_, std::forward<types>(args)...)};
+}
+
+template <typename type>
+inline void channel<type>::publish(const snapshot<type> &message) noexcept {
+  /// never locked, the subscriptions replaced meanwhile are delivered next time.
+  auto targets = std::atomic_load_explicit(&subscribers_, std::memory_order_acquire);
+
+  for (auto &target : *targets) {
+    if (delivery::sync == target.mode) {
+      target.handler(message);
+      continue;
+    }
+
+    /// the subscriptions held alive by the task, the handler never copied,
+    /// the message captured mutable is released before the delivery finished.
+    deliveries_.submit([targets, &target, message = message]() { target.handler(message); });
+  }
+}
+
+template <typename type>
+template <typename... types>
+inline void channel<type>::emplace(types &&...args) noexcept {
+  publish(make(std::forward<types>(args)...));
+}
+
+template <typename type>
+inline size_t channel<type>::subscribe(handler_type handler, delivery mode) noexcept {
+  assert(nullptr != handler);
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto replaced = make_sptr<subscribers_type>(*subscribers_);
+  auto id = next_id_++;
+  replaced->emplace_back(subscriber{id, std::move(handler), mode});
+  std::atomic_store_explicit(&subscribers_, sptr<const subscribers_type>{std::move(replaced)},
+                             std::memory_order_release);
+
+  return id;
+}
+
+template <typename type>
+inline void channel<type>::unsubscribe(size_t id) noexcept {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto replaced = make_sptr<subscribers_type>(*subscribers_);
+  replaced->erase(std::remove_if(replaced->begin(), replaced->end(),
+                                 [id](const subscriber &target) { return target.id == id; }),
+                  replaced->end());
+  std::atomic_store_explicit(&subscribers_, sptr<const subscribers_type>{std::move(replaced)},
+                             std::memory_order_release);
+}
+
+template <typename type>
+inline size_t channel<type>::subscribers() const noexcept {
+
+  return std::atomic_load_explicit(&subscribers_, std::memory_order_acquire)->size();
+}
+
+template <typename type>
+inline channel<type>::channel(rptr<executor> target, uint32_t slab_size) noexcept
+    : pool_{slab_size},
+      subscribers_{make_sptr<subscribers_type>()},
+      next_id_{0},
+      deliveries_{target} {}
+
+template <typename type>
+inline channel<type>::~channel() noexcept {
+  deliveries_.wait();
+}
+
+} // namespace core
+
+} // namespace esim
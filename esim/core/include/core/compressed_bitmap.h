@@ -0,0 +1,100 @@
+#ifndef __ESIM_CORE_COMPRESSED_BITMAP_H_
+#define __ESIM_CORE_COMPRESSED_BITMAP_H_
+
+#include "core/bitmap.h"
+#include "core/utils.h"
+#include <string>
+#include <vector>
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief Block compressed pixels with the full mip chain, ready for
+ * glCompressedTexImage2D. Stored as DDS when persisted.
+ *
+ * @note only BC1 (DXT1, 4 bits per pixel, opaque) is supported.
+ */
+class compressed_bitmap {
+public:
+  /**
+   * @brief A mip level within the compressed data.
+   *
+   */
+  struct level {
+    int    width, height;
+    size_t offset, size;
+  };
+
+  int width() const noexcept;
+
+  int height() const noexcept;
+
+  const std::vector<level> &levels() const noexcept;
+
+  const char *buffer() const noexcept;
+
+  /**
+   * @brief Obtain the bytes of all levels.
+   *
+   * @return the size of compressed data.
+   */
+  size_t size() const noexcept;
+
+  /**
+   * @brief Build the mip chain of the bitmap and compress each level.
+   *
+   * @param image specifies the bitmap of 1 to 4 channels, alpha is dropped.
+   * @return true if compressed successfully, false otherwise.
+   */
+  bool encode(const bitmap &image) noexcept;
+
+  /**
+   * @brief Decode the top level into rgb pixels.
+   *
+   * @param image specifies the bitmap where the rgb pixels stored in.
+   * @return true if decoded successfully, false otherwise.
+   */
+  bool decode(bitmap &image) const noexcept;
+
+  /**
+   * @brief Load from the DDS data.
+   *
+   * @param buffer specifies the DDS data.
+   * @param size specifies the size of DDS data.
+   * @return true if loaded successfully, false otherwise.
+   */
+  bool load(const char *buffer, size_t size) noexcept;
+
+  /**
+   * @brief Save as DDS data.
+   *
+   * @param out specifies the DDS data.
+   * @return true if saved successfully, false if empty.
+   */
+  bool save(std::string &out) const noexcept;
+
+  /**
+   * @brief Check if the data is DDS which can be loaded.
+   *
+   * @param buffer specifies the data.
+   * @param size specifies the size of data.
+   * @return true if loadable, false otherwise.
+   */
+  static bool probe(const char *buffer, size_t size) noexcept;
+
+  compressed_bitmap() noexcept;
+
+  ~compressed_bitmap() noexcept;
+
+private:
+  class opaque;
+  uptr<opaque> opaque_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef __ESIM_CORE_CORE_EPOCH_H_
+#define __ESIM_CORE_CORE_EPOCH_H_
+
+#include "utils.h"
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace esim {
+
+namespace core {
+
+class epoch_domain;
+
+/**
+ * @brief A reader of the objects shared through an epoch domain, a thread or
+ * the serialized tasks of a pipeline stage.
+ *
+ * Entered before reading the shared objects and left once none is held any
+ * more; a participant left never blocks the reclamation.
+ *
+ * @note not thread-safety, used by a single thread at a time.
+ */
+class epoch_participant {
+public:
+  /**
+   * @brief Pin the current epoch, the objects reachable from now on are
+   * never reclaimed until left.
+   *
+   */
+  void enter() noexcept;
+
+  /**
+   * @brief Unpin the epoch, no object reached while entered is used any more.
+   *
+   */
+  void leave() noexcept;
+
+  bool entered() const noexcept;
+
+  explicit epoch_participant(epoch_domain &domain) noexcept;
+
+  ~epoch_participant() noexcept;
+
+  epoch_participant(const epoch_participant &) = delete;
+
+  epoch_participant &operator=(const epoch_participant &) = delete;
+
+private:
+  friend class epoch_domain;
+
+  rptr<epoch_domain>                   domain_;
+  /// the epoch pinned shifted left by one, the lowest bit set once entered.
+  alignas(128UL) std::atomic<uint64_t> state_;
+};
+
+/**
+ * @brief Enters the participant in the scope.
+ *
+ */
+class epoch_guard {
+public:
+  explicit epoch_guard(epoch_participant &participant) noexcept;
+
+  ~epoch_guard() noexcept;
+
+  epoch_guard(const epoch_guard &) = delete;
+
+  epoch_guard &operator=(const epoch_guard &) = delete;
+
+private:
+  epoch_participant &participant_;
+};
+
+/**
+ * @brief Epoch based reclamation, the objects unlinked by the writers are
+ * retired, then reclaimed once every participant entered has passed two
+ * epochs, i.e. none of them may still hold the objects.
+ *
+ *   writer: unlink the object, then retire it.
+ *   reader: enter, read the objects reachable, then leave.
+ *   owner:  advance at the quiescent point, e.g. the frame boundary.
+ *
+ * The epoch advances only if all participants entered have pinned the
+ * current one, the objects retired in the epoch before the previous are
+ * reclaimed by the thread advancing, outside the lock.
+ *
+ * @note entering and leaving are wait-free, retiring and advancing lock.
+ */
+class epoch_domain {
+public:
+  /**
+   * @brief Retire the object unlinked, deleted once unreachable.
+   *
+   * @tparam type specifies the type of object.
+   * @param target specifies the object, owned by the domain since.
+   */
+  template <typename type>
+  void retire(rptr<type> target) noexcept;
+
+  /**
+   * @brief Retire by the reclamation, invoked once unreachable, may retire
+   * again if not reclaimable yet.
+   *
+   * @param reclaim specifies the reclamation.
+   */
+  void retire(std::function<void()> reclaim) noexcept;
+
+  /**
+   * @brief Try to advance the epoch, then reclaim the objects retired
+   * two epochs before.
+   *
+   * @return true if advanced, false if a participant entered is behind.
+   */
+  bool advance() noexcept;
+
+  uint64_t current() const noexcept;
+
+  /**
+   * @brief Obtain the count of retirements not reclaimed yet.
+   *
+   * @return the count of retirements.
+   */
+  size_t retired() const noexcept;
+
+  epoch_domain() noexcept;
+
+  /**
+   * @brief Reclaim all retired in order, the participants must be
+   * destroyed before.
+   *
+   */
+  ~epoch_domain() noexcept;
+
+  epoch_domain(const epoch_domain &) = delete;
+
+  epoch_domain &operator=(const epoch_domain &) = delete;
+
+private:
+  friend class epoch_participant;
+
+  void attach(rptr<epoch_participant> participant) noexcept;
+
+  void detach(rptr<epoch_participant> participant) noexcept;
+
+private:
+  alignas(128UL) std::atomic<uint64_t>                 epoch_;
+  /// guards the participants and the retired, never the readers.
+  mutable std::mutex                                   mutex_;
+  std::vector<rptr<epoch_participant>>                 participants_;
+  /// indexed by the epoch retired in, modulo three.
+  std::array<std::vector<std::function<void()>>, 3>    retired_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#include "epoch.inl"
+
+#endif
@@ -0,0 +1,46 @@
+namespace esim {
+
+namespace core {
+
+namespace details {
+
+constexpr static uint64_t epoch_entered = 1;
+
+} // namespace details
+
+inline void epoch_participant::enter() noexcept {
+  assert(!entered());
+  auto epoch = domain_->epoch_.load(std::memory_order_acquire);
+  state_.store((epoch << 1) | details::epoch_entered, std::memory_order_seq_cst);
+  /// pairs with the fence of advance, either the pin is seen or the
+  /// objects retired are already unreachable.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+inline void epoch_participant::leave() noexcept {
+  assert(entered());
+  state_.store(0, std::memory_order_release);
+}
+
+inline bool epoch_participant::entered() const noexcept {
+
+  return 0 != (state_.load(std::memory_order_relaxed) & details::epoch_entered);
+}
+
+inline epoch_guard::epoch_guard(epoch_participant &participant) noexcept
+    : participant_{participant} {
+  participant_.enter();
+}
+
+inline epoch_guard::~epoch_guard() noexcept {
+  participant_.leave();
+}
+
+template <typename type>
+inline void epoch_domain::retire(rptr<type> target) noexcept {
+  retire([target]() { delete target; });
+}
+
+} // namespace core
+
+} // namespace esim
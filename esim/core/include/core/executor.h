@@ -0,0 +1,238 @@
+#ifndef __ESIM_CORE_CORE_EXECUTOR_H_
+#define __ESIM_CORE_CORE_EXECUTOR_H_
+
+#include "parker.h"
+#include "unbounded_queue.h"
+#include "utils.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief Priority of tasks, the higher ones are taken first by every worker.
+ *
+ */
+enum class task_priority : uint8_t {
+  high,
+  normal,
+  low,
+};
+
+namespace details {
+
+/**
+ * @brief Work stealing deque of fixed capacity (Chase-Lev), the owner pushes
+ * and pops at the bottom while the thieves steal from the top.
+ *
+ * @tparam type specifies the target type of content, trivially copyable.
+ * @note single owner thread, multiple thieves.
+ */
+template <typename type>
+class work_deque {
+public:
+  /**
+   * @brief Push the item at the bottom, called by the owner only.
+   *
+   * @param value specifies the target item.
+   * @return true if operates successful, false if full.
+   */
+  bool push(type value) noexcept;
+
+  /**
+   * @brief Pop the latest item from the bottom, called by the owner only.
+   *
+   * @param ref specifies the reference to receive.
+   * @return true if operates successful, false if empty.
+   */
+  bool pop(type &ref) noexcept;
+
+  /**
+   * @brief Steal the earliest item from the top, called by any thread.
+   *
+   * @param ref specifies the reference to receive.
+   * @return true if operates successful, false if empty or lost the race.
+   */
+  bool steal(type &ref) noexcept;
+
+  explicit work_deque(uint32_t size) noexcept;
+
+  work_deque(const work_deque &) = delete;
+
+  work_deque &operator=(const work_deque &) = delete;
+
+private:
+  const int64_t                       size_;
+  const int64_t                       mask_;
+  /// thieves advance the top, the owner moves the bottom.
+  alignas(128UL) std::atomic<int64_t> top_;
+  alignas(128UL) std::atomic<int64_t> bottom_;
+  uptr<std::atomic<type>[]>           items_;
+};
+
+} // namespace details
+
+/**
+ * @brief Fixed count of worker threads running the tasks submitted.
+ *
+ * Each worker owns a work stealing deque per priority, the tasks submitted by
+ * a worker are pushed into its own deques, and those from other threads into
+ * the shared queues. An idle worker takes the highest priority first, from
+ * its deques, the shared queues, then steals from others, and parks once
+ * nothing left; no worker spins waiting for tasks.
+ *
+ * A long running task occupies a worker until it returns, the blocking I/O
+ * in tasks is covered by the count of threads rather than the cores.
+ */
+class executor {
+public:
+  /**
+   * @brief Submit the task, never blocks.
+   *
+   * @tparam func_type specifies the callable, invoked without arguments.
+   * @param fn specifies the task.
+   * @param priority specifies the priority of task.
+   * @note the tasks submitted once shutdown run in place.
+   */
+  template <typename func_type>
+  void submit(func_type &&fn, task_priority priority = task_priority::normal) noexcept;
+
+  /**
+   * @brief Obtain the count of worker threads.
+   *
+   * @return the count of threads.
+   */
+  size_t concurrency() const noexcept;
+
+  /**
+   * @brief Run the tasks left, then join the workers.
+   *
+   */
+  void shutdown() noexcept;
+
+  /**
+   * @brief Configure the count of threads of the shared executor, must be
+   * called before the first get.
+   *
+   * @param threads specifies the count of threads, 0 for the default.
+   */
+  static void configure(size_t threads) noexcept;
+
+  /**
+   * @brief Obtain the executor shared by the process.
+   *
+   * @return the shared executor.
+   */
+  static rptr<executor> get() noexcept;
+
+  /**
+   * @brief Construct a new executor object
+   *
+   * @param threads specifies the count of worker threads.
+   */
+  explicit executor(size_t threads) noexcept;
+
+  ~executor() noexcept;
+
+  executor(const executor &) = delete;
+
+  executor &operator=(const executor &) = delete;
+
+private:
+  struct task {
+    std::function<void()> run;
+  };
+
+  struct worker {
+    std::array<uptr<details::work_deque<rptr<task>>>, 3> deques;
+    std::thread                                         thread;
+  };
+
+  void schedule(rptr<task> target, task_priority priority) noexcept;
+
+  /// takes a task by priority, local first, then shared, then stolen.
+  bool next(size_t index, rptr<task> &target) noexcept;
+
+  void run(size_t index) noexcept;
+
+private:
+  std::vector<uptr<worker>>                  workers_;
+  /// submitted by other threads, or overflowed from the deques.
+  std::array<unbounded_queue<rptr<task>>, 3> shared_;
+  /// tasks queued not taken yet, the workers park once none.
+  alignas(128UL) std::atomic<size_t>         pending_;
+  std::atomic<bool>                          stopping_;
+  parker                                     available_;
+};
+
+/**
+ * @brief Tasks submitted to an executor and joined together, the owner waits
+ * for them before destroying the states they access.
+ *
+ * @note never waits from a task of the same executor, the workers may be
+ * all occupied by the waiters.
+ */
+class task_group {
+public:
+  /**
+   * @brief Submit the task into the executor, counted until it returns.
+   *
+   * @tparam func_type specifies the callable, invoked without arguments.
+   * @param fn specifies the task.
+   * @param priority specifies the priority of task.
+   */
+  template <typename func_type>
+  void submit(func_type &&fn, task_priority priority = task_priority::normal) noexcept;
+
+  /**
+   * @brief Obtain the count of tasks not returned yet.
+   *
+   * @return the count of tasks.
+   */
+  size_t pending() const noexcept;
+
+  /**
+   * @brief Wait until all tasks submitted returned.
+   *
+   */
+  void wait() noexcept;
+
+  /**
+   * @brief Construct a new task group object
+   *
+   * @param target specifies the executor, the shared one by default.
+   */
+  explicit task_group(rptr<executor> target = executor::get()) noexcept;
+
+  ~task_group() noexcept;
+
+  task_group(const task_group &) = delete;
+
+  task_group &operator=(const task_group &) = delete;
+
+private:
+  void finish() noexcept;
+
+private:
+  rptr<executor>          executor_;
+  /// decreased under the mutex, the waiter is notified before it returns.
+  std::atomic<size_t>     pending_;
+  std::mutex              mutex_;
+  std::condition_variable done_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#include "executor.inl"
+
+#endif
@@ -0,0 +1,107 @@
+namespace esim {
+
+namespace core {
+
+namespace details {
+
+template <typename type>
+inline bool work_deque<type>::push(type value) noexcept {
+  auto bottom = bottom_.load(std::memory_order_relaxed);
+  auto top = top_.load(std::memory_order_acquire);
+  if (bottom - top >= size_) {
+
+    return false;
+  }
+
+  items_[bottom & mask_].store(value, std::memory_order_relaxed);
+  /// the item is visible before the bottom passes it.
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+
+  return true;
+}
+
+template <typename type>
+inline bool work_deque<type>::pop(type &ref) noexcept {
+  auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  bottom_.store(bottom, std::memory_order_relaxed);
+  /// the bottom reserved is seen by the thieves before the top read.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto top = top_.load(std::memory_order_relaxed);
+  if (top > bottom) {
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+
+    return false;
+  }
+
+  ref = items_[bottom & mask_].load(std::memory_order_relaxed);
+  if (top < bottom) {
+
+    return true;
+  }
+
+  /// the last item, raced with the thieves on the top.
+  bool taken = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+
+  return taken;
+}
+
+template <typename type>
+inline bool work_deque<type>::steal(type &ref) noexcept {
+  auto top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) {
+
+    return false;
+  }
+
+  auto value = items_[top & mask_].load(std::memory_order_relaxed);
+  if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                    std::memory_order_relaxed)) {
+
+    return false;
+  }
+  ref = value;
+
+  return true;
+}
+
+template <typename type>
+inline work_deque<type>::work_deque(uint32_t size) noexcept
+    : size_{ceil2_32(size)},
+      mask_{size_ - 1},
+      top_{0}, bottom_{0},
+      items_{make_uptr<std::atomic<type>[]>(static_cast<size_t>(size_))} {}
+
+} // namespace details
+
+template <typename func_type>
+inline void executor::submit(func_type &&fn, task_priority priority) noexcept {
+  if (stopping_.load(std::memory_order_acquire)) {
+    fn();
+
+    return;
+  }
+
+  schedule(new task{std::forward<func_type>(fn)}, priority);
+}
+
+template <typename func_type>
+inline void task_group::submit(func_type &&fn, task_priority priority) noexcept {
+  pending_.fetch_add(1, std::memory_order_relaxed);
+  executor_->submit([this, fn = std::forward<func_type>(fn)]() mutable {
+    {
+      /// the captures released before finished, never outlive the waiter.
+      auto run = std::move(fn);
+      run();
+    }
+    finish();
+  }, priority);
+}
+
+} // namespace core
+
+} // namespace esim
@@ -1,10 +1,12 @@
 #ifndef __ESIM_CORE_CORE_FIFO_H_
 #define __ESIM_CORE_CORE_FIFO_H_
 
+#include "parker.h"
 #include "utils.h"
 #include <atomic>
 #include <cassert>
-#include <thread>
+#include <chrono>
+#include <new>
 #include <vector>
 
 namespace esim {
@@ -37,13 +39,28 @@ private:
 
 } // namespace details
 
+/**
+ * @brief Policy of fifo, multiple producer multiple consumer.
+ *
+ */
+struct mpmc final {};
+
+/**
+ * @brief Policy of fifo, single producer single consumer.
+ *
+ */
+struct spsc final {};
+
 /**
  * @brief Thread-safety circular First-In-First-Out queue
  * 
+ * The blocking operations spin briefly, then park until the slot handed over.
+ *
  * @tparam type specifies the target type of content.
+ * @tparam policy specifies the count of producers and consumers, mpmc or spsc.
  * @note multiple producer multiple consumer supported.
  */
-template <typename type>
+template <typename type, typename policy = mpmc>
 class fifo {
 public:
   /**
@@ -65,6 +82,17 @@ public:
   template <typename l_type>
   bool try_pop(l_type &ref) noexcept;
 
+  /**
+   * @brief Try to pop the first item from the queue, park until pushed or timeout
+   * 
+   * @tparam l_type specifies the return type, must be convertible from 'type'.
+   * @param ref specifies the reference to receive.
+   * @param timeout specifies the max duration to wait.
+   * @return true if operates successful, false if timeout.
+   */
+  template <typename l_type, typename rep_type, typename period_type>
+  bool try_pop_for(l_type &ref, std::chrono::duration<rep_type, period_type> timeout) noexcept;
+
   /**
    * @brief Push the item into the queue
    * 
@@ -129,6 +157,134 @@ private:
   alignas(128UL) std::atomic<uint32_t>  head_,
                                         tail_;
   std::vector<details::fifo_item<type>> data_;
+  /// consumers waiting for items, and producers waiting for slots.
+  parker                                readable_, writable_;
+};
+
+/**
+ * @brief Thread-safety circular First-In-First-Out queue, wait-free ring of
+ * a single producer and a single consumer.
+ *
+ * Each side owns its index and keeps a cached copy of the other one, reloaded
+ * only when the ring looks full or empty, so a handover costs no CAS.
+ *
+ * @tparam type specifies the target type of content.
+ * @note only one thread pushes and only one thread pops at the same time.
+ */
+template <typename type>
+class fifo<type, spsc> {
+public:
+  /**
+   * @brief Pop the first item from the queue
+   * 
+   * @tparam l_type specifies the return type, must be convertible from 'type'.
+   * @param ref specifies the reference to receive.
+   */
+  template <typename l_type>
+  void pop(l_type &ref) noexcept;
+
+  /**
+   * @brief Try to pop the first item from the queue
+   * 
+   * @tparam l_type specifies the return type, must be convertible from 'type'.
+   * @param ref specifies the reference to receive.
+   * @return true if operates successful, false otherwise.
+   */
+  template <typename l_type>
+  bool try_pop(l_type &ref) noexcept;
+
+  /**
+   * @brief Try to pop the first item from the queue, park until pushed or timeout
+   * 
+   * @tparam l_type specifies the return type, must be convertible from 'type'.
+   * @param ref specifies the reference to receive.
+   * @param timeout specifies the max duration to wait.
+   * @return true if operates successful, false if timeout.
+   */
+  template <typename l_type, typename rep_type, typename period_type>
+  bool try_pop_for(l_type &ref, std::chrono::duration<rep_type, period_type> timeout) noexcept;
+
+  /**
+   * @brief Push the item into the queue
+   * 
+   * @tparam r_type specifies the type of target item. must be convertible to 'type'.
+   * @param ref specifies the target item.
+   */
+  template <typename r_type>
+  void push(r_type &&ref) noexcept;
+
+  /**
+   * @brief Try to push the item into the queue
+   * 
+   * @tparam r_type specifies the type of target item. must be convertible to 'type'.
+   * @param ref specifies the target item.
+   * @return true if operates successful, false otherwise.
+   */
+  template <typename r_type>
+  bool try_push(r_type &&ref) noexcept;
+
+  /**
+   * @brief Construct the item directly into the queue
+   * 
+   * @param ref specifies the arguments of consturctor.
+   */
+  template <typename... types>
+  void emplace(types &&...ref) noexcept;
+
+  /**
+   * @brief Try to construct the item directly into the queue
+   * 
+   * @param ref specifies the arguments of consturctor.
+   * @return true if operates successful, false otherwise.
+   */
+  template <typename... types>
+  bool try_emplace(types &&...ref) noexcept;
+
+  /**
+   * @brief Check if the queue is empty
+   * 
+   * @return true if fifo is empty, false otherwise.
+   */
+  bool empty() const noexcept;
+
+  /**
+   * @brief Construct a new fifo object
+   * 
+   * @param size specifies the size of fifo, rounded up to power of two.
+   */
+  explicit fifo(uint32_t size = 128) noexcept;
+
+  ~fifo() noexcept;
+
+  fifo(const fifo &) = delete;
+
+  fifo &operator=(const fifo &) = delete;
+
+private:
+  struct slot {
+    alignas(type) unsigned char storage[sizeof(type)];
+
+    rptr<type> data() noexcept;
+  };
+
+  /// called by the producer, reloads the tail only if looks full.
+  bool writable(uint32_t head) noexcept;
+
+  /// called by the consumer, reloads the head only if looks empty.
+  bool readable(uint32_t tail) noexcept;
+
+private:
+  const uint32_t                       size_;
+  const uint32_t                       mask_;
+  /// written by the producer only.
+  alignas(128UL) std::atomic<uint32_t> head_;
+  uint32_t                             cached_tail_;
+  /// written by the consumer only.
+  alignas(128UL) std::atomic<uint32_t> tail_;
+  uint32_t                             cached_head_;
+  alignas(128UL) uptr<slot[]>          slots_;
+  /// consumer waiting for items, and producer waiting for slots.
+  parker                               readable_, writable_;
 };
 
 } // namespace core
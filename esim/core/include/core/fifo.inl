@@ -21,9 +21,12 @@ inline void fifo_item<type>::emplace(args_type &&...args) {
 template <typename type>
 inline type fifo_item<type>::get() noexcept {
   assert(active());
+  /// moved out before released, the next producer may write at once.
+  type value = std::move(*data_);
+  alloctraits::destroy(alloc, data_);
   active_.store(false, std::memory_order_release);
 
-  return std::move(*data_);
+  return value;
 }
 
 template <typename type>
@@ -42,25 +45,26 @@ inline fifo_item<type>::~fifo_item() noexcept {
 
 } // namespace details
 
-template <typename type>
+template <typename type, typename policy>
 template <typename l_type>
-inline void fifo<type>::pop(l_type &ref) noexcept {
+inline void fifo<type, policy>::pop(l_type &ref) noexcept {
   static_assert(std::is_convertible_v<type, l_type>);
   auto index = fetch_tail();
-  while (!data_[index & mask_].active()) {
-    std::this_thread::yield();
-  }
+  auto &item = data_[index & mask_];
+  readable_.park_until([&]() { return item.active(); });
 
-  ref = data_[index & mask_].get();
+  ref = item.get();
+  writable_.notify_all();
 }
 
-template <typename type>
+template <typename type, typename policy>
 template <typename l_type>
-inline bool fifo<type>::try_pop(l_type &ref) noexcept {
+inline bool fifo<type, policy>::try_pop(l_type &ref) noexcept {
   static_assert(std::is_convertible_v<type, l_type>);
   auto index = tail();
   if (data_[index & mask_].active() && cas_tail(index)) {
     ref = data_[index & mask_].get();
+    writable_.notify_all();
 
     return true;
   }
@@ -68,25 +72,43 @@ inline bool fifo<type>::try_pop(l_type &ref) noexcept {
   return false;
 }
 
-template <typename type>
+template <typename type, typename policy>
+template <typename l_type, typename rep_type, typename period_type>
+inline bool fifo<type, policy>::try_pop_for(l_type &ref, std::chrono::duration<rep_type, period_type> timeout) noexcept {
+  using namespace std::chrono;
+  auto deadline = steady_clock::now() + timeout;
+  while (!try_pop(ref)) {
+    /// the first item may be taken by another consumer, wait for the next one.
+    if (!readable_.park_until_for([&]() { return data_[tail() & mask_].active(); },
+                                  deadline - steady_clock::now())) {
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template <typename type, typename policy>
 template <typename r_type>
-inline void fifo<type>::push(r_type &&ref) noexcept {
+inline void fifo<type, policy>::push(r_type &&ref) noexcept {
   static_assert(std::is_convertible_v<r_type, type>);
   auto index = fetch_head();
-  while (data_[index & mask_].active()) {
-    std::this_thread::yield();
-  }
+  auto &item = data_[index & mask_];
+  writable_.park_until([&]() { return !item.active(); });
 
-  data_[index & mask_].emplace(std::forward<r_type>(ref));
+  item.emplace(std::forward<r_type>(ref));
+  readable_.notify_all();
 }
 
-template <typename type>
+template <typename type, typename policy>
 template <typename r_type>
-inline bool fifo<type>::try_push(r_type &&ref) noexcept {
+inline bool fifo<type, policy>::try_push(r_type &&ref) noexcept {
   static_assert(std::is_convertible_v<r_type, type>);
   auto index = head();
   if (!data_[index & mask_].active() && cas_head(index)) {
     data_[index & mask_].emplace(std::forward<r_type>(ref));
+    readable_.notify_all();
 
     return true;
   }
@@ -94,25 +116,26 @@ inline bool fifo<type>::try_push(r_type &&ref) noexcept {
   return false;
 }
 
-template <typename type>
+template <typename type, typename policy>
 template <typename... types>
-inline void fifo<type>::emplace(types &&...ref) noexcept {
+inline void fifo<type, policy>::emplace(types &&...ref) noexcept {
   static_assert(std::is_constructible_v<type, types...>);
   auto index = fetch_head();
-  while (data_[index & mask_].active()) {
-    std::this_thread::yield();
-  }
+  auto &item = data_[index & mask_];
+  writable_.park_until([&]() { return !item.active(); });
 
-  data_[index & mask_].emplace(std::forward<types>(ref)...);
+  item.emplace(std::forward<types>(ref)...);
+  readable_.notify_all();
 }
 
-template <typename type>
+template <typename type, typename policy>
 template <typename... types>
-inline bool fifo<type>::try_emplace(types &&...ref) noexcept {
+inline bool fifo<type, policy>::try_emplace(types &&...ref) noexcept {
   static_assert(std::is_constructible_v<type, types...>);
   auto index = head();
   if (!data_[index & mask_].active() && cas_head(index)) {
     data_[index & mask_].emplace(std::forward<types>(ref)...);
+    readable_.notify_all();
 
     return true;
   }
@@ -120,55 +143,192 @@ inline bool fifo<type>::try_emplace(types &&...ref) noexcept {
   return false;
 }
 
-template <typename type>
-inline bool fifo<type>::empty() const noexcept {
+template <typename type, typename policy>
+inline bool fifo<type, policy>::empty() const noexcept {
 
   return head(std::memory_order_relaxed) == tail(std::memory_order_relaxed);
 }
 
-template <typename type>
-inline fifo<type>::fifo(uint32_t size) noexcept
+template <typename type, typename policy>
+inline fifo<type, policy>::fifo(uint32_t size) noexcept
     : size_{ceil2_32(size)},
       mask_{size_ - 1},
       head_{0}, tail_{0},
       data_(size_) {}
 
-template <typename type>
-inline uint32_t fifo<type>::head(std::memory_order order) const noexcept {
+template <typename type, typename policy>
+inline uint32_t fifo<type, policy>::head(std::memory_order order) const noexcept {
 
   return head_.load(order);
 }
 
-template <typename type>
-inline uint32_t fifo<type>::tail(std::memory_order order) const noexcept {
+template <typename type, typename policy>
+inline uint32_t fifo<type, policy>::tail(std::memory_order order) const noexcept {
 
   return tail_.load(order);
 }
 
-template <typename type>
-inline uint32_t fifo<type>::fetch_head(std::memory_order order) noexcept {
+template <typename type, typename policy>
+inline uint32_t fifo<type, policy>::fetch_head(std::memory_order order) noexcept {
 
   return head_.fetch_add(1, order);
 }
 
-template <typename type>
-inline uint32_t fifo<type>::fetch_tail(std::memory_order order) noexcept {
+template <typename type, typename policy>
+inline uint32_t fifo<type, policy>::fetch_tail(std::memory_order order) noexcept {
 
   return tail_.fetch_add(1, order);
 }
 
-template <typename type>
-inline bool fifo<type>::cas_head(uint32_t &ref, std::memory_order order) noexcept {
+template <typename type, typename policy>
+inline bool fifo<type, policy>::cas_head(uint32_t &ref, std::memory_order order) noexcept {
 
   return head_.compare_exchange_strong(ref, ref + 1, order);
 }
 
-template <typename type>
-inline bool fifo<type>::cas_tail(uint32_t &ref, std::memory_order order) noexcept {
+template <typename type, typename policy>
+inline bool fifo<type, policy>::cas_tail(uint32_t &ref, std::memory_order order) noexcept {
 
   return tail_.compare_exchange_strong(ref, ref + 1, order, std::memory_order_relaxed);
 }
 
+template <typename type>
+inline rptr<type> fifo<type, spsc>::slot::data() noexcept {
+
+  return std::launder(reinterpret_cast<rptr<type>>(storage));
+}
+
+template <typename type>
+template <typename l_type>
+inline void fifo<type, spsc>::pop(l_type &ref) noexcept {
+  static_assert(std::is_convertible_v<type, l_type>);
+  auto tail = tail_.load(std::memory_order_relaxed);
+  readable_.park_until([&]() { return readable(tail); });
+
+  auto data = slots_[tail & mask_].data();
+  ref = std::move(*data);
+  data->~type();
+  tail_.store(tail + 1, std::memory_order_release);
+  writable_.notify_one();
+}
+
+template <typename type>
+template <typename l_type>
+inline bool fifo<type, spsc>::try_pop(l_type &ref) noexcept {
+  static_assert(std::is_convertible_v<type, l_type>);
+  auto tail = tail_.load(std::memory_order_relaxed);
+  if (!readable(tail)) {
+
+    return false;
+  }
+
+  auto data = slots_[tail & mask_].data();
+  ref = std::move(*data);
+  data->~type();
+  tail_.store(tail + 1, std::memory_order_release);
+  writable_.notify_one();
+
+  return true;
+}
+
+template <typename type>
+template <typename l_type, typename rep_type, typename period_type>
+inline bool fifo<type, spsc>::try_pop_for(l_type &ref, std::chrono::duration<rep_type, period_type> timeout) noexcept {
+  auto tail = tail_.load(std::memory_order_relaxed);
+  if (!readable_.park_until_for([&]() { return readable(tail); }, timeout)) {
+
+    return false;
+  }
+
+  return try_pop(ref);
+}
+
+template <typename type>
+template <typename r_type>
+inline void fifo<type, spsc>::push(r_type &&ref) noexcept {
+  static_assert(std::is_convertible_v<r_type, type>);
+  emplace(std::forward<r_type>(ref));
+}
+
+template <typename type>
+template <typename r_type>
+inline bool fifo<type, spsc>::try_push(r_type &&ref) noexcept {
+  static_assert(std::is_convertible_v<r_type, type>);
+
+  return try_emplace(std::forward<r_type>(ref));
+}
+
+template <typename type>
+template <typename... types>
+inline void fifo<type, spsc>::emplace(types &&...ref) noexcept {
+  auto head = head_.load(std::memory_order_relaxed);
+  writable_.park_until([&]() { return writable(head); });
+
+  new (slots_[head & mask_].storage) type(std::forward<types>(ref)...);
+  head_.store(head + 1, std::memory_order_release);
+  readable_.notify_one();
+}
+
+template <typename type>
+template <typename... types>
+inline bool fifo<type, spsc>::try_emplace(types &&...ref) noexcept {
+  auto head = head_.load(std::memory_order_relaxed);
+  if (!writable(head)) {
+
+    return false;
+  }
+
+  new (slots_[head & mask_].storage) type(std::forward<types>(ref)...);
+  head_.store(head + 1, std::memory_order_release);
+  readable_.notify_one();
+
+  return true;
+}
+
+template <typename type>
+inline bool fifo<type, spsc>::empty() const noexcept {
+
+  return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_relaxed);
+}
+
+template <typename type>
+inline fifo<type, spsc>::fifo(uint32_t size) noexcept
+    : size_{ceil2_32(size)},
+      mask_{size_ - 1},
+      head_{0}, cached_tail_{0},
+      tail_{0}, cached_head_{0},
+      slots_{make_uptr<slot[]>(size_)} {}
+
+template <typename type>
+inline fifo<type, spsc>::~fifo() noexcept {
+  auto head = head_.load(std::memory_order_acquire);
+  for (auto position = tail_.load(std::memory_order_acquire); position != head; ++position) {
+    slots_[position & mask_].data()->~type();
+  }
+}
+
+template <typename type>
+inline bool fifo<type, spsc>::writable(uint32_t head) noexcept {
+  if (head - cached_tail_ < size_) {
+
+    return true;
+  }
+  cached_tail_ = tail_.load(std::memory_order_acquire);
+
+  return head - cached_tail_ < size_;
+}
+
+template <typename type>
+inline bool fifo<type, spsc>::readable(uint32_t tail) noexcept {
+  if (tail != cached_head_) {
+
+    return true;
+  }
+  cached_head_ = head_.load(std::memory_order_acquire);
+
+  return tail != cached_head_;
+}
+
 } // namespace core
 
 } // namespace esim
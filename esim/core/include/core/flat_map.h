@@ -0,0 +1,173 @@
+#ifndef __ESIM_CORE_CORE_FLAT_MAP_H_
+#define __ESIM_CORE_CORE_FLAT_MAP_H_
+
+#include "utils.h"
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief Open addressing hash map with robin hood probing.
+ *
+ * Entries are stored inline in a single array, so lookups touch one or two
+ * cache lines instead of chasing bucket nodes. Erasing shifts the following
+ * entries backward, no tombstone is left behind.
+ *
+ * @tparam key_type specifies the type of key.
+ * @tparam mapped_type specifies the type of value.
+ * @tparam hash_type specifies the hasher of key, its result is mixed again.
+ * @tparam equal_type specifies the equality of key.
+ * @note not thread-safety, iterators and references are invalidated by
+ * inserting and erasing.
+ */
+template <typename key_type,
+          typename mapped_type,
+          typename hash_type = std::hash<key_type>,
+          typename equal_type = std::equal_to<key_type>>
+class flat_map {
+public:
+  typedef std::pair<key_type, mapped_type> value_type;
+
+  template <bool is_const>
+  class basic_iterator {
+  public:
+    typedef std::conditional_t<is_const, const value_type, value_type> reference_type;
+    typedef std::conditional_t<is_const, const flat_map *, flat_map *> owner_type;
+
+    reference_type &operator*() const noexcept;
+    reference_type *operator->() const noexcept;
+    basic_iterator &operator++() noexcept;
+    bool operator==(const basic_iterator &rhs) const noexcept;
+    bool operator!=(const basic_iterator &rhs) const noexcept;
+
+    basic_iterator(owner_type owner, size_t index) noexcept;
+
+  private:
+    friend class flat_map;
+
+    owner_type owner_;
+    size_t     index_;
+  };
+
+  typedef basic_iterator<false> iterator;
+  typedef basic_iterator<true>  const_iterator;
+
+  iterator begin() noexcept;
+  iterator end() noexcept;
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+
+  /**
+   * @brief Find the entry of key.
+   *
+   * @param key specifies the target key.
+   * @return the iterator to entry, end() if not found.
+   */
+  iterator find(const key_type &key) noexcept;
+  const_iterator find(const key_type &key) const noexcept;
+
+  /**
+   * @brief Count the entries of key.
+   *
+   * @param key specifies the target key.
+   * @return 1 if found, 0 otherwise.
+   */
+  size_t count(const key_type &key) const noexcept;
+
+  /**
+   * @brief Construct the value in place if the key does not exist.
+   *
+   * @param key specifies the target key.
+   * @param args specifies the arguments of value constructor.
+   * @return the iterator to entry, and true if inserted.
+   */
+  template <typename... args_type>
+  std::pair<iterator, bool> try_emplace(const key_type &key, args_type &&...args);
+
+  /**
+   * @brief Obtain the value of key, default-constructed if not exists.
+   *
+   * @param key specifies the target key.
+   * @return the reference to value.
+   */
+  mapped_type &operator[](const key_type &key);
+
+  /**
+   * @brief Erase the entry of key.
+   *
+   * @param key specifies the target key.
+   * @return 1 if erased, 0 otherwise.
+   */
+  size_t erase(const key_type &key) noexcept;
+
+  /**
+   * @brief Erase all entries, capacity is kept.
+   *
+   */
+  void clear() noexcept;
+
+  /**
+   * @brief Reserve the room for entries without rehashing.
+   *
+   * @param count specifies the count of entries.
+   */
+  void reserve(size_t count);
+
+  size_t size() const noexcept;
+
+  bool empty() const noexcept;
+
+  /**
+   * @brief Construct a new flat map object
+   *
+   * @param count specifies the count of entries reserved.
+   */
+  explicit flat_map(size_t count = 0);
+
+  flat_map(flat_map &&rhs) noexcept;
+
+  flat_map &operator=(flat_map &&rhs) noexcept;
+
+  flat_map(const flat_map &) = delete;
+
+  flat_map &operator=(const flat_map &) = delete;
+
+  ~flat_map() noexcept;
+
+private:
+  /// maximum load factor in 1/8.
+  constexpr static size_t max_load = 7;
+
+  size_t home(const key_type &key) const noexcept;
+
+  size_t locate(const key_type &key) const noexcept;
+
+  /// places the entry known to be absent, returns its index.
+  size_t place(value_type &&value, size_t index, uint32_t distance) noexcept;
+
+  void rehash(size_t capacity);
+
+  void release() noexcept;
+
+private:
+  /// distance from home slot plus one, 0 for empty slots.
+  uptr<uint32_t[]> distances_;
+  rptr<value_type> slots_;
+  size_t           capacity_;
+  size_t           size_;
+  uint32_t         shift_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#include "flat_map.inl"
+
+#endif
@@ -0,0 +1,317 @@
+namespace esim {
+
+namespace core {
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+template <bool is_const>
+inline typename flat_map<key_type, mapped_type, hash_type, equal_type>::template basic_iterator<is_const>::reference_type &
+flat_map<key_type, mapped_type, hash_type, equal_type>::basic_iterator<is_const>::operator*() const noexcept {
+  assert(index_ < owner_->capacity_);
+
+  return owner_->slots_[index_];
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+template <bool is_const>
+inline typename flat_map<key_type, mapped_type, hash_type, equal_type>::template basic_iterator<is_const>::reference_type *
+flat_map<key_type, mapped_type, hash_type, equal_type>::basic_iterator<is_const>::operator->() const noexcept {
+  assert(index_ < owner_->capacity_);
+
+  return owner_->slots_ + index_;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+template <bool is_const>
+inline typename flat_map<key_type, mapped_type, hash_type, equal_type>::template basic_iterator<is_const> &
+flat_map<key_type, mapped_type, hash_type, equal_type>::basic_iterator<is_const>::operator++() noexcept {
+  do {
+    ++index_;
+  } while (index_ < owner_->capacity_ && 0 == owner_->distances_[index_]);
+
+  return *this;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+template <bool is_const>
+inline bool flat_map<key_type, mapped_type, hash_type, equal_type>::basic_iterator<is_const>::operator==(const basic_iterator &rhs) const noexcept {
+
+  return owner_ == rhs.owner_ && index_ == rhs.index_;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+template <bool is_const>
+inline bool flat_map<key_type, mapped_type, hash_type, equal_type>::basic_iterator<is_const>::operator!=(const basic_iterator &rhs) const noexcept {
+
+  return !(*this == rhs);
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+template <bool is_const>
+inline flat_map<key_type, mapped_type, hash_type, equal_type>::basic_iterator<is_const>::basic_iterator(owner_type owner, size_t index) noexcept
+    : owner_{owner}, index_{index} {
+  while (index_ < owner_->capacity_ && 0 == owner_->distances_[index_]) {
+    ++index_;
+  }
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline typename flat_map<key_type, mapped_type, hash_type, equal_type>::iterator flat_map<key_type, mapped_type, hash_type, equal_type>::begin() noexcept {
+
+  return iterator(this, 0);
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline typename flat_map<key_type, mapped_type, hash_type, equal_type>::iterator flat_map<key_type, mapped_type, hash_type, equal_type>::end() noexcept {
+
+  return iterator(this, capacity_);
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline typename flat_map<key_type, mapped_type, hash_type, equal_type>::const_iterator flat_map<key_type, mapped_type, hash_type, equal_type>::begin() const noexcept {
+
+  return const_iterator(this, 0);
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline typename flat_map<key_type, mapped_type, hash_type, equal_type>::const_iterator flat_map<key_type, mapped_type, hash_type, equal_type>::end() const noexcept {
+
+  return const_iterator(this, capacity_);
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline typename flat_map<key_type, mapped_type, hash_type, equal_type>::iterator flat_map<key_type, mapped_type, hash_type, equal_type>::find(const key_type &key) noexcept {
+
+  return iterator(this, locate(key));
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline typename flat_map<key_type, mapped_type, hash_type, equal_type>::const_iterator flat_map<key_type, mapped_type, hash_type, equal_type>::find(const key_type &key) const noexcept {
+
+  return const_iterator(this, locate(key));
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline size_t flat_map<key_type, mapped_type, hash_type, equal_type>::count(const key_type &key) const noexcept {
+
+  return locate(key) == capacity_ ? 0 : 1;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+template <typename... args_type>
+inline std::pair<typename flat_map<key_type, mapped_type, hash_type, equal_type>::iterator, bool>
+flat_map<key_type, mapped_type, hash_type, equal_type>::try_emplace(const key_type &key, args_type &&...args) {
+  if (size_t index = locate(key); index != capacity_) {
+
+    return {iterator(this, index), false};
+  }
+
+  if ((size_ + 1) * 8 > capacity_ * max_load) {
+    rehash(capacity_ == 0 ? 8 : capacity_ * 2);
+  }
+  size_t index = place(value_type(std::piecewise_construct,
+                                  std::forward_as_tuple(key),
+                                  std::forward_as_tuple(std::forward<args_type>(args)...)),
+                       home(key), 1);
+  ++size_;
+
+  return {iterator(this, index), true};
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline mapped_type &flat_map<key_type, mapped_type, hash_type, equal_type>::operator[](const key_type &key) {
+
+  return try_emplace(key).first->second;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline size_t flat_map<key_type, mapped_type, hash_type, equal_type>::erase(const key_type &key) noexcept {
+  size_t index = locate(key);
+  if (index == capacity_) {
+
+    return 0;
+  }
+
+  /// shift the following entries back until one is at its home slot.
+  const size_t mask = capacity_ - 1;
+  for (size_t next = (index + 1) & mask; distances_[next] > 1; next = (next + 1) & mask) {
+    slots_[index] = std::move(slots_[next]);
+    distances_[index] = distances_[next] - 1;
+    index = next;
+  }
+  std::destroy_at(slots_ + index);
+  distances_[index] = 0;
+  --size_;
+
+  return 1;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline void flat_map<key_type, mapped_type, hash_type, equal_type>::clear() noexcept {
+  for (size_t i = 0; i < capacity_; ++i) {
+    if (0 != distances_[i]) {
+      std::destroy_at(slots_ + i);
+      distances_[i] = 0;
+    }
+  }
+  size_ = 0;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline void flat_map<key_type, mapped_type, hash_type, equal_type>::reserve(size_t count) {
+  size_t capacity = 8;
+  while (count * 8 > capacity * max_load) {
+    capacity *= 2;
+  }
+
+  if (capacity > capacity_) {
+    rehash(capacity);
+  }
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline size_t flat_map<key_type, mapped_type, hash_type, equal_type>::size() const noexcept {
+
+  return size_;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline bool flat_map<key_type, mapped_type, hash_type, equal_type>::empty() const noexcept {
+
+  return 0 == size_;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline flat_map<key_type, mapped_type, hash_type, equal_type>::flat_map(size_t count)
+    : distances_{nullptr}, slots_{nullptr}, capacity_{0}, size_{0}, shift_{64} {
+  if (count > 0) {
+    reserve(count);
+  }
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline flat_map<key_type, mapped_type, hash_type, equal_type>::flat_map(flat_map &&rhs) noexcept
+    : distances_{std::move(rhs.distances_)}, slots_{rhs.slots_},
+      capacity_{rhs.capacity_}, size_{rhs.size_}, shift_{rhs.shift_} {
+  rhs.slots_ = nullptr;
+  rhs.capacity_ = rhs.size_ = 0;
+  rhs.shift_ = 64;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline flat_map<key_type, mapped_type, hash_type, equal_type> &flat_map<key_type, mapped_type, hash_type, equal_type>::operator=(flat_map &&rhs) noexcept {
+  if (this != &rhs) {
+    release();
+    distances_ = std::move(rhs.distances_);
+    slots_ = rhs.slots_;
+    capacity_ = rhs.capacity_;
+    size_ = rhs.size_;
+    shift_ = rhs.shift_;
+    rhs.slots_ = nullptr;
+    rhs.capacity_ = rhs.size_ = 0;
+    rhs.shift_ = 64;
+  }
+
+  return *this;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline flat_map<key_type, mapped_type, hash_type, equal_type>::~flat_map() noexcept {
+  release();
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline size_t flat_map<key_type, mapped_type, hash_type, equal_type>::home(const key_type &key) const noexcept {
+  /// fibonacci hashing spreads weak hashes (e.g. pointers) over the table.
+  uint64_t hash = static_cast<uint64_t>(hash_type{}(key));
+
+  return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ULL) >> shift_);
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline size_t flat_map<key_type, mapped_type, hash_type, equal_type>::locate(const key_type &key) const noexcept {
+  if (0 == size_) {
+
+    return capacity_;
+  }
+
+  const size_t mask = capacity_ - 1;
+  size_t index = home(key);
+  for (uint32_t distance = 1; distance <= distances_[index]; ++distance) {
+    if (distance == distances_[index] && equal_type{}(slots_[index].first, key)) {
+
+      return index;
+    }
+    index = (index + 1) & mask;
+  }
+
+  return capacity_;
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline size_t flat_map<key_type, mapped_type, hash_type, equal_type>::place(value_type &&value, size_t index, uint32_t distance) noexcept {
+  const size_t mask = capacity_ - 1;
+  size_t placed = capacity_;
+  value_type carry = std::move(value);
+
+  for (;; index = (index + 1) & mask, ++distance) {
+    if (0 == distances_[index]) {
+      new (slots_ + index) value_type(std::move(carry));
+      distances_[index] = distance;
+
+      return placed == capacity_ ? index : placed;
+    }
+
+    /// robin hood, takes the slot from the entry closer to its home.
+    if (distances_[index] < distance) {
+      std::swap(carry, slots_[index]);
+      std::swap(distance, distances_[index]);
+      if (placed == capacity_) {
+        placed = index;
+      }
+    }
+  }
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline void flat_map<key_type, mapped_type, hash_type, equal_type>::rehash(size_t capacity) {
+  assert(0 == (capacity & (capacity - 1)));
+  std::allocator<value_type> alloc;
+  auto   distances = std::move(distances_);
+  auto   slots = slots_;
+  size_t old_capacity = capacity_;
+
+  distances_ = std::make_unique<uint32_t[]>(capacity);
+  slots_ = alloc.allocate(capacity);
+  capacity_ = capacity;
+  shift_ = 64;
+  for (size_t n = capacity; n > 1; n >>= 1) {
+    --shift_;
+  }
+
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (0 != distances[i]) {
+      size_t index = home(slots[i].first);
+      place(std::move(slots[i]), index, 1);
+      std::destroy_at(slots + i);
+    }
+  }
+  if (nullptr != slots) {
+    alloc.deallocate(slots, old_capacity);
+  }
+}
+
+template <typename key_type, typename mapped_type, typename hash_type, typename equal_type>
+inline void flat_map<key_type, mapped_type, hash_type, equal_type>::release() noexcept {
+  clear();
+  if (nullptr != slots_) {
+    std::allocator<value_type>().deallocate(slots_, capacity_);
+  }
+  distances_.reset();
+  slots_ = nullptr;
+  capacity_ = 0;
+  shift_ = 64;
+}
+
+} // namespace core
+
+} // namespace esim
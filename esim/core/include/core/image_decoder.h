@@ -0,0 +1,141 @@
+#ifndef __ESIM_CORE_IMAGE_DECODER_H_
+#define __ESIM_CORE_IMAGE_DECODER_H_
+
+#include "core/bitmap.h"
+#include "core/utils.h"
+#include <string>
+#include <string_view>
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief The header information of an encoded image.
+ *
+ */
+struct image_info {
+  int width;
+  int height;
+  int channel;
+};
+
+/**
+ * @brief The interface of image decoder backends.
+ *
+ * @note decoders are stateless and can be used by multiple threads.
+ */
+class image_decoder {
+public:
+  /**
+   * @brief Obtain the name of decoder backend.
+   *
+   * @return the backend name.
+   */
+  virtual std::string_view name() const noexcept = 0;
+
+  /**
+   * @brief Read the header of encoded image without decoding pixels.
+   *
+   * @param data specifies the encoded image.
+   * @param size specifies the size of encoded image.
+   * @param info specifies the information where stored in.
+   * @return true if the image is supported, false otherwise.
+   */
+  virtual bool probe(const char *data, size_t size, image_info &info) const noexcept = 0;
+
+  /**
+   * @brief Decode the image into the bitmap.
+   *
+   * @param data specifies the encoded image.
+   * @param size specifies the size of encoded image.
+   * @param out specifies the bitmap adopting the decoded pixels.
+   * @param alloc specifies the allocator of pixels buffer, the backend
+   * chooses its own buffer if empty.
+   * @return true if decoded successfully, false otherwise.
+   */
+  virtual bool decode(const char *data, size_t size, bitmap &out,
+                      const bitmap::allocator_type &alloc) const noexcept = 0;
+
+  virtual ~image_decoder() = default;
+};
+
+/**
+ * @brief Decoder backend by stb_image, supports most formats.
+ *
+ * @note decodes into its own buffer and adopts it if no allocator given,
+ * otherwise the pixels are copied into the allocated buffer once.
+ */
+class stb_image_decoder final : public image_decoder {
+public:
+  static rptr<const stb_image_decoder> get() noexcept;
+
+  std::string_view name() const noexcept final;
+
+  bool probe(const char *data, size_t size, image_info &info) const noexcept final;
+
+  bool decode(const char *data, size_t size, bitmap &out,
+              const bitmap::allocator_type &alloc) const noexcept final;
+};
+
+/**
+ * @brief Decoder backend for the uncompressed pixels written by
+ * encode_raw_image, which costs a single copy.
+ *
+ */
+class raw_image_decoder final : public image_decoder {
+public:
+  static rptr<const raw_image_decoder> get() noexcept;
+
+  std::string_view name() const noexcept final;
+
+  bool probe(const char *data, size_t size, image_info &info) const noexcept final;
+
+  bool decode(const char *data, size_t size, bitmap &out,
+              const bitmap::allocator_type &alloc) const noexcept final;
+};
+
+#if defined(ESIM_ENABLE_LIBJPEG)
+
+/**
+ * @brief Decoder backend by libjpeg(-turbo) with SIMD, supports JPEG only.
+ *
+ * @note decodes scanlines straight into the allocated buffer.
+ */
+class jpeg_image_decoder final : public image_decoder {
+public:
+  static rptr<const jpeg_image_decoder> get() noexcept;
+
+  std::string_view name() const noexcept final;
+
+  bool probe(const char *data, size_t size, image_info &info) const noexcept final;
+
+  bool decode(const char *data, size_t size, bitmap &out,
+              const bitmap::allocator_type &alloc) const noexcept final;
+};
+
+#endif
+
+/**
+ * @brief Encode the bitmap as uncompressed pixels with a small header.
+ *
+ * @param image specifies the bitmap to encode.
+ * @param out specifies the encoded data.
+ * @return true if encoded successfully, false if the bitmap is empty.
+ */
+bool encode_raw_image(const bitmap &image, std::string &out) noexcept;
+
+/**
+ * @brief Select the fastest decoder backend for the encoded image.
+ *
+ * @param data specifies the encoded image.
+ * @param size specifies the size of encoded image.
+ * @return the decoder backend.
+ */
+rptr<const image_decoder> select_image_decoder(const char *data, size_t size) noexcept;
+
+} // namespace core
+
+} // namespace esim
+
+#endif
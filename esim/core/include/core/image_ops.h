@@ -0,0 +1,154 @@
+#ifndef __ESIM_CORE_IMAGE_OPS_H_
+#define __ESIM_CORE_IMAGE_OPS_H_
+
+#include "core/bitmap.h"
+#include "core/utils.h"
+#include <cstdint>
+#include <vector>
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief Pixels with the full mip chain, level 0 first and 1x1 last.
+ *
+ */
+struct mip_chain {
+  struct level {
+    int    width, height;
+    size_t offset, size;
+  };
+
+  int                  channel = 0;
+  std::vector<level>   levels;
+  std::vector<uint8_t> data;
+};
+
+/**
+ * @brief Filters to generate mip levels.
+ *
+ */
+enum class mip_filter : uint32_t {
+  /// averages 2x2 pixels, the fastest.
+  box = 0,
+  /// kaiser windowed sinc of 8 taps, sharper with less aliasing.
+  kaiser
+};
+
+/**
+ * @brief Modes to blend a layer onto the pixels below.
+ *
+ */
+enum class blend_mode : uint32_t {
+  /// covers the pixels below by its alpha.
+  normal = 0,
+  /// darkens, e.g. shadings.
+  multiply,
+  /// lightens, e.g. clouds.
+  screen,
+  /// saturates, e.g. lights.
+  add
+};
+
+namespace image_ops {
+
+/**
+ * @brief Expand the rgb pixels into rgba.
+ *
+ * @param src specifies the rgb pixels.
+ * @param dst specifies the rgba pixels, must not overlap with src.
+ * @param count specifies the count of pixels.
+ * @param alpha specifies the alpha filled.
+ */
+void expand_rgb_to_rgba(const uint8_t *src, uint8_t *dst, size_t count, uint8_t alpha = 255) noexcept;
+
+/**
+ * @brief Halve the pixels by averaging 2x2 pixels, the last row or column
+ * is repeated for odd sizes.
+ *
+ * @param src specifies the source pixels.
+ * @param width specifies the width of source.
+ * @param height specifies the height of source.
+ * @param channel specifies the channel of pixels, 1 to 4.
+ * @param dst specifies the pixels of max(1, width / 2) x max(1, height / 2).
+ * @param srgb specifies whether to average in linear space, alpha is always linear.
+ */
+void downsample_box(const uint8_t *src, int width, int height, int channel,
+                    uint8_t *dst, bool srgb = false) noexcept;
+
+/**
+ * @brief Halve the pixels by the separable kaiser windowed sinc, edges are clamped.
+ *
+ * @param src specifies the source pixels.
+ * @param width specifies the width of source.
+ * @param height specifies the height of source.
+ * @param channel specifies the channel of pixels, 1 to 4.
+ * @param dst specifies the pixels of max(1, width / 2) x max(1, height / 2).
+ * @param srgb specifies whether to filter in linear space, alpha is always linear.
+ */
+void downsample_kaiser(const uint8_t *src, int width, int height, int channel,
+                       uint8_t *dst, bool srgb = false) noexcept;
+
+/**
+ * @brief Flip the pixels upside down in place.
+ *
+ * @param data specifies the pixels.
+ * @param width specifies the width of pixels.
+ * @param height specifies the height of pixels.
+ * @param channel specifies the channel of pixels.
+ */
+void flip_vertical(uint8_t *data, int width, int height, int channel) noexcept;
+
+/**
+ * @brief Blend the layer onto the rgb pixels in place.
+ *
+ * @param dst specifies the rgb pixels below.
+ * @param src specifies the pixels of layer, 1 to 4 channels, the last channel of 2 or 4 is alpha.
+ * @param channel specifies the channel of layer.
+ * @param count specifies the count of pixels.
+ * @param mode specifies the blend mode.
+ * @param opacity specifies the opacity of layer, scales its alpha.
+ */
+void blend(uint8_t *dst, const uint8_t *src, int channel, size_t count,
+           blend_mode mode, float opacity = 1.0f) noexcept;
+
+/**
+ * @brief Resample the region of pixels into the pixels of another resolution
+ * by bilinear filter, edges are clamped.
+ *
+ * @param src specifies the source pixels.
+ * @param width specifies the width of source.
+ * @param height specifies the height of source.
+ * @param channel specifies the channel of pixels, 1 to 4.
+ * @param x specifies the left of region in source pixels.
+ * @param y specifies the top of region in source pixels.
+ * @param region_width specifies the width of region in source pixels.
+ * @param region_height specifies the height of region in source pixels.
+ * @param dst specifies the destination pixels.
+ * @param dst_width specifies the width of destination.
+ * @param dst_height specifies the height of destination.
+ */
+void resample_region(const uint8_t *src, int width, int height, int channel,
+                     float x, float y, float region_width, float region_height,
+                     uint8_t *dst, int dst_width, int dst_height) noexcept;
+
+/**
+ * @brief Expand the bitmap into rgba and generate the full mip chain.
+ *
+ * @param image specifies the bitmap of 1 to 4 channels, gray is replicated into rgb.
+ * @param out specifies the rgba mip chain.
+ * @param filter specifies the filter of mip levels.
+ * @param srgb specifies whether the pixels are srgb encoded.
+ * @return true if generated successfully, false otherwise.
+ */
+bool generate_mip_chain(const bitmap &image, mip_chain &out,
+                        mip_filter filter = mip_filter::box, bool srgb = false) noexcept;
+
+} // namespace image_ops
+
+} // namespace core
+
+} // namespace esim
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef __ESIM_CORE_CORE_MPMC_QUEUE_H_
+#define __ESIM_CORE_CORE_MPMC_QUEUE_H_
+
+#include "parker.h"
+#include "utils.h"
+#include <atomic>
+#include <cassert>
+#include <new>
+#include <type_traits>
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief Thread-safety bounded First-In-First-Out queue, the values are stored
+ * inline in slots and handed over by per-slot sequence counters (Vyukov).
+ *
+ * A slot of position p is free once its sequence equals p, and filled once
+ * it equals p + 1; the consumer recycles it for the next lap as p + size.
+ *
+ * @tparam type specifies the target type of content.
+ * @note multiple producer multiple consumer supported.
+ */
+template <typename type>
+class mpmc_queue {
+public:
+  /**
+   * @brief Pop the first item from the queue, wait until pushed.
+   *
+   * @tparam l_type specifies the return type, must be convertible from 'type'.
+   * @param ref specifies the reference to receive.
+   */
+  template <typename l_type>
+  void pop(l_type &ref) noexcept;
+
+  /**
+   * @brief Try to pop the first item from the queue
+   *
+   * @tparam l_type specifies the return type, must be convertible from 'type'.
+   * @param ref specifies the reference to receive.
+   * @return true if operates successful, false otherwise.
+   */
+  template <typename l_type>
+  bool try_pop(l_type &ref) noexcept;
+
+  /**
+   * @brief Try to pop the consecutive items at once.
+   *
+   * @tparam out_type specifies the output iterator, must be assignable from 'type'.
+   * @param out specifies the iterator to receive.
+   * @param count specifies the max count of items.
+   * @return the count of items popped, 0 if empty.
+   */
+  template <typename out_type>
+  size_t try_pop_n(out_type out, size_t count) noexcept;
+
+  /**
+   * @brief Push the item into the queue, wait until a slot freed.
+   *
+   * @tparam r_type specifies the type of target item. must be convertible to 'type'.
+   * @param ref specifies the target item.
+   */
+  template <typename r_type>
+  void push(r_type &&ref) noexcept;
+
+  /**
+   * @brief Try to push the item into the queue
+   *
+   * @tparam r_type specifies the type of target item. must be convertible to 'type'.
+   * @param ref specifies the target item.
+   * @return true if operates successful, false otherwise.
+   */
+  template <typename r_type>
+  bool try_push(r_type &&ref) noexcept;
+
+  /**
+   * @brief Try to push the consecutive items at once, moved from the input.
+   *
+   * @tparam in_type specifies the input iterator, must be convertible to 'type'.
+   * @param first specifies the iterator of the first item.
+   * @param count specifies the count of items.
+   * @return the count of items pushed, the leading ones, 0 if full.
+   */
+  template <typename in_type>
+  size_t try_push_n(in_type first, size_t count) noexcept;
+
+  /**
+   * @brief Construct the item directly into the queue, wait until a slot freed.
+   *
+   * @param ref specifies the arguments of consturctor.
+   */
+  template <typename... types>
+  void emplace(types &&...ref) noexcept;
+
+  /**
+   * @brief Try to construct the item directly into the queue
+   *
+   * @param ref specifies the arguments of consturctor.
+   * @return true if operates successful, false otherwise.
+   */
+  template <typename... types>
+  bool try_emplace(types &&...ref) noexcept;
+
+  /**
+   * @brief Check if the queue is empty
+   *
+   * @return true if queue is empty, false otherwise.
+   */
+  bool empty() const noexcept;
+
+  /**
+   * @brief Construct a new mpmc queue object
+   *
+   * @param size specifies the size of queue, rounded up to power of two, at least 2.
+   */
+  explicit mpmc_queue(uint32_t size = 128) noexcept;
+
+  ~mpmc_queue() noexcept;
+
+  mpmc_queue(const mpmc_queue &) = delete;
+
+  mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+private:
+  struct slot {
+    std::atomic<uint32_t> sequence;
+    alignas(type) unsigned char storage[sizeof(type)];
+
+    rptr<type> data() noexcept;
+  };
+
+  /// the distance from the expected sequence, wrap-around safe.
+  static int32_t distance(uint32_t sequence, uint32_t expected) noexcept;
+
+  /// counts the slots ready from position, up to count.
+  uint32_t count_ready(uint32_t position, uint32_t offset, size_t count) const noexcept;
+
+private:
+  const uint32_t                       size_;
+  const uint32_t                       mask_;
+  /// producers and consumers never share a cache line.
+  alignas(128UL) std::atomic<uint32_t> head_;
+  alignas(128UL) std::atomic<uint32_t> tail_;
+  alignas(128UL) uptr<slot[]>          slots_;
+  /// the blocking consumers and producers park on.
+  parker                               readable_, writable_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#include "mpmc_queue.inl"
+
+#endif
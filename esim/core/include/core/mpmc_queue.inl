@@ -0,0 +1,209 @@
+#include <algorithm>
+
+namespace esim {
+
+namespace core {
+
+template <typename type>
+inline rptr<type> mpmc_queue<type>::slot::data() noexcept {
+
+  return std::launder(reinterpret_cast<rptr<type>>(storage));
+}
+
+template <typename type>
+template <typename l_type>
+inline void mpmc_queue<type>::pop(l_type &ref) noexcept {
+  static_assert(std::is_convertible_v<type, l_type>);
+  auto position = tail_.fetch_add(1, std::memory_order_relaxed);
+  auto &target = slots_[position & mask_];
+  readable_.park_until([&]() { return target.sequence.load(std::memory_order_acquire) == position + 1; });
+
+  ref = std::move(*target.data());
+  target.data()->~type();
+  target.sequence.store(position + size_, std::memory_order_release);
+  /// the producers wait for their own slots, all of them checked.
+  writable_.notify_all();
+}
+
+template <typename type>
+template <typename l_type>
+inline bool mpmc_queue<type>::try_pop(l_type &ref) noexcept {
+  static_assert(std::is_convertible_v<type, l_type>);
+  auto position = tail_.load(std::memory_order_relaxed);
+  for (;;) {
+    auto &target = slots_[position & mask_];
+    auto diff = distance(target.sequence.load(std::memory_order_acquire), position + 1);
+    if (diff == 0) {
+      if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        ref = std::move(*target.data());
+        target.data()->~type();
+        target.sequence.store(position + size_, std::memory_order_release);
+        writable_.notify_all();
+
+        return true;
+      }
+    } else if (diff < 0) {
+      /// not pushed yet.
+
+      return false;
+    } else {
+      position = tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename type>
+template <typename out_type>
+inline size_t mpmc_queue<type>::try_pop_n(out_type out, size_t count) noexcept {
+  auto position = tail_.load(std::memory_order_relaxed);
+  uint32_t ready = 0;
+  do {
+    ready = count_ready(position, 1, count);
+    if (0 == ready) {
+
+      return 0;
+    }
+  } while (!tail_.compare_exchange_weak(position, position + ready, std::memory_order_relaxed));
+
+  for (uint32_t i = 0; i < ready; ++i) {
+    auto &target = slots_[(position + i) & mask_];
+    *out = std::move(*target.data());
+    ++out;
+    target.data()->~type();
+    target.sequence.store(position + i + size_, std::memory_order_release);
+  }
+  writable_.notify_all();
+
+  return ready;
+}
+
+template <typename type>
+template <typename r_type>
+inline void mpmc_queue<type>::push(r_type &&ref) noexcept {
+  static_assert(std::is_convertible_v<r_type, type>);
+  emplace(std::forward<r_type>(ref));
+}
+
+template <typename type>
+template <typename r_type>
+inline bool mpmc_queue<type>::try_push(r_type &&ref) noexcept {
+  static_assert(std::is_convertible_v<r_type, type>);
+
+  return try_emplace(std::forward<r_type>(ref));
+}
+
+template <typename type>
+template <typename in_type>
+inline size_t mpmc_queue<type>::try_push_n(in_type first, size_t count) noexcept {
+  auto position = head_.load(std::memory_order_relaxed);
+  uint32_t ready = 0;
+  do {
+    ready = count_ready(position, 0, count);
+    if (0 == ready) {
+
+      return 0;
+    }
+  } while (!head_.compare_exchange_weak(position, position + ready, std::memory_order_relaxed));
+
+  for (uint32_t i = 0; i < ready; ++i) {
+    auto &target = slots_[(position + i) & mask_];
+    new (target.storage) type(std::move(*first));
+    ++first;
+    target.sequence.store(position + i + 1, std::memory_order_release);
+  }
+  readable_.notify_all();
+
+  return ready;
+}
+
+template <typename type>
+template <typename... types>
+inline void mpmc_queue<type>::emplace(types &&...ref) noexcept {
+  static_assert(std::is_constructible_v<type, types...>);
+  auto position = head_.fetch_add(1, std::memory_order_relaxed);
+  auto &target = slots_[position & mask_];
+  writable_.park_until([&]() { return target.sequence.load(std::memory_order_acquire) == position; });
+
+  new (target.storage) type(std::forward<types>(ref)...);
+  target.sequence.store(position + 1, std::memory_order_release);
+  /// the consumers wait for their own slots, all of them checked.
+  readable_.notify_all();
+}
+
+template <typename type>
+template <typename... types>
+inline bool mpmc_queue<type>::try_emplace(types &&...ref) noexcept {
+  static_assert(std::is_constructible_v<type, types...>);
+  auto position = head_.load(std::memory_order_relaxed);
+  for (;;) {
+    auto &target = slots_[position & mask_];
+    auto diff = distance(target.sequence.load(std::memory_order_acquire), position);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        new (target.storage) type(std::forward<types>(ref)...);
+        target.sequence.store(position + 1, std::memory_order_release);
+        readable_.notify_all();
+
+        return true;
+      }
+    } else if (diff < 0) {
+      /// not popped yet since the last lap.
+
+      return false;
+    } else {
+      position = head_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename type>
+inline bool mpmc_queue<type>::empty() const noexcept {
+
+  return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_relaxed);
+}
+
+template <typename type>
+inline mpmc_queue<type>::mpmc_queue(uint32_t size) noexcept
+    /// a single slot never tells full from empty.
+    : size_{ceil2_32(std::max<uint32_t>(2, size))},
+      mask_{size_ - 1},
+      head_{0}, tail_{0},
+      slots_{new slot[size_]} {
+  for (uint32_t i = 0; i < size_; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+template <typename type>
+inline mpmc_queue<type>::~mpmc_queue() noexcept {
+  auto head = head_.load(std::memory_order_acquire);
+  for (auto position = tail_.load(std::memory_order_acquire); position != head; ++position) {
+    auto &target = slots_[position & mask_];
+    if (target.sequence.load(std::memory_order_acquire) == position + 1) {
+      target.data()->~type();
+    }
+  }
+}
+
+template <typename type>
+inline int32_t mpmc_queue<type>::distance(uint32_t sequence, uint32_t expected) noexcept {
+
+  return static_cast<int32_t>(sequence - expected);
+}
+
+template <typename type>
+inline uint32_t mpmc_queue<type>::count_ready(uint32_t position, uint32_t offset,
+                                              size_t count) const noexcept {
+  uint32_t ready = 0;
+  while (ready < count && ready < size_ &&
+         slots_[(position + ready) & mask_].sequence.load(std::memory_order_acquire) ==
+             position + ready + offset) {
+    ++ready;
+  }
+
+  return ready;
+}
+
+} // namespace core
+
+} // namespace esim
@@ -0,0 +1,143 @@
+#ifndef __ESIM_CORE_CORE_OBJECT_POOL_H_
+#define __ESIM_CORE_CORE_OBJECT_POOL_H_
+
+#include "unbounded_queue.h"
+#include "utils.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace esim {
+
+namespace core {
+
+template <typename type>
+class object_pool;
+
+/**
+ * @brief Returns the object into the pool it created from.
+ *
+ */
+template <typename type>
+struct pool_deleter {
+  rptr<object_pool<type>> pool = nullptr;
+
+  void operator()(rptr<type> target) const noexcept;
+};
+
+template <typename type>
+using pool_ptr = std::unique_ptr<type, pool_deleter<type>>;
+
+/**
+ * @brief Thread-safety pool of objects in fixed size slabs, the slots freed
+ * are recycled rather than returned to the heap.
+ *
+ * Each thread caches the free slots of its own, creating and destroying hit
+ * the cache without any synchronization. A cache exhausted refills half from
+ * the shared depot, or carves a new slab; a cache overflowed moves half into
+ * the depot, so the slots freed by one thread are reused by the others.
+ *
+ * The objects created together come from the same slab mostly, e.g. the
+ * siblings of a quadtree, kept contiguous in memory.
+ *
+ * @tparam type specifies the type of objects.
+ * @note all objects must be destroyed before the pool, the slots cached by
+ * any thread are reclaimed along with the slabs. The pool never touches the
+ * caches of threads once destroyed, each thread drops the caches of pools
+ * destroyed by itself, so a pool may outlive the threads used it.
+ */
+template <typename type>
+class object_pool {
+public:
+  /**
+   * @brief Construct an object from the pool.
+   *
+   * @param args specifies the arguments of constructor.
+   * @return the object, destroyed into the pool once released.
+   */
+  template <typename... types>
+  pool_ptr<type> make(types &&...args) noexcept;
+
+  /**
+   * @brief Construct an object from the pool, destroyed explicitly.
+   *
+   * @param args specifies the arguments of constructor.
+   * @return the object.
+   */
+  template <typename... types>
+  rptr<type> create(types &&...args) noexcept;
+
+  /**
+   * @brief Destroy the object and recycle its slot.
+   *
+   * @param target specifies the object created by this pool, may be null.
+   */
+  void destroy(rptr<type> target) noexcept;
+
+  /**
+   * @brief Obtain the count of slots carved from the slabs.
+   *
+   * @return the count of slots, either in use or free.
+   */
+  size_t capacity() const noexcept;
+
+  /**
+   * @brief Construct a new object pool object
+   *
+   * @param slab_size specifies the count of slots in each slab.
+   * @param cache_size specifies the max count of free slots cached by a thread.
+   */
+  explicit object_pool(uint32_t slab_size = 64, uint32_t cache_size = 64) noexcept;
+
+  ~object_pool() noexcept;
+
+  object_pool(const object_pool &) = delete;
+
+  object_pool &operator=(const object_pool &) = delete;
+
+private:
+  union slot {
+    alignas(type) unsigned char storage[sizeof(type)];
+  };
+
+  struct slab {
+    uptr<slot[]> slots;
+    rptr<slab>   next;
+  };
+
+  struct cache {
+    uint64_t                owner;
+    /// expired once the pool destroyed.
+    std::weak_ptr<void>     alive;
+    std::vector<rptr<slot>> slots;
+  };
+
+  rptr<slot> acquire() noexcept;
+
+  void recycle(rptr<slot> target) noexcept;
+
+  /// the caches of all pools on the calling thread.
+  static std::vector<cache> &caches() noexcept;
+
+  /// the cache of this pool on the calling thread.
+  cache &local() noexcept;
+
+private:
+  const uint32_t                        slab_size_, cache_size_;
+  /// never reused, the caches of pools destroyed are never matched.
+  const uint64_t                        id_;
+  sptr<void>                            alive_;
+  std::atomic<rptr<slab>>               slabs_;
+  std::atomic<size_t>                   capacity_;
+  unbounded_queue<rptr<slot>>           depot_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#include "object_pool.inl"
+
+#endif
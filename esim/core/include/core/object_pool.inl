@@ -0,0 +1,148 @@
+#include <algorithm>
+
+namespace esim {
+
+namespace core {
+
+namespace details {
+
+inline uint64_t next_object_pool_id() noexcept {
+  static std::atomic<uint64_t> id{0};
+
+  return id.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace details
+
+template <typename type>
+inline void pool_deleter<type>::operator()(rptr<type> target) const noexcept {
+  assert(nullptr != pool);
+  pool->destroy(target);
+}
+
+template <typename type>
+template <typename... types>
+inline pool_ptr<type> object_pool<type>::make(types &&...args) noexcept {
+
+  return pool_ptr<type>{create(std::forward<types>(args)...), pool_deleter<type>{this}};
+}
+
+template <typename type>
+template <typename... types>
+inline rptr<type> object_pool<type>::create(types &&...args) noexcept {
+  auto target = acquire();
+
+  return new (target->storage) type(std::forward<types>(args)...);
+}
+
+template <typename type>
+inline void object_pool<type>::destroy(rptr<type> target) noexcept {
+  if (nullptr == target) {
+
+    return;
+  }
+
+  target->~type();
+  recycle(reinterpret_cast<rptr<slot>>(target));
+}
+
+template <typename type>
+inline size_t object_pool<type>::capacity() const noexcept {
+
+  return capacity_.load(std::memory_order_relaxed);
+}
+
+template <typename type>
+inline object_pool<type>::object_pool(uint32_t slab_size, uint32_t cache_size) noexcept
+    : slab_size_{std::max<uint32_t>(1, slab_size)},
+      cache_size_{std::max<uint32_t>(2, cache_size)},
+      id_{details::next_object_pool_id()}, alive_{make_sptr<char>()},
+      slabs_{nullptr}, capacity_{0} {}
+
+template <typename type>
+inline object_pool<type>::~object_pool() noexcept {
+  /// the slots cached or in depot point into the slabs, dropped along.
+  /// the caches are left to their threads, which may have exited already.
+  alive_.reset();
+  for (auto target = slabs_.load(std::memory_order_acquire); nullptr != target;) {
+    auto next = target->next;
+    delete target;
+    target = next;
+  }
+}
+
+template <typename type>
+inline rptr<typename object_pool<type>::slot> object_pool<type>::acquire() noexcept {
+  auto &slots = local().slots;
+  if (slots.empty()) {
+    rptr<slot> target = nullptr;
+    while (slots.size() < cache_size_ / 2 && depot_.try_pop(target)) {
+      slots.emplace_back(target);
+    }
+  }
+  if (!slots.empty()) {
+    auto target = slots.back();
+    slots.pop_back();
+
+    return target;
+  }
+
+  /// carved in reverse, the first ones popped are adjacent.
+  auto created = new slab{make_uptr<slot[]>(slab_size_), slabs_.load(std::memory_order_relaxed)};
+  while (!slabs_.compare_exchange_weak(created->next, created, std::memory_order_release,
+                                       std::memory_order_relaxed)) {}
+  capacity_.fetch_add(slab_size_, std::memory_order_relaxed);
+  for (uint32_t i = slab_size_ - 1; i > 0; --i) {
+    if (slots.size() < cache_size_) {
+      slots.emplace_back(&created->slots[i]);
+    } else {
+      depot_.push(&created->slots[i]);
+    }
+  }
+
+  return &created->slots[0];
+}
+
+template <typename type>
+inline void object_pool<type>::recycle(rptr<slot> target) noexcept {
+  auto &slots = local().slots;
+  if (slots.size() >= cache_size_) {
+    /// the oldest half, the latest stay warm in this thread.
+    auto half = slots.size() / 2;
+    for (size_t i = 0; i < half; ++i) {
+      depot_.push(slots[i]);
+    }
+    slots.erase(slots.begin(), slots.begin() + static_cast<std::ptrdiff_t>(half));
+  }
+  slots.emplace_back(target);
+}
+
+template <typename type>
+inline std::vector<typename object_pool<type>::cache> &object_pool<type>::caches() noexcept {
+  static thread_local std::vector<cache> owned;
+
+  return owned;
+}
+
+template <typename type>
+inline typename object_pool<type>::cache &object_pool<type>::local() noexcept {
+  auto &owned = caches();
+  for (auto &target : owned) {
+    if (target.owner == id_) {
+
+      return target;
+    }
+  }
+
+  /// the caches of pools destroyed are dropped by the thread missed.
+  owned.erase(std::remove_if(owned.begin(), owned.end(), [](auto &target) { return target.alive.expired(); }),
+              owned.end());
+  owned.emplace_back(cache{id_, alive_, {}});
+  owned.back().slots.reserve(cache_size_);
+
+  return owned.back();
+}
+
+} // namespace core
+
+} // namespace esim
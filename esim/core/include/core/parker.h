@@ -0,0 +1,100 @@
+#ifndef __ESIM_CORE_CORE_PARKER_H_
+#define __ESIM_CORE_CORE_PARKER_H_
+
+#include "utils.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if !defined(__linux__)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief Parks the waiting threads until notified, spinning briefly before
+ * sleeping in kernel. Notifying costs no syscall if nobody parked.
+ *
+ * The waiters register before checking the condition again, so a notify
+ * after the condition made true never gets lost:
+ *
+ *   producer: make ready, then notify.
+ *   consumer: park_until([] { return ready; }).
+ *
+ * @note futex on linux, condition variable elsewhere.
+ */
+class parker {
+public:
+  /**
+   * @brief Spin then park until the predicate is satisfied.
+   *
+   * @param ready specifies the predicate, checked after every wake up.
+   */
+  template <typename predicate_type>
+  void park_until(predicate_type &&ready) noexcept;
+
+  /**
+   * @brief Spin then park until the predicate is satisfied or timeout.
+   *
+   * @param ready specifies the predicate, checked after every wake up.
+   * @param timeout specifies the max duration to wait.
+   * @return true if satisfied, false if timeout.
+   */
+  template <typename predicate_type, typename rep_type, typename period_type>
+  bool park_until_for(predicate_type &&ready,
+                      std::chrono::duration<rep_type, period_type> timeout) noexcept;
+
+  /**
+   * @brief Wake up a parked thread, if any.
+   *
+   */
+  void notify_one() noexcept;
+
+  /**
+   * @brief Wake up all parked threads, if any.
+   *
+   */
+  void notify_all() noexcept;
+
+  parker() noexcept;
+
+  ~parker() = default;
+
+  parker(const parker &) = delete;
+
+  parker &operator=(const parker &) = delete;
+
+private:
+  /// registers the waiter, the epoch is compared when parking.
+  uint32_t prepare() noexcept;
+
+  void cancel() noexcept;
+
+  /// checks the waiters without touching the epoch, no shared write if nobody parked.
+  bool parked() const noexcept;
+
+  /// sleeps unless notified since the epoch, or the timeout in nanoseconds elapsed.
+  void wait(uint32_t epoch, int64_t timeout_ns) noexcept;
+
+  void wake(bool all) noexcept;
+
+private:
+  std::atomic<uint32_t> epoch_;
+  std::atomic<uint32_t> waiters_;
+#if !defined(__linux__)
+  std::mutex              mutex_;
+  std::condition_variable cond_;
+#endif
+};
+
+} // namespace core
+
+} // namespace esim
+
+#include "parker.inl"
+
+#endif
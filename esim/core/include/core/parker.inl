@@ -0,0 +1,98 @@
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace esim {
+
+namespace core {
+
+namespace details {
+
+/// spins before parking, covers the handover of a busy peer.
+constexpr static uint32_t parker_spin_limit = 128;
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+} // namespace details
+
+inline void parker::notify_one() noexcept {
+  if (parked()) {
+    wake(false);
+  }
+}
+
+inline void parker::notify_all() noexcept {
+  if (parked()) {
+    wake(true);
+  }
+}
+
+inline bool parker::parked() const noexcept {
+  /// pairs with the fence of prepare, a waiter registered after this load
+  /// checks the predicate again and sees the state made ready before.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  return 0 != waiters_.load(std::memory_order_relaxed);
+}
+
+template <typename predicate_type>
+inline void parker::park_until(predicate_type &&ready) noexcept {
+  for (uint32_t i = 0; i < details::parker_spin_limit; ++i) {
+    if (ready()) {
+
+      return;
+    }
+    details::cpu_relax();
+  }
+
+  while (!ready()) {
+    auto epoch = prepare();
+    if (ready()) {
+      cancel();
+
+      return;
+    }
+    wait(epoch, -1);
+  }
+}
+
+template <typename predicate_type, typename rep_type, typename period_type>
+inline bool parker::park_until_for(predicate_type &&ready,
+                                   std::chrono::duration<rep_type, period_type> timeout) noexcept {
+  using namespace std::chrono;
+  for (uint32_t i = 0; i < details::parker_spin_limit; ++i) {
+    if (ready()) {
+
+      return true;
+    }
+    details::cpu_relax();
+  }
+
+  auto deadline = steady_clock::now() + timeout;
+  while (!ready()) {
+    auto remaining = duration_cast<nanoseconds>(deadline - steady_clock::now()).count();
+    if (remaining <= 0) {
+
+      return false;
+    }
+    auto epoch = prepare();
+    if (ready()) {
+      cancel();
+
+      return true;
+    }
+    wait(epoch, remaining);
+  }
+
+  return true;
+}
+
+} // namespace core
+
+} // namespace esim
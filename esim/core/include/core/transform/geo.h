@@ -21,6 +21,17 @@ struct maptile {
   uint32_t x, y;
 };
 
+/// found by ADL, so std::equal_to and flat_map compare maptiles.
+inline bool operator==(const maptile &lhs, const maptile &rhs) noexcept {
+  return lhs.lod == rhs.lod &&
+         lhs.x == rhs.x &&
+         lhs.y == rhs.y;
+}
+
+inline bool operator!=(const maptile &lhs, const maptile &rhs) noexcept {
+  return !(lhs == rhs);
+}
+
 /**
  * @brief World Geodetic System 1984 detilas.
  * 
@@ -62,6 +73,24 @@ template <typename type = double>
 glm::vec<3, type> &maptile_to_geo(const glm::vec<3, type> &mt,
                                   glm::vec<3, type> &out) noexcept;
 
+/**
+ * @brief Interleave the row and column of maptile as morton code.
+ * 
+ * @param tile specifies the target maptile.
+ * @return the morton code, y in even bits and x in odd bits.
+ */
+inline uint64_t maptile_to_morton(const maptile &tile) noexcept;
+
+/**
+ * @brief Convert geodetic coordinate to the maptile containing it.
+ * 
+ * @param geo specifies the latitude and longitude in degrees.
+ * @param lod specifies the level of detail.
+ * @return the maptile, clamped to the mercator bounds.
+ */
+template <typename type = double>
+maptile geo_to_maptile(const glm::vec<2, type> &geo, uint8_t lod) noexcept;
+
 /**
  * @brief Trnasform position from geodetic to ECEF
  * 
@@ -94,18 +123,16 @@ template<>
 struct hash<esim::geo::maptile> {
 public:
   inline std::size_t operator()(const esim::geo::maptile &tile) const noexcept {
-    std::size_t hash = (tile.x << 31) + tile.y;
+    /// splitmix64 finalizer over the morton code salted by lod.
+    uint64_t hash = esim::geo::maptile_to_morton(tile) ^
+                    (static_cast<uint64_t>(tile.lod) * 0x9E3779B97F4A7C15ULL);
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
 
-    return hash;
+    return static_cast<std::size_t>(hash ^ (hash >> 31));
   }
 };
 
-inline bool operator==(const esim::geo::maptile &lhs, const esim::geo::maptile &rhs) noexcept {
-  return lhs.lod == rhs.lod &&
-         lhs.x == rhs.x &&
-         lhs.y == rhs.y;
-}
-
 inline ostream &operator<<(ostream& os, const esim::geo::maptile &rhs) noexcept {
 
   return os << "(LOD: " << static_cast<int>(rhs.lod) << ", x: " << rhs.x << ", y: " << rhs.y << ")";
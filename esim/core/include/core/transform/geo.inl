@@ -14,6 +14,41 @@ inline glm::vec<3, type> &maptile_to_geo(const glm::vec<3, type> &mt,
   return out;
 }
 
+namespace details {
+
+inline uint64_t morton_spread(uint32_t value) noexcept {
+  uint64_t v = value;
+  v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+  v = (v | (v << 8))  & 0x00FF00FF00FF00FFULL;
+  v = (v | (v << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+  v = (v | (v << 2))  & 0x3333333333333333ULL;
+  v = (v | (v << 1))  & 0x5555555555555555ULL;
+
+  return v;
+}
+
+} // namespace details
+
+inline uint64_t maptile_to_morton(const maptile &tile) noexcept {
+
+  return (details::morton_spread(tile.x) << 1) | details::morton_spread(tile.y);
+}
+
+template <typename type>
+inline maptile geo_to_maptile(const glm::vec<2, type> &geo, uint8_t lod) noexcept {
+  using namespace glm;
+  const static type max_lat = static_cast<type>(85.05112877980659);
+  const uint32_t last = (1u << lod) - 1;
+  type LOD = static_cast<type>(1u << lod);
+  type lat = clamp(geo.x, -max_lat, max_lat) * pi<type>() / 180.0;
+  type row = (1.0 - log(tan(lat) + 1.0 / cos(lat)) / pi<type>()) * 0.5 * LOD;
+  type col = (geo.y + 180.0) / 360.0 * LOD;
+
+  return maptile{lod,
+                 glm::min(static_cast<uint32_t>(glm::max(row, type(0))), last),
+                 glm::min(static_cast<uint32_t>(glm::max(col, type(0))), last)};
+}
+
 template <typename type, typename geosys>
 inline glm::vec<3, type> &geo_to_ecef(const glm::vec<3, type> &geo,
                                       glm::vec<3, type> &ecef) noexcept {
@@ -0,0 +1,115 @@
+#ifndef __ESIM_CORE_CORE_TRIPLE_BUFFER_H_
+#define __ESIM_CORE_CORE_TRIPLE_BUFFER_H_
+
+#include "parker.h"
+#include "utils.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief Lock-free mailbox keeping the latest value only, the older values
+ * unread are overwritten rather than queued.
+ *
+ * Three buffers rotate between the writer, the reader and the middle one
+ * published; a handover swaps the index of the middle buffer, flagged dirty
+ * until the reader acquires it:
+ *
+ *   writer: write_buffer() = value, then publish().
+ *   reader: if (acquire()) use read_buffer().
+ *
+ * @tparam type specifies the target type of content.
+ * @note single writer single reader, serialize the writers otherwise.
+ */
+template <typename type>
+class triple_buffer {
+public:
+  /**
+   * @brief Get the buffer owned by the writer, unseen by the reader until published.
+   *
+   * @return reference of the writer buffer.
+   */
+  type &write_buffer() noexcept;
+
+  /**
+   * @brief Publish the writer buffer as the latest value, the writer takes
+   * over the middle buffer in turn.
+   *
+   */
+  void publish() noexcept;
+
+  /**
+   * @brief Assign the writer buffer and publish it.
+   *
+   * @tparam r_type specifies the type of value, must be assignable to 'type'.
+   * @param value specifies the latest value.
+   */
+  template <typename r_type>
+  void publish(r_type &&value) noexcept;
+
+  /**
+   * @brief Take over the latest value published, if any.
+   *
+   * @return true if a newer value is in read buffer, false otherwise.
+   */
+  bool acquire() noexcept;
+
+  /**
+   * @brief Take over the latest value published, park until published or timeout.
+   *
+   * @param timeout specifies the max duration to wait.
+   * @return true if a newer value is in read buffer, false if timeout.
+   */
+  template <typename rep_type, typename period_type>
+  bool acquire_for(std::chrono::duration<rep_type, period_type> timeout) noexcept;
+
+  /**
+   * @brief Get the buffer owned by the reader, valid until the next acquire.
+   *
+   * @return reference of the reader buffer.
+   */
+  type &read_buffer() noexcept;
+
+  /**
+   * @brief Check if a value published is not acquired yet.
+   *
+   * @return true if dirty, false otherwise.
+   */
+  bool dirty() const noexcept;
+
+  /**
+   * @brief Construct a new triple buffer object
+   *
+   * @param value specifies the initial value of all buffers.
+   */
+  explicit triple_buffer(const type &value = type{}) noexcept;
+
+  ~triple_buffer() = default;
+
+  triple_buffer(const triple_buffer &) = delete;
+
+  triple_buffer &operator=(const triple_buffer &) = delete;
+
+private:
+  std::array<type, 3>                 buffers_;
+  /// index of the middle buffer, with the dirty bit.
+  alignas(128UL) std::atomic<uint8_t> middle_;
+  /// owned by the writer and the reader respectively.
+  alignas(128UL) uint8_t              write_;
+  alignas(128UL) uint8_t              read_;
+  /// reader waiting for a value published.
+  parker                              published_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#include "triple_buffer.inl"
+
+#endif
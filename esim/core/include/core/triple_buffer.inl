@@ -0,0 +1,76 @@
+namespace esim {
+
+namespace core {
+
+namespace details {
+
+constexpr static uint8_t triple_buffer_dirty = 0x4;
+constexpr static uint8_t triple_buffer_index = 0x3;
+
+} // namespace details
+
+template <typename type>
+inline type &triple_buffer<type>::write_buffer() noexcept {
+
+  return buffers_[write_];
+}
+
+template <typename type>
+inline void triple_buffer<type>::publish() noexcept {
+  /// releases the writes of the buffer, acquires the one the reader gave back.
+  auto middle = middle_.exchange(write_ | details::triple_buffer_dirty, std::memory_order_acq_rel);
+  write_ = middle & details::triple_buffer_index;
+  published_.notify_one();
+}
+
+template <typename type>
+template <typename r_type>
+inline void triple_buffer<type>::publish(r_type &&value) noexcept {
+  write_buffer() = std::forward<r_type>(value);
+  publish();
+}
+
+template <typename type>
+inline bool triple_buffer<type>::acquire() noexcept {
+  if (!dirty()) {
+
+    return false;
+  }
+
+  /// only the writer sets the dirty bit, the buffer swapped in is the latest.
+  auto middle = middle_.exchange(read_, std::memory_order_acq_rel);
+  read_ = middle & details::triple_buffer_index;
+
+  return true;
+}
+
+template <typename type>
+template <typename rep_type, typename period_type>
+inline bool triple_buffer<type>::acquire_for(std::chrono::duration<rep_type, period_type> timeout) noexcept {
+  if (!published_.park_until_for([this]() { return dirty(); }, timeout)) {
+
+    return false;
+  }
+
+  return acquire();
+}
+
+template <typename type>
+inline type &triple_buffer<type>::read_buffer() noexcept {
+
+  return buffers_[read_];
+}
+
+template <typename type>
+inline bool triple_buffer<type>::dirty() const noexcept {
+
+  return 0 != (middle_.load(std::memory_order_acquire) & details::triple_buffer_dirty);
+}
+
+template <typename type>
+inline triple_buffer<type>::triple_buffer(const type &value) noexcept
+    : buffers_{value, value, value}, middle_{0}, write_{1}, read_{2} {}
+
+} // namespace core
+
+} // namespace esim
@@ -0,0 +1,160 @@
+#ifndef __ESIM_CORE_CORE_UNBOUNDED_QUEUE_H_
+#define __ESIM_CORE_CORE_UNBOUNDED_QUEUE_H_
+
+#include "mpmc_queue.h"
+#include "parker.h"
+#include "utils.h"
+#include <atomic>
+#include <chrono>
+#include <new>
+
+namespace esim {
+
+namespace core {
+
+/**
+ * @brief Thread-safety unbounded First-In-First-Out queue, the values are stored
+ * inline in fixed size segments linked one after another.
+ *
+ * Producers and consumers claim a slot of the tail or head segment by
+ * fetch-and-add, a consumer overtaking a producer on the same slot poisons
+ * it and the producer claims another one. A new segment is linked once the
+ * tail one is exhausted, so pushing never blocks and never fails.
+ *
+ * The segments passed by the consumers are retired, and recycled into a
+ * bounded pool once no operation is in flight, the memory of a burst is
+ * reused by the next one rather than freed.
+ *
+ * @tparam type specifies the target type of content.
+ * @note multiple producer multiple consumer supported.
+ */
+template <typename type>
+class unbounded_queue {
+public:
+  /**
+   * @brief Pop the first item from the queue, park until pushed.
+   *
+   * @tparam l_type specifies the return type, must be convertible from 'type'.
+   * @param ref specifies the reference to receive.
+   */
+  template <typename l_type>
+  void pop(l_type &ref) noexcept;
+
+  /**
+   * @brief Try to pop the first item from the queue
+   *
+   * @tparam l_type specifies the return type, must be convertible from 'type'.
+   * @param ref specifies the reference to receive.
+   * @return true if operates successful, false otherwise.
+   */
+  template <typename l_type>
+  bool try_pop(l_type &ref) noexcept;
+
+  /**
+   * @brief Try to pop the first item from the queue, park until pushed or timeout
+   *
+   * @tparam l_type specifies the return type, must be convertible from 'type'.
+   * @param ref specifies the reference to receive.
+   * @param timeout specifies the max duration to wait.
+   * @return true if operates successful, false if timeout.
+   */
+  template <typename l_type, typename rep_type, typename period_type>
+  bool try_pop_for(l_type &ref, std::chrono::duration<rep_type, period_type> timeout) noexcept;
+
+  /**
+   * @brief Push the item into the queue, never blocks.
+   *
+   * @tparam r_type specifies the type of target item. must be convertible to 'type'.
+   * @param ref specifies the target item.
+   */
+  template <typename r_type>
+  void push(r_type &&ref) noexcept;
+
+  /**
+   * @brief Construct the item directly into the queue, never blocks.
+   *
+   * @param ref specifies the arguments of consturctor.
+   */
+  template <typename... types>
+  void emplace(types &&...ref) noexcept;
+
+  /**
+   * @brief Check if the queue is empty
+   *
+   * @return true if queue is empty, false otherwise.
+   */
+  bool empty() const noexcept;
+
+  /**
+   * @brief Construct a new unbounded queue object
+   *
+   * @param segment_size specifies the count of slots per segment.
+   * @param pool_size specifies the max count of segments kept for reuse, at least 2.
+   */
+  explicit unbounded_queue(uint32_t segment_size = 256, uint32_t pool_size = 16) noexcept;
+
+  ~unbounded_queue() noexcept;
+
+  unbounded_queue(const unbounded_queue &) = delete;
+
+  unbounded_queue &operator=(const unbounded_queue &) = delete;
+
+private:
+  enum class slot_state : uint8_t {
+    empty,
+    writing,
+    ready,
+    taken, ///< consumed, or poisoned by a consumer ahead of the producer.
+  };
+
+  struct slot {
+    std::atomic<slot_state> state;
+    alignas(type) unsigned char storage[sizeof(type)];
+
+    rptr<type> data() noexcept;
+  };
+
+  struct segment {
+    alignas(128UL) std::atomic<uint32_t> enqueue;
+    alignas(128UL) std::atomic<uint32_t> dequeue;
+    std::atomic<rptr<segment>>           next;
+    rptr<segment>                        retired_next;
+    uptr<slot[]>                         slots;
+
+    explicit segment(uint32_t size) noexcept;
+  };
+
+  /// the segments are only touched between enter and leave.
+  void enter() const noexcept;
+
+  void leave() const noexcept;
+
+  rptr<segment> acquire_segment() noexcept;
+
+  void retire(rptr<segment> first, rptr<segment> last) const noexcept;
+
+  /// recycles the retired segments if no operation is in flight, keeps them otherwise.
+  void reclaim() const noexcept;
+
+  template <typename l_type>
+  bool dequeue(l_type &ref) noexcept;
+
+private:
+  const uint32_t                               segment_size_;
+  alignas(128UL) std::atomic<rptr<segment>>    head_;
+  alignas(128UL) std::atomic<rptr<segment>>    tail_;
+  /// operations in flight, and segments passed waiting for them to leave.
+  alignas(128UL) mutable std::atomic<uint32_t> active_;
+  mutable std::atomic<rptr<segment>>           retired_;
+  mutable mpmc_queue<rptr<segment>>            pool_;
+  /// consumers waiting for items.
+  parker                                       readable_;
+};
+
+} // namespace core
+
+} // namespace esim
+
+#include "unbounded_queue.inl"
+
+#endif
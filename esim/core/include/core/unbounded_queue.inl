@@ -0,0 +1,268 @@
+#include <algorithm>
+
+namespace esim {
+
+namespace core {
+
+template <typename type>
+inline rptr<type> unbounded_queue<type>::slot::data() noexcept {
+
+  return std::launder(reinterpret_cast<rptr<type>>(storage));
+}
+
+template <typename type>
+inline unbounded_queue<type>::segment::segment(uint32_t size) noexcept
+    : enqueue{0}, dequeue{0}, next{nullptr}, retired_next{nullptr},
+      slots{make_uptr<slot[]>(size)} {
+  for (uint32_t i = 0; i < size; ++i) {
+    slots[i].state.store(slot_state::empty, std::memory_order_relaxed);
+  }
+}
+
+template <typename type>
+template <typename l_type>
+inline void unbounded_queue<type>::pop(l_type &ref) noexcept {
+  static_assert(std::is_convertible_v<type, l_type>);
+  readable_.park_until([&]() { return dequeue(ref); });
+}
+
+template <typename type>
+template <typename l_type>
+inline bool unbounded_queue<type>::try_pop(l_type &ref) noexcept {
+  static_assert(std::is_convertible_v<type, l_type>);
+
+  return dequeue(ref);
+}
+
+template <typename type>
+template <typename l_type, typename rep_type, typename period_type>
+inline bool unbounded_queue<type>::try_pop_for(l_type &ref,
+                                               std::chrono::duration<rep_type, period_type> timeout) noexcept {
+  static_assert(std::is_convertible_v<type, l_type>);
+
+  return readable_.park_until_for([&]() { return dequeue(ref); }, timeout);
+}
+
+template <typename type>
+template <typename r_type>
+inline void unbounded_queue<type>::push(r_type &&ref) noexcept {
+  static_assert(std::is_convertible_v<r_type, type>);
+  emplace(std::forward<r_type>(ref));
+}
+
+template <typename type>
+template <typename... types>
+inline void unbounded_queue<type>::emplace(types &&...ref) noexcept {
+  enter();
+  for (;;) {
+    auto tail = tail_.load();
+    auto index = tail->enqueue.fetch_add(1, std::memory_order_acq_rel);
+    if (index < segment_size_) {
+      auto &target = tail->slots[index];
+      auto expected = slot_state::empty;
+      if (target.state.compare_exchange_strong(expected, slot_state::writing, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+        new (target.storage) type(std::forward<types>(ref)...);
+        target.state.store(slot_state::ready, std::memory_order_release);
+        break;
+      }
+
+      /// poisoned by a consumer ahead, claims the next slot.
+      continue;
+    }
+
+    /// the tail segment exhausted, links a new one or helps the one linked.
+    auto next = tail->next.load(std::memory_order_acquire);
+    if (nullptr == next) {
+      auto created = acquire_segment();
+      if (tail->next.compare_exchange_strong(next, created, std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+        tail_.compare_exchange_strong(tail, created);
+        continue;
+      }
+      /// never published, linked by another producer first.
+      if (!pool_.try_push(created)) {
+        delete created;
+      }
+    }
+    tail_.compare_exchange_strong(tail, next);
+  }
+  leave();
+
+  readable_.notify_one();
+}
+
+template <typename type>
+inline bool unbounded_queue<type>::empty() const noexcept {
+  enter();
+  auto head = head_.load();
+  bool result = head->dequeue.load(std::memory_order_acquire) >=
+                    std::min(head->enqueue.load(std::memory_order_acquire), segment_size_) &&
+                nullptr == head->next.load(std::memory_order_acquire);
+  leave();
+
+  return result;
+}
+
+template <typename type>
+inline unbounded_queue<type>::unbounded_queue(uint32_t segment_size, uint32_t pool_size) noexcept
+    : segment_size_{segment_size},
+      head_{nullptr}, tail_{nullptr},
+      active_{0}, retired_{nullptr}, pool_{pool_size} {
+  assert(segment_size_ > 0);
+  auto first = new segment{segment_size_};
+  head_.store(first);
+  tail_.store(first);
+}
+
+template <typename type>
+inline unbounded_queue<type>::~unbounded_queue() noexcept {
+  /// no operation in flight, the items left are those ready.
+  for (auto target = head_.load(); nullptr != target;) {
+    for (uint32_t i = 0; i < segment_size_; ++i) {
+      if (slot_state::ready == target->slots[i].state.load(std::memory_order_acquire)) {
+        target->slots[i].data()->~type();
+      }
+    }
+    auto next = target->next.load(std::memory_order_acquire);
+    delete target;
+    target = next;
+  }
+
+  for (auto target = retired_.load(); nullptr != target;) {
+    auto next = target->retired_next;
+    delete target;
+    target = next;
+  }
+
+  rptr<segment> target;
+  while (pool_.try_pop(target)) {
+    delete target;
+  }
+}
+
+template <typename type>
+inline void unbounded_queue<type>::enter() const noexcept {
+  /// seq_cst along with the loads of head and tail, a reclaimer missing
+  /// this increment is ordered before them and its segments unreachable.
+  active_.fetch_add(1);
+}
+
+template <typename type>
+inline void unbounded_queue<type>::leave() const noexcept {
+  if (1 == active_.fetch_sub(1) && nullptr != retired_.load(std::memory_order_acquire)) {
+    reclaim();
+  }
+}
+
+template <typename type>
+inline rptr<typename unbounded_queue<type>::segment> unbounded_queue<type>::acquire_segment() noexcept {
+  rptr<segment> target = nullptr;
+  if (!pool_.try_pop(target)) {
+
+    return new segment{segment_size_};
+  }
+
+  /// unreachable since retired, published by linking.
+  target->enqueue.store(0, std::memory_order_relaxed);
+  target->dequeue.store(0, std::memory_order_relaxed);
+  target->next.store(nullptr, std::memory_order_relaxed);
+  target->retired_next = nullptr;
+  for (uint32_t i = 0; i < segment_size_; ++i) {
+    target->slots[i].state.store(slot_state::empty, std::memory_order_relaxed);
+  }
+
+  return target;
+}
+
+template <typename type>
+inline void unbounded_queue<type>::retire(rptr<segment> first, rptr<segment> last) const noexcept {
+  auto top = retired_.load(std::memory_order_relaxed);
+  do {
+    last->retired_next = top;
+  } while (!retired_.compare_exchange_weak(top, first, std::memory_order_release, std::memory_order_relaxed));
+}
+
+template <typename type>
+inline void unbounded_queue<type>::reclaim() const noexcept {
+  auto first = retired_.exchange(nullptr);
+  if (nullptr == first) {
+
+    return;
+  }
+
+  /// an operation entered meanwhile may still hold any of them.
+  if (0 != active_.load()) {
+    auto last = first;
+    while (nullptr != last->retired_next) {
+      last = last->retired_next;
+    }
+    retire(first, last);
+
+    return;
+  }
+
+  while (nullptr != first) {
+    auto next = first->retired_next;
+    if (!pool_.try_push(first)) {
+      delete first;
+    }
+    first = next;
+  }
+}
+
+template <typename type>
+template <typename l_type>
+inline bool unbounded_queue<type>::dequeue(l_type &ref) noexcept {
+  bool popped = false;
+
+  enter();
+  for (;;) {
+    auto head = head_.load();
+    if (head->dequeue.load(std::memory_order_acquire) >=
+            std::min(head->enqueue.load(std::memory_order_acquire), segment_size_) &&
+        nullptr == head->next.load(std::memory_order_acquire)) {
+      break;
+    }
+
+    auto index = head->dequeue.fetch_add(1, std::memory_order_acq_rel);
+    if (index < segment_size_) {
+      auto &target = head->slots[index];
+      auto expected = slot_state::empty;
+      if (target.state.compare_exchange_strong(expected, slot_state::taken, std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+        /// ahead of the producer, poisoned and skipped.
+        continue;
+      }
+
+      /// claimed by a producer, ready once constructed.
+      while (slot_state::ready != target.state.load(std::memory_order_acquire)) {
+        details::cpu_relax();
+      }
+      auto data = target.data();
+      ref = std::move(*data);
+      data->~type();
+      target.state.store(slot_state::taken, std::memory_order_relaxed);
+      popped = true;
+      break;
+    }
+
+    auto next = head->next.load(std::memory_order_acquire);
+    if (nullptr == next) {
+      break;
+    }
+    /// the tail passes the segment before the head, unreachable once unlinked.
+    auto tail = head;
+    tail_.compare_exchange_strong(tail, next);
+    if (head_.compare_exchange_strong(head, next)) {
+      retire(head, head);
+    }
+  }
+  leave();
+
+  return popped;
+}
+
+} // namespace core
+
+} // namespace esim
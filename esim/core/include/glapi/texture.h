@@ -2,6 +2,8 @@
 #define __ESIM_CORE_GLAPI_TEXTURE_H_
 
 #include "core/bitmap.h"
+#include "core/compressed_bitmap.h"
+#include "core/image_ops.h"
 #include <cassert>
 #include <glad/glad.h>
 #include <glm/vec2.hpp>
@@ -56,6 +58,24 @@ public:
    */
   bool load(const core::bitmap &bm, size_t idx = 0, options opt = options{}) noexcept;
 
+  /**
+   * @brief Load a texture with its prebuilt mip chain from a compressed bitmap.
+   * 
+   * @param cbm specifies the target compressed bitmap.
+   * @param idx specifies the index of texture.
+   * @param opt specifies the texture details.
+   */
+  bool load(const core::compressed_bitmap &cbm, size_t idx = 0, options opt = options{}) noexcept;
+
+  /**
+   * @brief Load a texture with its prebuilt rgba mip chain, no mipmap generated by driver.
+   * 
+   * @param chain specifies the target mip chain.
+   * @param idx specifies the index of texture.
+   * @param opt specifies the texture details.
+   */
+  bool load(const core::mip_chain &chain, size_t idx = 0, options opt = options{}) noexcept;
+
   /**
    * @brief Obtain the resolution of texture.
    * 
@@ -43,6 +43,55 @@ inline bool texture::load(const core::bitmap &bm, size_t idx, options opt) noexc
   return true;
 }
 
+inline bool texture::load(const core::compressed_bitmap &cbm, size_t idx, options opt) noexcept {
+  assert(idx < ids_.size());
+  auto &levels = cbm.levels();
+  if (levels.empty()) {
+
+    return false;
+  }
+
+  resolution_[idx] = glm::ivec2{cbm.width(), cbm.height()};
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, ids_[idx]);
+  for (size_t i = 0; i < levels.size(); ++i) {
+    glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+                           levels[i].width, levels[i].height, 0,
+                           static_cast<GLsizei>(levels[i].size), cbm.buffer() + levels[i].offset);
+  }
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size() - 1));
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, opt.wrap_s);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, opt.wrap_t);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, opt.min_filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, opt.mag_filter);
+
+  return true;
+}
+
+inline bool texture::load(const core::mip_chain &chain, size_t idx, options opt) noexcept {
+  assert(idx < ids_.size());
+  auto &levels = chain.levels;
+  if (levels.empty() || 4 != chain.channel) {
+
+    return false;
+  }
+
+  resolution_[idx] = glm::ivec2{levels.front().width, levels.front().height};
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, ids_[idx]);
+  for (size_t i = 0; i < levels.size(); ++i) {
+    glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), GL_RGBA, levels[i].width, levels[i].height, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, chain.data.data() + levels[i].offset);
+  }
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size() - 1));
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, opt.wrap_s);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, opt.wrap_t);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, opt.min_filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, opt.mag_filter);
+
+  return true;
+}
+
 inline glm::ivec2 texture::resolution(size_t idx) const noexcept {
   assert(idx < ids_.size());
 
@@ -0,0 +1,107 @@
+#ifndef __ESIM_CORE_GLAPI_TEXTURE_ARRAY_H_
+#define __ESIM_CORE_GLAPI_TEXTURE_ARRAY_H_
+
+#include "core/compressed_bitmap.h"
+#include "core/image_ops.h"
+#include <algorithm>
+#include <cassert>
+#include <glad/glad.h>
+
+namespace esim {
+
+namespace gl {
+
+/**
+ * @brief Encapsulated OpenGL 2d array texture with immutable storage,
+ * all layers share the same resolution, format and mip levels.
+ *
+ */
+class texture_array {
+public:
+  /**
+   * @brief Bind the texture array.
+   *
+   * @param location specifies the location to bind.
+   */
+  void bind(GLuint location = 0) const noexcept;
+
+  /**
+   * @brief Store a compressed bitmap with its prebuilt mip chain into the layer.
+   *
+   * @param layer specifies the target layer.
+   * @param cbm specifies the compressed bitmap, must match the resolution and format.
+   * @return true if stored successfully, false otherwise.
+   */
+  bool store(size_t layer, const core::compressed_bitmap &cbm) noexcept;
+
+  /**
+   * @brief Store a rgba mip chain into the layer.
+   *
+   * @param layer specifies the target layer.
+   * @param chain specifies the mip chain, must match the resolution and format.
+   * @return true if stored successfully, false otherwise.
+   */
+  bool store(size_t layer, const core::mip_chain &chain) noexcept;
+
+  size_t layers() const noexcept;
+
+  int size() const noexcept;
+
+  bool is_compressed() const noexcept;
+
+  /**
+   * @brief Obtain the bytes of a single layer including its mip levels.
+   *
+   * @return the bytes of layer.
+   */
+  size_t layer_bytes() const noexcept;
+
+  /**
+   * @brief Obtain the bytes of a single layer including its mip levels.
+   *
+   * @param size specifies the width and height of layers.
+   * @param compressed specifies whether stored in BC1 or RGBA8.
+   * @return the bytes of layer.
+   */
+  static size_t layer_bytes(int size, bool compressed) noexcept;
+
+  /**
+   * @brief Obtain the max count of layers supported by the driver.
+   *
+   * @return the count of layers.
+   */
+  static size_t max_layers() noexcept;
+
+  /**
+   * @brief Construct a new texture array object.
+   *
+   * @param size specifies the width and height of layers, power of two.
+   * @param layers specifies the count of layers.
+   * @param compressed specifies whether stored in BC1 or RGBA8.
+   */
+  texture_array(int size, size_t layers, bool compressed) noexcept;
+
+  /**
+   * @brief Destroy the texture array object.
+   *
+   */
+  ~texture_array() noexcept;
+
+  texture_array(const texture_array &) = delete;
+
+  texture_array &operator=(const texture_array &) = delete;
+
+private:
+  GLuint id_;
+  int    size_, levels_;
+  size_t layers_;
+  bool   compressed_;
+};
+
+} // namespace gl
+
+} // namespace esim
+
+#include "texture_array.inl"
+
+#endif
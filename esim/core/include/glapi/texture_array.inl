@@ -0,0 +1,112 @@
+namespace esim {
+
+namespace gl {
+
+inline void texture_array::bind(GLuint location) const noexcept {
+  glActiveTexture(GL_TEXTURE0 + location);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, id_);
+}
+
+inline bool texture_array::store(size_t layer, const core::compressed_bitmap &cbm) noexcept {
+  assert(layer < layers_);
+  auto &levels = cbm.levels();
+  if (!compressed_ || cbm.width() != size_ || cbm.height() != size_ ||
+      levels.size() != static_cast<size_t>(levels_)) {
+
+    return false;
+  }
+
+  glBindTexture(GL_TEXTURE_2D_ARRAY, id_);
+  for (size_t i = 0; i < levels.size(); ++i) {
+    glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(i), 0, 0, static_cast<GLint>(layer),
+                              levels[i].width, levels[i].height, 1, GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+                              static_cast<GLsizei>(levels[i].size), cbm.buffer() + levels[i].offset);
+  }
+
+  return true;
+}
+
+inline bool texture_array::store(size_t layer, const core::mip_chain &chain) noexcept {
+  assert(layer < layers_);
+  auto &levels = chain.levels;
+  if (compressed_ || 4 != chain.channel || levels.size() != static_cast<size_t>(levels_) ||
+      levels.front().width != size_ || levels.front().height != size_) {
+
+    return false;
+  }
+
+  glBindTexture(GL_TEXTURE_2D_ARRAY, id_);
+  for (size_t i = 0; i < levels.size(); ++i) {
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(i), 0, 0, static_cast<GLint>(layer),
+                    levels[i].width, levels[i].height, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                    chain.data.data() + levels[i].offset);
+  }
+
+  return true;
+}
+
+inline size_t texture_array::layers() const noexcept {
+
+  return layers_;
+}
+
+inline int texture_array::size() const noexcept {
+
+  return size_;
+}
+
+inline bool texture_array::is_compressed() const noexcept {
+
+  return compressed_;
+}
+
+inline size_t texture_array::layer_bytes() const noexcept {
+
+  return layer_bytes(size_, compressed_);
+}
+
+inline size_t texture_array::layer_bytes(int size, bool compressed) noexcept {
+  size_t bytes = 0;
+  for (int s = size; s > 0; s /= 2) {
+    bytes += compressed ? static_cast<size_t>((s + 3) / 4) * ((s + 3) / 4) * 8
+                        : static_cast<size_t>(s) * s * 4;
+  }
+
+  return bytes;
+}
+
+inline size_t texture_array::max_layers() noexcept {
+  GLint layers = 0;
+  glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &layers);
+
+  return static_cast<size_t>(std::max(layers, 0));
+}
+
+inline texture_array::texture_array(int size, size_t layers, bool compressed) noexcept
+    : id_{0}, size_{size}, levels_{1}, layers_{layers}, compressed_{compressed} {
+  assert(size > 0 && layers > 0);
+  while ((size >> levels_) > 0) {
+    ++levels_;
+  }
+
+  glGenTextures(1, &id_);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, id_);
+  glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels_,
+                 compressed ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_RGBA8,
+                 size, size, static_cast<GLsizei>(layers));
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+inline texture_array::~texture_array() noexcept {
+  if (0 != id_) {
+    glDeleteTextures(1, &id_);
+    id_ = 0;
+  }
+}
+
+} // namespace gl
+
+} // namespace esim
@@ -1,9 +1,9 @@
 #include "core/bitmap.h"
+#include "core/image_decoder.h"
 #include <cassert>
+#include <fstream>
 #include <iostream>
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include <string>
 
 namespace esim {
 
@@ -11,9 +11,9 @@ namespace core {
 
 class bitmap::opaque {
 public:
-  int width, height;
-  int channel;
-  uptr<char[]> buffer;
+  int width = 0, height = 0;
+  int channel = 0;
+  buffer_type buffer;
 };
 
 int bitmap::width() const noexcept {
@@ -28,6 +28,20 @@ int bitmap::height() const noexcept {
   return opaque_->height;
 }
 
+int bitmap::channel() const noexcept {
+  assert(opaque_ != nullptr);
+
+  return opaque_->channel;
+}
+
+size_t bitmap::size() const noexcept {
+  assert(opaque_ != nullptr);
+
+  return nullptr == opaque_->buffer
+             ? 0
+             : static_cast<size_t>(opaque_->width) * opaque_->height * opaque_->channel;
+}
+
 const char *bitmap::buffer() const noexcept {
   assert(opaque_ != nullptr);
 
@@ -36,48 +50,60 @@ const char *bitmap::buffer() const noexcept {
 
 bool bitmap::load_from_file(std::string_view file) noexcept {
   assert(opaque_ != nullptr);
-  if (FILE *pfile = fopen(file.data(), "rb"); pfile) {
-    unsigned char *pbuffer = stbi_load_from_file(pfile,
-                                                 &opaque_->width,
-                                                 &opaque_->height,
-                                                 &opaque_->channel,
-                                                 0);
-    if (nullptr != pbuffer) {
-      size_t size = opaque_->width * opaque_->height * opaque_->channel;
-      opaque_->buffer = make_uptr<char[]>(size);
-      std::memcpy(opaque_->buffer.get(), pbuffer, size);
-      stbi_image_free(pbuffer);
-      return true;
-    } else {
-      std::cout << stbi_failure_reason() << std::endl;
-    }
+  std::ifstream f(file.data(), std::ios::binary | std::ios::ate);
+  if (!f.is_open()) {
+
+    return false;
   }
 
-  return false;
+  std::string content(static_cast<size_t>(f.tellg()), '\0');
+  f.seekg(0);
+  if (!f.read(content.data(), content.size())) {
+
+    return false;
+  }
+
+  return load(content.data(), content.size());
 }
 
 bool bitmap::load(const char *buffer, size_t size) noexcept {
+
+  return load(buffer, size, allocator_type{});
+}
+
+bool bitmap::load(const char *buffer, size_t size, const allocator_type &alloc) noexcept {
   assert(opaque_ != nullptr);
+  auto decoder = select_image_decoder(buffer, size);
+  if (nullptr != decoder && decoder->decode(buffer, size, *this, alloc)) {
 
-  unsigned char *pbuffer = stbi_load_from_memory(reinterpret_cast<const unsigned char *>(buffer),
-                                                 size,
-                                                 &opaque_->width,
-                                                 &opaque_->height,
-                                                 &opaque_->channel,
-                                                 0);
-  if (nullptr != pbuffer) {
-    size_t size = opaque_->width * opaque_->height * opaque_->channel;
-    opaque_->buffer = make_uptr<char[]>(size);
-    std::memcpy(opaque_->buffer.get(), pbuffer, size);
-    stbi_image_free(pbuffer);
     return true;
-  } else {
-    std::cout << stbi_failure_reason() << std::endl;
   }
 
+  std::cout << "[x] failed to decode image." << std::endl;
+
   return false;
 }
 
+void bitmap::adopt(int width, int height, int channel, buffer_type buffer) noexcept {
+  assert(opaque_ != nullptr);
+  opaque_->width = width;
+  opaque_->height = height;
+  opaque_->channel = channel;
+  opaque_->buffer = std::move(buffer);
+}
+
+bitmap::buffer_type bitmap::release() noexcept {
+  assert(opaque_ != nullptr);
+  opaque_->width = opaque_->height = opaque_->channel = 0;
+
+  return std::move(opaque_->buffer);
+}
+
+bitmap::buffer_type bitmap::allocate(size_t size) noexcept {
+
+  return buffer_type(new (std::nothrow) char[size], [](char *p) { delete[] p; });
+}
+
 bitmap::bitmap() noexcept : opaque_{make_uptr<opaque>()} {}
 
 bitmap::~bitmap() noexcept {}
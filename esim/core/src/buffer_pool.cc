@@ -0,0 +1,80 @@
+#include "core/buffer_pool.h"
+#include <cassert>
+
+namespace esim {
+
+namespace core {
+
+void buffer_pool::blocks::recycle(char *p) noexcept {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (idle.size() < capacity) {
+      idle.emplace_back(p);
+      return;
+    }
+  }
+  delete[] p;
+}
+
+buffer_pool::blocks::blocks(size_t block_size, size_t capacity) noexcept
+    : block_size{block_size}, capacity{capacity} {
+  idle.reserve(capacity);
+}
+
+buffer_pool::blocks::~blocks() noexcept {
+  for (auto p : idle) {
+    delete[] p;
+  }
+  idle.clear();
+}
+
+bitmap::buffer_type buffer_pool::acquire(size_t size) noexcept {
+  assert(nullptr != blocks_);
+  if (size > blocks_->block_size) {
+
+    return bitmap::allocate(size);
+  }
+
+  char *p = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(blocks_->mutex);
+    if (!blocks_->idle.empty()) {
+      p = blocks_->idle.back();
+      blocks_->idle.pop_back();
+    }
+  }
+  if (nullptr == p) {
+    p = new (std::nothrow) char[blocks_->block_size];
+    if (nullptr == p) {
+
+      return nullptr;
+    }
+  }
+
+  return bitmap::buffer_type(p, [owner = blocks_](char *p) { owner->recycle(p); });
+}
+
+bitmap::allocator_type buffer_pool::allocator() noexcept {
+
+  return [this](size_t size) { return acquire(size); };
+}
+
+size_t buffer_pool::block_size() const noexcept {
+
+  return blocks_->block_size;
+}
+
+size_t buffer_pool::available() const noexcept {
+  std::lock_guard<std::mutex> lock(blocks_->mutex);
+
+  return blocks_->idle.size();
+}
+
+buffer_pool::buffer_pool(size_t block_size, size_t capacity) noexcept
+    : blocks_{make_sptr<blocks>(block_size, capacity)} {}
+
+buffer_pool::~buffer_pool() noexcept {}
+
+} // namespace core
+
+} // namespace esim
@@ -0,0 +1,370 @@
+#include "core/compressed_bitmap.h"
+#include "core/image_ops.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace esim {
+
+namespace core {
+
+namespace details {
+
+constexpr static uint32_t dds_magic = 0x20534444;           /// "DDS "
+constexpr static uint32_t dds_fourcc_dxt1 = 0x31545844;     /// "DXT1"
+constexpr static uint32_t dds_flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+constexpr static uint32_t dds_caps = 0x8 | 0x1000 | 0x400000;
+constexpr static uint32_t dds_pixel_fourcc = 0x4;
+
+struct dds_header {
+  uint32_t magic;
+  uint32_t size;
+  uint32_t flags;
+  uint32_t height, width;
+  uint32_t linear_size;
+  uint32_t depth;
+  uint32_t mip_count;
+  uint32_t reserved1[11];
+  struct {
+    uint32_t size, flags, fourcc, rgb_bits;
+    uint32_t r_mask, g_mask, b_mask, a_mask;
+  } format;
+  uint32_t caps, caps2, caps3, caps4;
+  uint32_t reserved2;
+};
+
+static_assert(sizeof(dds_header) == 128);
+
+static size_t bc1_level_size(int width, int height) noexcept {
+
+  return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * 8;
+}
+
+static uint16_t pack565(const int rgb[3]) noexcept {
+
+  return static_cast<uint16_t>(((rgb[0] * 31 + 127) / 255) << 11 |
+                               ((rgb[1] * 63 + 127) / 255) << 5 |
+                               ((rgb[2] * 31 + 127) / 255));
+}
+
+static void unpack565(uint16_t c, int rgb[3]) noexcept {
+  int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+  rgb[0] = (r << 3) | (r >> 2);
+  rgb[1] = (g << 2) | (g >> 4);
+  rgb[2] = (b << 3) | (b >> 2);
+}
+
+/// range fit along the bounding box diagonal, the diagonal is flipped per
+/// channel by its correlation to the widest channel.
+static void encode_bc1_block(const uint8_t block[16][3], uint8_t *out) noexcept {
+  int lo[3] = {255, 255, 255}, hi[3] = {0, 0, 0}, mean[3] = {0, 0, 0};
+  for (int i = 0; i < 16; ++i) {
+    for (int c = 0; c < 3; ++c) {
+      lo[c] = std::min<int>(lo[c], block[i][c]);
+      hi[c] = std::max<int>(hi[c], block[i][c]);
+      mean[c] += block[i][c];
+    }
+  }
+
+  int axis = 0;
+  for (int c = 1; c < 3; ++c) {
+    if (hi[c] - lo[c] > hi[axis] - lo[axis]) {
+      axis = c;
+    }
+  }
+  for (int c = 0; c < 3; ++c) {
+    if (c == axis) {
+      continue;
+    }
+    int cov = 0;
+    for (int i = 0; i < 16; ++i) {
+      cov += (block[i][axis] * 16 - mean[axis]) * (block[i][c] * 16 - mean[c]) / 16;
+    }
+    if (cov < 0) {
+      std::swap(lo[c], hi[c]);
+    }
+  }
+
+  /// inset by 1/16 of the range to reduce the error of quantization.
+  int e0[3], e1[3];
+  for (int c = 0; c < 3; ++c) {
+    int inset = (hi[c] - lo[c]) / 16;
+    e0[c] = std::clamp(hi[c] - inset, 0, 255);
+    e1[c] = std::clamp(lo[c] + inset, 0, 255);
+  }
+
+  uint16_t c0 = pack565(e0), c1 = pack565(e1);
+  uint32_t indices = 0;
+  if (c0 < c1) {
+    std::swap(c0, c1);
+  }
+  if (c0 != c1) {
+    int palette[2][3];
+    unpack565(c0, palette[0]);
+    unpack565(c1, palette[1]);
+
+    /// project onto the endpoint line, quantized as c0, 2/3, 1/3, c1.
+    constexpr static uint32_t order[4] = {1, 3, 2, 0};
+    int dir[3], base = 0, length = 0;
+    for (int c = 0; c < 3; ++c) {
+      dir[c] = palette[0][c] - palette[1][c];
+      base += dir[c] * palette[1][c];
+      length += dir[c] * dir[c];
+    }
+    for (int i = 0; i < 16; ++i) {
+      int dot = block[i][0] * dir[0] + block[i][1] * dir[1] + block[i][2] * dir[2] - base;
+      int step = std::clamp((dot * 3 + length / 2) / std::max(length, 1), 0, 3);
+      indices |= order[step] << (2 * i);
+    }
+  }
+
+  out[0] = static_cast<uint8_t>(c0 & 0xFF);
+  out[1] = static_cast<uint8_t>(c0 >> 8);
+  out[2] = static_cast<uint8_t>(c1 & 0xFF);
+  out[3] = static_cast<uint8_t>(c1 >> 8);
+  for (int i = 0; i < 4; ++i) {
+    out[4 + i] = static_cast<uint8_t>(indices >> (8 * i));
+  }
+}
+
+static void encode_bc1_level(const uint8_t *rgb, int width, int height, uint8_t *out) noexcept {
+  uint8_t block[16][3];
+  for (int by = 0; by < height; by += 4) {
+    for (int bx = 0; bx < width; bx += 4) {
+      /// levels smaller than a block repeat their edge pixels.
+      for (int i = 0; i < 16; ++i) {
+        int x = std::min(bx + (i & 3), width - 1);
+        int y = std::min(by + (i >> 2), height - 1);
+        std::memcpy(block[i], rgb + (static_cast<size_t>(y) * width + x) * 3, 3);
+      }
+      encode_bc1_block(block, out);
+      out += 8;
+    }
+  }
+}
+
+static void decode_bc1_block(const uint8_t *in, uint8_t block[16][3]) noexcept {
+  uint16_t c0 = static_cast<uint16_t>(in[0] | in[1] << 8);
+  uint16_t c1 = static_cast<uint16_t>(in[2] | in[3] << 8);
+  int palette[4][3];
+  unpack565(c0, palette[0]);
+  unpack565(c1, palette[1]);
+  for (int c = 0; c < 3; ++c) {
+    if (c0 > c1) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    } else {
+      /// the punch-through black is opaque black without alpha.
+      palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+      palette[3][c] = 0;
+    }
+  }
+
+  uint32_t indices = static_cast<uint32_t>(in[4] | in[5] << 8 | in[6] << 16) | static_cast<uint32_t>(in[7]) << 24;
+  for (int i = 0; i < 16; ++i) {
+    auto &color = palette[(indices >> (2 * i)) & 3];
+    for (int c = 0; c < 3; ++c) {
+      block[i][c] = static_cast<uint8_t>(color[c]);
+    }
+  }
+}
+
+} // namespace details
+
+class compressed_bitmap::opaque {
+public:
+  int                width = 0, height = 0;
+  std::vector<level> levels;
+  std::string        data;
+
+  void layout(int w, int h, size_t mip_count) noexcept {
+    width = w;
+    height = h;
+    levels.clear();
+    size_t offset = 0;
+    for (size_t i = 0; i < mip_count; ++i) {
+      size_t size = details::bc1_level_size(w, h);
+      levels.emplace_back(level{w, h, offset, size});
+      offset += size;
+      if (w == 1 && h == 1) {
+        break;
+      }
+      w = std::max(1, w / 2);
+      h = std::max(1, h / 2);
+    }
+  }
+};
+
+int compressed_bitmap::width() const noexcept {
+  assert(opaque_ != nullptr);
+
+  return opaque_->width;
+}
+
+int compressed_bitmap::height() const noexcept {
+  assert(opaque_ != nullptr);
+
+  return opaque_->height;
+}
+
+const std::vector<compressed_bitmap::level> &compressed_bitmap::levels() const noexcept {
+  assert(opaque_ != nullptr);
+
+  return opaque_->levels;
+}
+
+const char *compressed_bitmap::buffer() const noexcept {
+  assert(opaque_ != nullptr);
+
+  return opaque_->data.data();
+}
+
+size_t compressed_bitmap::size() const noexcept {
+  assert(opaque_ != nullptr);
+
+  return opaque_->data.size();
+}
+
+bool compressed_bitmap::encode(const bitmap &image) noexcept {
+  assert(opaque_ != nullptr);
+  int w = image.width(), h = image.height(), channel = image.channel();
+  if (nullptr == image.buffer() || w <= 0 || h <= 0 || channel < 1 || channel > 4) {
+
+    return false;
+  }
+
+  /// level 0 in rgb, gray is expanded and alpha is dropped.
+  std::vector<uint8_t> current(static_cast<size_t>(w) * h * 3), next;
+  auto src = reinterpret_cast<const uint8_t *>(image.buffer());
+  for (size_t i = 0, n = static_cast<size_t>(w) * h; i < n; ++i) {
+    for (int c = 0; c < 3; ++c) {
+      current[i * 3 + c] = src[i * channel + (channel < 3 ? 0 : c)];
+    }
+  }
+
+  opaque_->layout(w, h, SIZE_MAX);
+  auto &last = opaque_->levels.back();
+  opaque_->data.assign(last.offset + last.size, '\0');
+  for (auto &lv : opaque_->levels) {
+    if (lv.width != w || lv.height != h) {
+      next.resize(static_cast<size_t>(lv.width) * lv.height * 3);
+      image_ops::downsample_box(current.data(), w, h, 3, next.data());
+      current.swap(next);
+      w = lv.width;
+      h = lv.height;
+    }
+    details::encode_bc1_level(current.data(), w, h,
+                              reinterpret_cast<uint8_t *>(opaque_->data.data() + lv.offset));
+  }
+
+  return true;
+}
+
+bool compressed_bitmap::decode(bitmap &image) const noexcept {
+  assert(opaque_ != nullptr);
+  if (opaque_->levels.empty()) {
+
+    return false;
+  }
+
+  int w = opaque_->width, h = opaque_->height;
+  auto buffer = bitmap::allocate(static_cast<size_t>(w) * h * 3);
+  if (nullptr == buffer) {
+
+    return false;
+  }
+  auto in = reinterpret_cast<const uint8_t *>(opaque_->data.data());
+  auto out = reinterpret_cast<uint8_t *>(buffer.get());
+  uint8_t block[16][3];
+  for (int by = 0; by < h; by += 4) {
+    for (int bx = 0; bx < w; bx += 4, in += 8) {
+      details::decode_bc1_block(in, block);
+      for (int i = 0; i < 16; ++i) {
+        int x = bx + (i & 3), y = by + (i >> 2);
+        if (x < w && y < h) {
+          std::memcpy(out + (static_cast<size_t>(y) * w + x) * 3, block[i], 3);
+        }
+      }
+    }
+  }
+  image.adopt(w, h, 3, std::move(buffer));
+
+  return true;
+}
+
+bool compressed_bitmap::load(const char *buffer, size_t size) noexcept {
+  assert(opaque_ != nullptr);
+  if (!probe(buffer, size)) {
+
+    return false;
+  }
+
+  details::dds_header header;
+  std::memcpy(&header, buffer, sizeof(header));
+  opaque_->layout(static_cast<int>(header.width), static_cast<int>(header.height),
+                  std::max<uint32_t>(1, header.mip_count));
+  auto &last = opaque_->levels.back();
+  if (size - sizeof(header) < last.offset + last.size) {
+    opaque_->levels.clear();
+    opaque_->width = opaque_->height = 0;
+
+    return false;
+  }
+  opaque_->data.assign(buffer + sizeof(header), last.offset + last.size);
+
+  return true;
+}
+
+bool compressed_bitmap::save(std::string &out) const noexcept {
+  assert(opaque_ != nullptr);
+  if (opaque_->levels.empty()) {
+
+    return false;
+  }
+
+  details::dds_header header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = details::dds_magic;
+  header.size = sizeof(header) - sizeof(header.magic);
+  header.flags = details::dds_flags;
+  header.width = static_cast<uint32_t>(opaque_->width);
+  header.height = static_cast<uint32_t>(opaque_->height);
+  header.linear_size = static_cast<uint32_t>(opaque_->levels.front().size);
+  header.mip_count = static_cast<uint32_t>(opaque_->levels.size());
+  header.format.size = sizeof(header.format);
+  header.format.flags = details::dds_pixel_fourcc;
+  header.format.fourcc = details::dds_fourcc_dxt1;
+  header.caps = details::dds_caps;
+
+  out.resize(sizeof(header) + opaque_->data.size());
+  std::memcpy(out.data(), &header, sizeof(header));
+  std::memcpy(out.data() + sizeof(header), opaque_->data.data(), opaque_->data.size());
+
+  return true;
+}
+
+bool compressed_bitmap::probe(const char *buffer, size_t size) noexcept {
+  details::dds_header header;
+  if (nullptr == buffer || size < sizeof(header)) {
+
+    return false;
+  }
+
+  std::memcpy(&header, buffer, sizeof(header));
+
+  return header.magic == details::dds_magic &&
+         header.size == sizeof(header) - sizeof(header.magic) &&
+         (header.format.flags & details::dds_pixel_fourcc) &&
+         header.format.fourcc == details::dds_fourcc_dxt1 &&
+         header.width > 0 && header.height > 0 &&
+         header.width <= 16384 && header.height <= 16384;
+}
+
+compressed_bitmap::compressed_bitmap() noexcept : opaque_{make_uptr<opaque>()} {}
+
+compressed_bitmap::~compressed_bitmap() noexcept {}
+
+} // namespace core
+
+} // namespace esim
@@ -0,0 +1,104 @@
+#include "core/epoch.h"
+#include <algorithm>
+
+namespace esim {
+
+namespace core {
+
+epoch_participant::epoch_participant(epoch_domain &domain) noexcept
+    : domain_{&domain}, state_{0} {
+  domain_->attach(this);
+}
+
+epoch_participant::~epoch_participant() noexcept {
+  assert(!entered());
+  domain_->detach(this);
+}
+
+void epoch_domain::retire(std::function<void()> reclaim) noexcept {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto epoch = epoch_.load(std::memory_order_relaxed);
+  retired_[epoch % retired_.size()].emplace_back(std::move(reclaim));
+}
+
+bool epoch_domain::advance() noexcept {
+  std::vector<std::function<void()>> reclaimed;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto epoch = epoch_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    /// acquires the leaves, the reads of those left happen before reclaimed.
+    for (auto participant : participants_) {
+      auto state = participant->state_.load(std::memory_order_acquire);
+      if (0 != (state & details::epoch_entered) && (state >> 1) != epoch) {
+
+        return false;
+      }
+    }
+
+    epoch_.store(epoch + 1, std::memory_order_release);
+    /// retired in the epoch before the previous, every participant entered
+    /// since has pinned an epoch after them being unreachable.
+    reclaimed.swap(retired_[(epoch + 2) % retired_.size()]);
+  }
+
+  /// may retire again, the lock released.
+  for (auto &reclaim : reclaimed) {
+    reclaim();
+  }
+
+  return true;
+}
+
+uint64_t epoch_domain::current() const noexcept {
+
+  return epoch_.load(std::memory_order_acquire);
+}
+
+size_t epoch_domain::retired() const noexcept {
+  std::lock_guard<std::mutex> lock{mutex_};
+  size_t count = 0;
+  for (auto &bag : retired_) {
+    count += bag.size();
+  }
+
+  return count;
+}
+
+epoch_domain::epoch_domain() noexcept
+    : epoch_{0} {}
+
+epoch_domain::~epoch_domain() noexcept {
+  assert(participants_.empty());
+  /// the oldest first, those retired again by a reclamation included.
+  for (auto epoch = epoch_.load(std::memory_order_relaxed) + 1;; ++epoch) {
+    std::vector<std::function<void()>> reclaimed;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      bool empty = std::all_of(retired_.begin(), retired_.end(), [](auto &bag) { return bag.empty(); });
+      if (empty) {
+        break;
+      }
+      epoch_.store(epoch, std::memory_order_relaxed);
+      reclaimed.swap(retired_[(epoch + 1) % retired_.size()]);
+    }
+    for (auto &reclaim : reclaimed) {
+      reclaim();
+    }
+  }
+}
+
+void epoch_domain::attach(rptr<epoch_participant> participant) noexcept {
+  std::lock_guard<std::mutex> lock{mutex_};
+  participants_.emplace_back(participant);
+}
+
+void epoch_domain::detach(rptr<epoch_participant> participant) noexcept {
+  std::lock_guard<std::mutex> lock{mutex_};
+  participants_.erase(std::remove(participants_.begin(), participants_.end(), participant),
+                      participants_.end());
+}
+
+} // namespace core
+
+} // namespace esim
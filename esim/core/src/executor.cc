@@ -0,0 +1,170 @@
+#include "core/executor.h"
+#include <algorithm>
+
+namespace esim {
+
+namespace core {
+
+namespace details {
+
+/// blocking fetches in tasks are covered by more threads than cores.
+constexpr static size_t executor_min_threads = 4;
+constexpr static uint32_t executor_deque_size = 1024;
+
+static std::atomic<size_t> executor_threads{0};
+
+/// the worker running on this thread, if any.
+struct executor_worker {
+  rptr<const void> owner = nullptr;
+  size_t           index = 0;
+};
+
+static thread_local executor_worker current_worker;
+
+} // namespace details
+
+size_t executor::concurrency() const noexcept {
+
+  return workers_.size();
+}
+
+void executor::shutdown() noexcept {
+  if (stopping_.exchange(true, std::memory_order_acq_rel)) {
+
+    return;
+  }
+
+  available_.notify_all();
+  for (auto &target : workers_) {
+    if (target->thread.joinable()) {
+      target->thread.join();
+    }
+  }
+
+  /// submitted while the workers exiting.
+  for (auto &queue : shared_) {
+    rptr<task> target;
+    while (queue.try_pop(target)) {
+      target->run();
+      delete target;
+    }
+  }
+}
+
+void executor::configure(size_t threads) noexcept {
+  details::executor_threads.store(threads, std::memory_order_relaxed);
+}
+
+rptr<executor> executor::get() noexcept {
+  static executor single{[]() {
+    auto threads = details::executor_threads.load(std::memory_order_relaxed);
+
+    return 0 != threads ? threads
+                        : std::max<size_t>(details::executor_min_threads, std::thread::hardware_concurrency());
+  }()};
+
+  return &single;
+}
+
+executor::executor(size_t threads) noexcept
+    : pending_{0}, stopping_{false} {
+  threads = std::max<size_t>(1, threads);
+  workers_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    auto target = make_uptr<worker>();
+    for (auto &deque : target->deques) {
+      deque = make_uptr<details::work_deque<rptr<task>>>(details::executor_deque_size);
+    }
+    workers_.emplace_back(std::move(target));
+  }
+  /// started once all deques created, the thieves visit every worker.
+  for (size_t i = 0; i < threads; ++i) {
+    workers_[i]->thread = std::thread([this, i]() { run(i); });
+  }
+}
+
+executor::~executor() noexcept {
+  shutdown();
+}
+
+void executor::schedule(rptr<task> target, task_priority priority) noexcept {
+  auto level = static_cast<size_t>(priority);
+  auto &local = details::current_worker;
+  if (local.owner != this || !workers_[local.index]->deques[level]->push(target)) {
+    shared_[level].push(target);
+  }
+
+  pending_.fetch_add(1, std::memory_order_release);
+  available_.notify_one();
+}
+
+bool executor::next(size_t index, rptr<task> &target) noexcept {
+  for (size_t level = 0; level < shared_.size(); ++level) {
+    if (workers_[index]->deques[level]->pop(target) || shared_[level].try_pop(target)) {
+
+      return true;
+    }
+    for (size_t i = 1; i < workers_.size(); ++i) {
+      auto &victim = workers_[(index + i) % workers_.size()];
+      if (victim->deques[level]->steal(target)) {
+
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void executor::run(size_t index) noexcept {
+  details::current_worker = details::executor_worker{this, index};
+  for (;;) {
+    rptr<task> target = nullptr;
+    if (next(index, target)) {
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      target->run();
+      delete target;
+      continue;
+    }
+
+    /// drains the tasks left before exiting.
+    if (stopping_.load(std::memory_order_acquire) && 0 == pending_.load(std::memory_order_acquire)) {
+      break;
+    }
+    available_.park_until([this]() {
+      return 0 != pending_.load(std::memory_order_acquire) || stopping_.load(std::memory_order_acquire);
+    });
+  }
+  details::current_worker = details::executor_worker{};
+}
+
+size_t task_group::pending() const noexcept {
+
+  return pending_.load(std::memory_order_acquire);
+}
+
+void task_group::wait() noexcept {
+  std::unique_lock<std::mutex> lock{mutex_};
+  done_.wait(lock, [this]() { return 0 == pending_.load(std::memory_order_relaxed); });
+}
+
+task_group::task_group(rptr<executor> target) noexcept
+    : executor_{target}, pending_{0} {
+  assert(nullptr != executor_);
+}
+
+task_group::~task_group() noexcept {
+  wait();
+}
+
+void task_group::finish() noexcept {
+  /// notified under the mutex, the waiter never returns before unlocked.
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (1 == pending_.fetch_sub(1, std::memory_order_relaxed)) {
+    done_.notify_all();
+  }
+}
+
+} // namespace core
+
+} // namespace esim
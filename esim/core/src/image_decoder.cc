@@ -0,0 +1,269 @@
+#include "core/image_decoder.h"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#if defined(ESIM_ENABLE_LIBJPEG)
+#include <csetjmp>
+#include <cstdio>
+#include <jpeglib.h>
+#endif
+
+namespace esim {
+
+namespace core {
+
+rptr<const stb_image_decoder> stb_image_decoder::get() noexcept {
+  static stb_image_decoder single;
+
+  return &single;
+}
+
+std::string_view stb_image_decoder::name() const noexcept {
+
+  return "stb_image";
+}
+
+bool stb_image_decoder::probe(const char *data, size_t size, image_info &info) const noexcept {
+
+  return 0 != stbi_info_from_memory(reinterpret_cast<const stbi_uc *>(data),
+                                    static_cast<int>(size),
+                                    &info.width, &info.height, &info.channel);
+}
+
+bool stb_image_decoder::decode(const char *data, size_t size, bitmap &out,
+                               const bitmap::allocator_type &alloc) const noexcept {
+  image_info info;
+  stbi_uc *pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(data),
+                                          static_cast<int>(size),
+                                          &info.width, &info.height, &info.channel, 0);
+  if (nullptr == pixels) {
+    std::cout << stbi_failure_reason() << std::endl;
+
+    return false;
+  }
+
+  if (nullptr == alloc) {
+    /// adopt the buffer of stb directly.
+    out.adopt(info.width, info.height, info.channel,
+              bitmap::buffer_type(reinterpret_cast<char *>(pixels),
+                                  [](char *p) { stbi_image_free(p); }));
+
+    return true;
+  }
+
+  size_t bytes = static_cast<size_t>(info.width) * info.height * info.channel;
+  auto buffer = alloc(bytes);
+  bool ok = nullptr != buffer;
+  if (ok) {
+    std::memcpy(buffer.get(), pixels, bytes);
+    out.adopt(info.width, info.height, info.channel, std::move(buffer));
+  }
+  stbi_image_free(pixels);
+
+  return ok;
+}
+
+namespace details {
+
+/// header of raw images, in host byte order.
+struct raw_image_header {
+  char     magic[4];
+  uint32_t width, height, channel;
+};
+
+constexpr static char raw_image_magic[4] = {'E', 'R', 'A', 'W'};
+
+} // namespace details
+
+rptr<const raw_image_decoder> raw_image_decoder::get() noexcept {
+  static raw_image_decoder single;
+
+  return &single;
+}
+
+std::string_view raw_image_decoder::name() const noexcept {
+
+  return "raw";
+}
+
+bool raw_image_decoder::probe(const char *data, size_t size, image_info &info) const noexcept {
+  details::raw_image_header header;
+  if (size < sizeof(header)) {
+
+    return false;
+  }
+
+  std::memcpy(&header, data, sizeof(header));
+  if (0 != std::memcmp(header.magic, details::raw_image_magic, sizeof(header.magic)) ||
+      size - sizeof(header) != static_cast<size_t>(header.width) * header.height * header.channel) {
+
+    return false;
+  }
+  info.width = static_cast<int>(header.width);
+  info.height = static_cast<int>(header.height);
+  info.channel = static_cast<int>(header.channel);
+
+  return true;
+}
+
+bool raw_image_decoder::decode(const char *data, size_t size, bitmap &out,
+                               const bitmap::allocator_type &alloc) const noexcept {
+  image_info info;
+  if (!probe(data, size, info)) {
+
+    return false;
+  }
+
+  size_t bytes = size - sizeof(details::raw_image_header);
+  auto buffer = nullptr == alloc ? bitmap::allocate(bytes) : alloc(bytes);
+  if (nullptr == buffer) {
+
+    return false;
+  }
+  std::memcpy(buffer.get(), data + sizeof(details::raw_image_header), bytes);
+  out.adopt(info.width, info.height, info.channel, std::move(buffer));
+
+  return true;
+}
+
+bool encode_raw_image(const bitmap &image, std::string &out) noexcept {
+  if (nullptr == image.buffer()) {
+
+    return false;
+  }
+
+  details::raw_image_header header;
+  std::memcpy(header.magic, details::raw_image_magic, sizeof(header.magic));
+  header.width = static_cast<uint32_t>(image.width());
+  header.height = static_cast<uint32_t>(image.height());
+  header.channel = static_cast<uint32_t>(image.channel());
+  out.resize(sizeof(header) + image.size());
+  std::memcpy(out.data(), &header, sizeof(header));
+  std::memcpy(out.data() + sizeof(header), image.buffer(), image.size());
+
+  return true;
+}
+
+#if defined(ESIM_ENABLE_LIBJPEG)
+
+namespace details {
+
+struct jpeg_error {
+  jpeg_error_mgr mgr;
+  jmp_buf        jump;
+};
+
+static void jpeg_error_exit(j_common_ptr cinfo) {
+  longjmp(reinterpret_cast<jpeg_error *>(cinfo->err)->jump, 1);
+}
+
+static void jpeg_output_message(j_common_ptr) {}
+
+/// decodes into dst if not null, keeps trivial locals only since
+/// libjpeg reports errors by longjmp.
+static bool jpeg_read(const char *data, size_t size, image_info &info, char *dst) noexcept {
+  jpeg_decompress_struct cinfo;
+  jpeg_error             err;
+  std::memset(&cinfo, 0, sizeof(cinfo));
+  cinfo.err = jpeg_std_error(&err.mgr);
+  err.mgr.error_exit = jpeg_error_exit;
+  err.mgr.output_message = jpeg_output_message;
+
+  if (setjmp(err.jump)) {
+    jpeg_destroy_decompress(&cinfo);
+
+    return false;
+  }
+
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo, reinterpret_cast<const unsigned char *>(data),
+               static_cast<unsigned long>(size));
+  jpeg_read_header(&cinfo, TRUE);
+  cinfo.out_color_space = JCS_RGB;
+  info.width = static_cast<int>(cinfo.image_width);
+  info.height = static_cast<int>(cinfo.image_height);
+  info.channel = 3;
+
+  if (nullptr != dst) {
+    jpeg_start_decompress(&cinfo);
+    const size_t stride = static_cast<size_t>(cinfo.output_width) * cinfo.output_components;
+    JSAMPROW rows[4];
+    while (cinfo.output_scanline < cinfo.output_height) {
+      JDIMENSION count = 0;
+      for (; count < 4 && cinfo.output_scanline + count < cinfo.output_height; ++count) {
+        rows[count] = reinterpret_cast<JSAMPROW>(dst + stride * (cinfo.output_scanline + count));
+      }
+      jpeg_read_scanlines(&cinfo, rows, count);
+    }
+    jpeg_finish_decompress(&cinfo);
+  }
+  jpeg_destroy_decompress(&cinfo);
+
+  return true;
+}
+
+} // namespace details
+
+rptr<const jpeg_image_decoder> jpeg_image_decoder::get() noexcept {
+  static jpeg_image_decoder single;
+
+  return &single;
+}
+
+std::string_view jpeg_image_decoder::name() const noexcept {
+
+  return "libjpeg";
+}
+
+bool jpeg_image_decoder::probe(const char *data, size_t size, image_info &info) const noexcept {
+
+  return details::jpeg_read(data, size, info, nullptr);
+}
+
+bool jpeg_image_decoder::decode(const char *data, size_t size, bitmap &out,
+                                const bitmap::allocator_type &alloc) const noexcept {
+  image_info info;
+  if (!probe(data, size, info)) {
+
+    return false;
+  }
+
+  size_t bytes = static_cast<size_t>(info.width) * info.height * info.channel;
+  auto buffer = nullptr == alloc ? bitmap::allocate(bytes) : alloc(bytes);
+  if (nullptr == buffer || !details::jpeg_read(data, size, info, buffer.get())) {
+
+    return false;
+  }
+  out.adopt(info.width, info.height, info.channel, std::move(buffer));
+
+  return true;
+}
+
+#endif
+
+rptr<const image_decoder> select_image_decoder(const char *data, size_t size) noexcept {
+  if (size > sizeof(details::raw_image_magic) &&
+      0 == std::memcmp(data, details::raw_image_magic, sizeof(details::raw_image_magic))) {
+
+    return raw_image_decoder::get();
+  }
+
+#if defined(ESIM_ENABLE_LIBJPEG)
+  constexpr static unsigned char jpeg_magic[] = {0xFF, 0xD8, 0xFF};
+  if (size > sizeof(jpeg_magic) && 0 == std::memcmp(data, jpeg_magic, sizeof(jpeg_magic))) {
+
+    return jpeg_image_decoder::get();
+  }
+#endif
+
+  return stb_image_decoder::get();
+}
+
+} // namespace core
+
+} // namespace esim
@@ -0,0 +1,442 @@
+#include "core/image_ops.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ESIM_IMAGE_OPS_SSE2
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ESIM_TARGET_SSSE3
+#else
+#define ESIM_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+
+namespace esim {
+
+namespace core {
+
+namespace details {
+
+/**
+ * @brief Conversions between srgb and linear, linear values are in 16 bits.
+ *
+ */
+struct srgb_tables {
+  std::array<uint16_t, 256>   to_linear;
+  std::array<float, 256>      to_linear_float;
+  std::array<uint8_t, 65536>  to_srgb;
+
+  srgb_tables() noexcept {
+    for (size_t i = 0; i < to_linear.size(); ++i) {
+      double c = i / 255.0;
+      double l = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+      to_linear[i] = static_cast<uint16_t>(std::lround(l * 65535.0));
+      to_linear_float[i] = static_cast<float>(l);
+    }
+    for (size_t i = 0; i < to_srgb.size(); ++i) {
+      double l = i / 65535.0;
+      double c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+      to_srgb[i] = static_cast<uint8_t>(std::lround(std::clamp(c, 0.0, 1.0) * 255.0));
+    }
+  }
+
+  static const srgb_tables &get() noexcept {
+    static const srgb_tables single;
+
+    return single;
+  }
+};
+
+static bool has_ssse3() noexcept {
+#if defined(ESIM_IMAGE_OPS_SSE2) && defined(_MSC_VER)
+  static const bool supported = []() {
+    int info[4];
+    __cpuid(info, 1);
+
+    return 0 != (info[2] & (1 << 9));
+  }();
+
+  return supported;
+#elif defined(ESIM_IMAGE_OPS_SSE2)
+  static const bool supported = __builtin_cpu_supports("ssse3");
+
+  return supported;
+#else
+
+  return false;
+#endif
+}
+
+static void expand_rgb_to_rgba_scalar(const uint8_t *src, uint8_t *dst, size_t count, uint8_t alpha) noexcept {
+  for (size_t i = 0; i < count; ++i, src += 3, dst += 4) {
+    dst[0] = src[0];
+    dst[1] = src[1];
+    dst[2] = src[2];
+    dst[3] = alpha;
+  }
+}
+
+#ifdef ESIM_IMAGE_OPS_SSE2
+/// 16 pixels per iteration, 3 loads are shuffled into 4 stores.
+ESIM_TARGET_SSSE3
+static size_t expand_rgb_to_rgba_ssse3(const uint8_t *src, uint8_t *dst, size_t count, uint8_t alpha) noexcept {
+  const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i fill = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16, src += 48, dst += 64) {
+    __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+    __m128i in2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32));
+    __m128i out0 = _mm_shuffle_epi8(in0, mask);
+    __m128i out1 = _mm_shuffle_epi8(_mm_alignr_epi8(in1, in0, 12), mask);
+    __m128i out2 = _mm_shuffle_epi8(_mm_alignr_epi8(in2, in1, 8), mask);
+    __m128i out3 = _mm_shuffle_epi8(_mm_srli_si128(in2, 4), mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(out0, fill));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_or_si128(out1, fill));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32), _mm_or_si128(out2, fill));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 48), _mm_or_si128(out3, fill));
+  }
+
+  return i;
+}
+
+/// 4 rgba pixels of destination per iteration, returns the pixels done.
+static int downsample_box_rgba_sse2(const uint8_t *row0, const uint8_t *row1, int dst_width, uint8_t *dst) noexcept {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi16(2);
+  int x = 0;
+  for (; x + 4 <= dst_width; x += 4, row0 += 32, row1 += 32, dst += 16) {
+    __m128i sums[2];
+    for (int half = 0; half < 2; ++half) {
+      __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + half * 16));
+      __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + half * 16));
+      /// vertical sums of pixels 0, 1 and 2, 3 in 16 bits.
+      __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+      __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+      /// horizontal sums, pixel 0 + 1 in lanes 0-3 and pixel 2 + 3 in lanes 4-7.
+      __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+      sums[half] = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(sums[0], sums[1]));
+  }
+
+  return x;
+}
+#endif
+
+static std::array<float, 8> kaiser_weights() noexcept {
+  /// taps at -3.5 to 3.5 source pixels, the cutoff is half of source nyquist.
+  constexpr double pi = 3.14159265358979323846;
+  constexpr double alpha = 4.0;
+  auto bessel_i0 = [](double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 16; ++k) {
+      term *= (x / (2.0 * k)) * (x / (2.0 * k));
+      sum += term;
+    }
+
+    return sum;
+  };
+
+  std::array<float, 8> weights;
+  double total = 0.0;
+  for (int k = 0; k < 8; ++k) {
+    double d = k - 3.5;
+    double t = d / 4.0;
+    double sinc = std::sin(pi * d / 2.0) / (pi * d / 2.0);
+    double window = bessel_i0(alpha * std::sqrt(std::max(0.0, 1.0 - t * t))) / bessel_i0(alpha);
+    weights[k] = static_cast<float>(sinc * window);
+    total += weights[k];
+  }
+  for (auto &w : weights) {
+    w = static_cast<float>(w / total);
+  }
+
+  return weights;
+}
+
+/// channels are known at compile time, so the taps are unrolled and vectorized.
+template <int channel>
+static void downsample_kaiser(const uint8_t *src, int width, int height, uint8_t *dst, bool srgb) noexcept {
+  static const std::array<float, 8> weights = kaiser_weights();
+  constexpr int color = channel == 2 || channel == 4 ? channel - 1 : channel;
+  const int dst_width = std::max(1, width / 2), dst_height = std::max(1, height / 2);
+  auto &tables = srgb_tables::get();
+  auto to_float = [&](uint8_t v, int c) {
+    return srgb && c < color ? tables.to_linear_float[v] : v * (1.0f / 255.0f);
+  };
+
+  /// horizontal pass into linear floats, rows are padded by the edge pixels
+  /// so that taps from -3 to +4 need no clamping.
+  std::vector<float> row(static_cast<size_t>(width + 7) * channel);
+  std::vector<float> temp(static_cast<size_t>(dst_width) * height * channel);
+  for (int y = 0; y < height; ++y) {
+    const uint8_t *in = src + static_cast<size_t>(y) * width * channel;
+    for (int x = -3; x < width + 4; ++x) {
+      const uint8_t *pixel = in + std::clamp(x, 0, width - 1) * channel;
+      for (int c = 0; c < channel; ++c) {
+        row[(x + 3) * channel + c] = to_float(pixel[c], c);
+      }
+    }
+    float *out = temp.data() + static_cast<size_t>(y) * dst_width * channel;
+    for (int x = 0; x < dst_width; ++x) {
+      const float *taps = row.data() + x * 2 * channel;
+      float sum[channel] = {};
+      for (int k = 0; k < 8; ++k) {
+        for (int c = 0; c < channel; ++c) {
+          sum[c] += weights[k] * taps[k * channel + c];
+        }
+      }
+      for (int c = 0; c < channel; ++c) {
+        out[x * channel + c] = sum[c];
+      }
+    }
+  }
+
+  const size_t stride = static_cast<size_t>(dst_width) * channel;
+  std::vector<float> sum(stride);
+  for (int y = 0; y < dst_height; ++y) {
+    std::fill(sum.begin(), sum.end(), 0.0f);
+    for (int k = 0; k < 8; ++k) {
+      const float *in = temp.data() + std::clamp(y * 2 - 3 + k, 0, height - 1) * stride;
+      const float  w = weights[k];
+      for (size_t i = 0; i < stride; ++i) {
+        sum[i] += w * in[i];
+      }
+    }
+    uint8_t *out = dst + y * stride;
+    for (size_t i = 0; i < stride; i += channel) {
+      for (int c = 0; c < channel; ++c) {
+        float v = std::clamp(sum[i + c], 0.0f, 1.0f);
+        out[i + c] = srgb && c < color ? tables.to_srgb[static_cast<size_t>(v * 65535.0f + 0.5f)]
+                                       : static_cast<uint8_t>(v * 255.0f + 0.5f);
+      }
+    }
+  }
+}
+
+template <blend_mode mode>
+static inline int blend_channel(int below, int layer) noexcept {
+  switch (mode) {
+  case blend_mode::multiply:
+
+    return (below * layer + 127) / 255;
+  case blend_mode::screen:
+
+    return 255 - ((255 - below) * (255 - layer) + 127) / 255;
+  case blend_mode::add:
+
+    return std::min(below + layer, 255);
+  default:
+
+    return layer;
+  }
+}
+
+/// alpha in 0 to 256 so that the interpolation is a shift.
+template <blend_mode mode>
+static void blend(uint8_t *dst, const uint8_t *src, int channel, size_t count, int opacity) noexcept {
+  bool has_alpha = channel == 2 || channel == 4;
+  bool is_gray = channel < 3;
+  for (size_t i = 0; i < count; ++i, dst += 3, src += channel) {
+    int alpha = has_alpha ? (src[channel - 1] * opacity + 127) / 255 : opacity;
+    alpha += alpha >> 7;
+    for (int c = 0; c < 3; ++c) {
+      int below = dst[c];
+      int result = blend_channel<mode>(below, src[is_gray ? 0 : c]);
+      dst[c] = static_cast<uint8_t>(below + (((result - below) * alpha) >> 8));
+    }
+  }
+}
+
+} // namespace details
+
+namespace image_ops {
+
+void expand_rgb_to_rgba(const uint8_t *src, uint8_t *dst, size_t count, uint8_t alpha) noexcept {
+  size_t done = 0;
+#ifdef ESIM_IMAGE_OPS_SSE2
+  if (details::has_ssse3()) {
+    done = details::expand_rgb_to_rgba_ssse3(src, dst, count, alpha);
+  }
+#endif
+  details::expand_rgb_to_rgba_scalar(src + done * 3, dst + done * 4, count - done, alpha);
+}
+
+void downsample_box(const uint8_t *src, int width, int height, int channel,
+                    uint8_t *dst, bool srgb) noexcept {
+  assert(channel >= 1 && channel <= 4);
+  const int dst_width = std::max(1, width / 2), dst_height = std::max(1, height / 2);
+  const size_t stride = static_cast<size_t>(width) * channel;
+  const int color = channel == 2 || channel == 4 ? channel - 1 : channel;
+  auto &tables = details::srgb_tables::get();
+
+  for (int y = 0; y < dst_height; ++y) {
+    const uint8_t *row0 = src + std::min(y * 2, height - 1) * stride;
+    const uint8_t *row1 = src + std::min(y * 2 + 1, height - 1) * stride;
+    uint8_t *out = dst + static_cast<size_t>(y) * dst_width * channel;
+    int x = 0;
+#ifdef ESIM_IMAGE_OPS_SSE2
+    if (!srgb && channel == 4 && width >= 2) {
+      x = details::downsample_box_rgba_sse2(row0, row1, dst_width, out);
+    }
+#endif
+    for (; x < dst_width; ++x) {
+      size_t x0 = static_cast<size_t>(std::min(x * 2, width - 1)) * channel;
+      size_t x1 = static_cast<size_t>(std::min(x * 2 + 1, width - 1)) * channel;
+      for (int c = 0; c < channel; ++c) {
+        if (srgb && c < color) {
+          uint32_t sum = tables.to_linear[row0[x0 + c]] + tables.to_linear[row0[x1 + c]] +
+                         tables.to_linear[row1[x0 + c]] + tables.to_linear[row1[x1 + c]];
+          out[x * channel + c] = tables.to_srgb[(sum + 2) >> 2];
+        } else {
+          uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+          out[x * channel + c] = static_cast<uint8_t>((sum + 2) >> 2);
+        }
+      }
+    }
+  }
+}
+
+void downsample_kaiser(const uint8_t *src, int width, int height, int channel,
+                       uint8_t *dst, bool srgb) noexcept {
+  assert(channel >= 1 && channel <= 4);
+  switch (channel) {
+  case 1:
+    details::downsample_kaiser<1>(src, width, height, dst, srgb);
+    break;
+  case 2:
+    details::downsample_kaiser<2>(src, width, height, dst, srgb);
+    break;
+  case 3:
+    details::downsample_kaiser<3>(src, width, height, dst, srgb);
+    break;
+  default:
+    details::downsample_kaiser<4>(src, width, height, dst, srgb);
+    break;
+  }
+}
+
+void flip_vertical(uint8_t *data, int width, int height, int channel) noexcept {
+  const size_t stride = static_cast<size_t>(width) * channel;
+  std::vector<uint8_t> row(stride);
+  for (int top = 0, bottom = height - 1; top < bottom; ++top, --bottom) {
+    uint8_t *a = data + top * stride, *b = data + bottom * stride;
+    std::memcpy(row.data(), a, stride);
+    std::memcpy(a, b, stride);
+    std::memcpy(b, row.data(), stride);
+  }
+}
+
+void blend(uint8_t *dst, const uint8_t *src, int channel, size_t count,
+           blend_mode mode, float opacity) noexcept {
+  assert(channel >= 1 && channel <= 4);
+  int alpha = static_cast<int>(std::clamp(opacity, 0.0f, 1.0f) * 255.0f + 0.5f);
+  if (0 == alpha) {
+
+    return;
+  }
+
+  switch (mode) {
+  case blend_mode::multiply:
+    details::blend<blend_mode::multiply>(dst, src, channel, count, alpha);
+    break;
+  case blend_mode::screen:
+    details::blend<blend_mode::screen>(dst, src, channel, count, alpha);
+    break;
+  case blend_mode::add:
+    details::blend<blend_mode::add>(dst, src, channel, count, alpha);
+    break;
+  default:
+    details::blend<blend_mode::normal>(dst, src, channel, count, alpha);
+    break;
+  }
+}
+
+void resample_region(const uint8_t *src, int width, int height, int channel,
+                     float x, float y, float region_width, float region_height,
+                     uint8_t *dst, int dst_width, int dst_height) noexcept {
+  assert(channel >= 1 && channel <= 4);
+  float step_x = region_width / static_cast<float>(dst_width);
+  float step_y = region_height / static_cast<float>(dst_height);
+  for (int j = 0; j < dst_height; ++j) {
+    /// sampled at the centers of destination pixels.
+    float sy = std::clamp(y + (static_cast<float>(j) + 0.5f) * step_y - 0.5f, 0.0f, static_cast<float>(height - 1));
+    int   y0 = static_cast<int>(sy), y1 = std::min(y0 + 1, height - 1);
+    float fy = sy - static_cast<float>(y0);
+    auto  row0 = src + static_cast<size_t>(y0) * width * channel;
+    auto  row1 = src + static_cast<size_t>(y1) * width * channel;
+    for (int i = 0; i < dst_width; ++i, dst += channel) {
+      float sx = std::clamp(x + (static_cast<float>(i) + 0.5f) * step_x - 0.5f, 0.0f, static_cast<float>(width - 1));
+      int   x0 = static_cast<int>(sx), x1 = std::min(x0 + 1, width - 1);
+      float fx = sx - static_cast<float>(x0);
+      for (int c = 0; c < channel; ++c) {
+        float top = row0[x0 * channel + c] + (row0[x1 * channel + c] - row0[x0 * channel + c]) * fx;
+        float bottom = row1[x0 * channel + c] + (row1[x1 * channel + c] - row1[x0 * channel + c]) * fx;
+        dst[c] = static_cast<uint8_t>(top + (bottom - top) * fy + 0.5f);
+      }
+    }
+  }
+}
+
+bool generate_mip_chain(const bitmap &image, mip_chain &out, mip_filter filter, bool srgb) noexcept {
+  int w = image.width(), h = image.height(), channel = image.channel();
+  if (nullptr == image.buffer() || w <= 0 || h <= 0 || channel < 1 || channel > 4) {
+
+    return false;
+  }
+
+  out.channel = 4;
+  out.levels.clear();
+  size_t offset = 0;
+  for (int lw = w, lh = h;; lw = std::max(1, lw / 2), lh = std::max(1, lh / 2)) {
+    size_t size = static_cast<size_t>(lw) * lh * 4;
+    out.levels.emplace_back(mip_chain::level{lw, lh, offset, size});
+    offset += size;
+    if (lw == 1 && lh == 1) {
+      break;
+    }
+  }
+  out.data.resize(offset);
+
+  auto src = reinterpret_cast<const uint8_t *>(image.buffer());
+  const size_t count = static_cast<size_t>(w) * h;
+  if (channel == 3) {
+    expand_rgb_to_rgba(src, out.data.data(), count);
+  } else if (channel == 4) {
+    std::memcpy(out.data.data(), src, count * 4);
+  } else {
+    /// gray is replicated into rgb.
+    auto dst = out.data.data();
+    for (size_t i = 0; i < count; ++i, src += channel, dst += 4) {
+      dst[0] = dst[1] = dst[2] = src[0];
+      dst[3] = channel == 2 ? src[1] : 255;
+    }
+  }
+
+  for (size_t i = 1; i < out.levels.size(); ++i) {
+    auto &prev = out.levels[i - 1];
+    auto &curr = out.levels[i];
+    auto  from = out.data.data() + prev.offset;
+    auto  to = out.data.data() + curr.offset;
+    if (mip_filter::kaiser == filter) {
+      downsample_kaiser(from, prev.width, prev.height, 4, to, srgb);
+    } else {
+      downsample_box(from, prev.width, prev.height, 4, to, srgb);
+    }
+  }
+
+  return true;
+}
+
+} // namespace image_ops
+
+} // namespace core
+
+} // namespace esim
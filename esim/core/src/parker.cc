@@ -0,0 +1,80 @@
+#include "core/parker.h"
+#include <climits>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace esim {
+
+namespace core {
+
+parker::parker() noexcept
+    : epoch_{0}, waiters_{0} {}
+
+uint32_t parker::prepare() noexcept {
+  waiters_.fetch_add(1, std::memory_order_seq_cst);
+  /// pairs with the fence of notify, either side sees the other.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  return epoch_.load(std::memory_order_seq_cst);
+}
+
+void parker::cancel() noexcept {
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+#if defined(__linux__)
+
+void parker::wait(uint32_t epoch, int64_t timeout_ns) noexcept {
+  timespec  ts;
+  timespec *timeout = nullptr;
+  if (timeout_ns >= 0) {
+    ts.tv_sec = static_cast<time_t>(timeout_ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(timeout_ns % 1000000000);
+    timeout = &ts;
+  }
+  /// returns at once if notified since the epoch read, spurious wake ups are
+  /// handled by the caller checking the predicate again.
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, epoch, timeout, nullptr, 0);
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void parker::wake(bool all) noexcept {
+  epoch_.fetch_add(1, std::memory_order_seq_cst);
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr,
+          nullptr, 0);
+}
+
+#else
+
+void parker::wait(uint32_t epoch, int64_t timeout_ns) noexcept {
+  std::unique_lock<std::mutex> lock{mutex_};
+  auto notified = [&]() { return epoch_.load(std::memory_order_acquire) != epoch; };
+  if (timeout_ns < 0) {
+    cond_.wait(lock, notified);
+  } else {
+    cond_.wait_for(lock, std::chrono::nanoseconds{timeout_ns}, notified);
+  }
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void parker::wake(bool all) noexcept {
+  epoch_.fetch_add(1, std::memory_order_seq_cst);
+  /// the lock orders the notify after a waiter checked the epoch.
+  { std::lock_guard<std::mutex> lock{mutex_}; }
+  if (all) {
+    cond_.notify_all();
+  } else {
+    cond_.notify_one();
+  }
+}
+
+#endif
+
+} // namespace core
+
+} // namespace esim
@@ -1,6 +1,7 @@
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 #include <esim/esim_controller.h>
+#include <chrono>
 #include <glad/glad.h>
 #include <iostream>
 
@@ -60,7 +61,14 @@ int main(...) {
   esim_ctrler->bind_after_render_process([&]() { 
     glfwSwapBuffers(window);
   });
+  /// nothing drawn while idle, the requests post an empty event to wake it up.
+  esim_ctrler->bind_idle_process([](std::chrono::milliseconds timeout) {
+    glfwWaitEventsTimeout(std::chrono::duration<double>(timeout).count());
+  });
+  esim_ctrler->bind_wake_process([]() { glfwPostEmptyEvent(); });
   esim_ctrler->start();
+  /// the scene released while the context and the threads still alive.
+  esim_ctrler.reset();
 
   glfwDestroyWindow(window);
   glfwTerminate();
@@ -157,6 +165,13 @@ inline esim::protocol::keycode_type glfw_to_keycode(int glfw_key) noexcept {
 
   case GLFW_KEY_B:
     return esim::protocol::KEY_B;
+  case GLFW_KEY_P:
+    return esim::protocol::KEY_P;
+
+  case GLFW_KEY_COMMA:
+    return esim::protocol::KEY_COMMA;
+  case GLFW_KEY_PERIOD:
+    return esim::protocol::KEY_PERIOD;
 
   default:
     return esim::protocol::KEY_NONE;
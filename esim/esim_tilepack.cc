@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <core/bitmap.h>
+#include <core/buffer_pool.h>
+#include <core/compressed_bitmap.h>
+#include <core/executor.h>
+#include <core/image_decoder.h>
+#include <core/transform.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <details/tile_source.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Seeds the on-disk tile cache of a region ahead of time.
+ *
+ * usage: esim_tilepack --source <uri> --out <dir> --bbox <south,west,north,east>
+ *                      --lod <min[-max]> [--format encoded|raw|bc1]
+ *                      [--threads <n>] [--retries <n>] [--force]
+ *
+ * Maptiles already in the cache are skipped unless --force is given, so an
+ * interrupted run is resumed by running it again.
+ */
+
+struct tilepack_options {
+  std::string source;
+  std::string out;
+  double      south = 0.0, west = 0.0, north = 0.0, east = 0.0;
+  int         min_lod = -1, max_lod = -1;
+  std::string format = "encoded";
+  size_t      threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t      retries = 2;
+  bool        force = false;
+};
+
+/// maptiles of a level of details within the bounding box.
+struct tilepack_range {
+  uint8_t  lod;
+  uint32_t row, col;
+  uint32_t rows, cols;
+  size_t   offset;
+};
+
+struct tilepack_statistics {
+  std::atomic<size_t> done{0}, stored{0}, skipped{0}, no_data{0}, failed{0}, invalid{0};
+  std::atomic<size_t> fetched_bytes{0}, stored_bytes{0};
+};
+
+static void print_usage() noexcept;
+static bool parse_options(int argc, char **argv, tilepack_options &opts) noexcept;
+static bool process_tile(const tilepack_options &opts, const esim::geo::maptile &tile,
+                         esim::tile_source &source, esim::cache_tile_source &cache,
+                         esim::core::buffer_pool &pool, tilepack_statistics &stats) noexcept;
+static void print_progress(size_t total, const tilepack_statistics &stats,
+                           std::chrono::steady_clock::duration elapsed, bool last) noexcept;
+
+int main(int argc, char **argv) {
+  tilepack_options opts;
+  if (!parse_options(argc, argv, opts)) {
+    print_usage();
+    exit(EXIT_FAILURE);
+  }
+
+  auto source = esim::make_tile_source(opts.source);
+  if (nullptr == source) {
+    std::cerr << "[x] unsupported tile source: " << opts.source << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  esim::cache_tile_source cache(opts.out);
+
+  std::vector<tilepack_range> ranges;
+  size_t total = 0;
+  for (int lod = opts.min_lod; lod <= opts.max_lod; ++lod) {
+    auto nw = esim::geo::geo_to_maptile(glm::dvec2{opts.north, opts.west}, static_cast<uint8_t>(lod));
+    auto se = esim::geo::geo_to_maptile(glm::dvec2{opts.south, opts.east}, static_cast<uint8_t>(lod));
+    tilepack_range range{static_cast<uint8_t>(lod), nw.x, nw.y, se.x - nw.x + 1, se.y - nw.y + 1, total};
+    total += static_cast<size_t>(range.rows) * range.cols;
+    ranges.emplace_back(range);
+  }
+  std::cout << "[-] " << total << " maptiles in LOD " << opts.min_lod << "-" << opts.max_lod
+            << " with " << opts.threads << " threads." << std::endl;
+
+  tilepack_statistics stats;
+  std::atomic<size_t> next{0};
+  esim::core::buffer_pool pool(256 * 256 * 4, opts.threads * 2);
+  auto start = std::chrono::steady_clock::now();
+
+  /// each worker takes the next maptile until none left.
+  esim::core::executor::configure(opts.threads);
+  esim::core::task_group workers;
+  for (size_t i = 0; i < opts.threads; ++i) {
+    workers.submit([&]() {
+      for (size_t index = next.fetch_add(1, std::memory_order_relaxed); index < total;
+           index = next.fetch_add(1, std::memory_order_relaxed)) {
+        auto range = std::upper_bound(ranges.begin(), ranges.end(), index,
+                                      [](size_t i, const tilepack_range &r) { return i < r.offset; }) - 1;
+        size_t local = index - range->offset;
+        esim::geo::maptile tile{range->lod,
+                                range->row + static_cast<uint32_t>(local / range->cols),
+                                range->col + static_cast<uint32_t>(local % range->cols)};
+        if (!process_tile(opts, tile, *source, cache, pool, stats)) {
+          std::cerr << "\n[x] failed to pack maptile " << tile << std::endl;
+        }
+        stats.done.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  auto last_print = start;
+  while (stats.done.load(std::memory_order_relaxed) < total) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_print >= std::chrono::seconds(1)) {
+      print_progress(total, stats, now - start, false);
+      last_print = now;
+    }
+  }
+  workers.wait();
+  print_progress(total, stats, std::chrono::steady_clock::now() - start, true);
+
+  exit(stats.failed.load() + stats.invalid.load() == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+bool process_tile(const tilepack_options &opts, const esim::geo::maptile &tile,
+                  esim::tile_source &source, esim::cache_tile_source &cache,
+                  esim::core::buffer_pool &pool, tilepack_statistics &stats) noexcept {
+  if (!opts.force && cache.contains(tile)) {
+    stats.skipped.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+  }
+
+  std::string data;
+  auto status = esim::TILE_FAILURE;
+  for (size_t attempt = 0; attempt <= opts.retries; ++attempt) {
+    if (attempt > 0) {
+      std::this_thread::sleep_for(std::chrono::seconds(1 << (attempt - 1)));
+    }
+    status = source.fetch(tile, data);
+    if (esim::TILE_FAILURE != status) {
+      break;
+    }
+  }
+
+  if (esim::TILE_NO_DATA == status) {
+    stats.no_data.fetch_add(1, std::memory_order_relaxed);
+
+    return cache.store(tile, {});
+  } else if (esim::TILE_FAILURE == status) {
+    /// not stored, the next run retries it.
+    stats.failed.fetch_add(1, std::memory_order_relaxed);
+
+    return false;
+  }
+  stats.fetched_bytes.fetch_add(data.size(), std::memory_order_relaxed);
+
+  /// never seed a maptile the display cannot decode.
+  esim::core::bitmap image;
+  if (!image.load(data.data(), data.size(), pool.allocator())) {
+    stats.invalid.fetch_add(1, std::memory_order_relaxed);
+
+    return false;
+  }
+  if ("raw" == opts.format && !esim::core::encode_raw_image(image, data)) {
+    stats.invalid.fetch_add(1, std::memory_order_relaxed);
+
+    return false;
+  }
+  if ("bc1" == opts.format) {
+    /// uploaded as-is by the display, mipmaps included.
+    esim::core::compressed_bitmap compressed;
+    if (!compressed.encode(image) || !compressed.save(data)) {
+      stats.invalid.fetch_add(1, std::memory_order_relaxed);
+
+      return false;
+    }
+  }
+
+  if (!cache.store(tile, data)) {
+    stats.failed.fetch_add(1, std::memory_order_relaxed);
+
+    return false;
+  }
+  stats.stored.fetch_add(1, std::memory_order_relaxed);
+  stats.stored_bytes.fetch_add(data.size(), std::memory_order_relaxed);
+
+  return true;
+}
+
+void print_progress(size_t total, const tilepack_statistics &stats,
+                    std::chrono::steady_clock::duration elapsed, bool last) noexcept {
+  double seconds = std::max(1e-3, std::chrono::duration<double>(elapsed).count());
+  size_t done = stats.done.load(std::memory_order_relaxed);
+  size_t processed = done - stats.skipped.load(std::memory_order_relaxed);
+  double rate = processed / seconds;
+  double eta = rate > 0.0 ? (total - done) / rate : 0.0;
+
+  std::printf("\r[-] %zu/%zu (%.1f%%) %.1f tiles/s %.2f MB/s in, %.2f MB/s out, eta %.0fs   ",
+              done, total, total > 0 ? 100.0 * done / total : 100.0, rate,
+              stats.fetched_bytes.load(std::memory_order_relaxed) / seconds / 1e6,
+              stats.stored_bytes.load(std::memory_order_relaxed) / seconds / 1e6, eta);
+  if (last) {
+    std::printf("\n[-] %.1fs: %zu stored, %zu skipped, %zu without data, %zu failed, %zu invalid.\n",
+                seconds, stats.stored.load(), stats.skipped.load(), stats.no_data.load(),
+                stats.failed.load(), stats.invalid.load());
+  }
+  std::fflush(stdout);
+}
+
+bool parse_options(int argc, char **argv, tilepack_options &opts) noexcept {
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if ("--force" == arg) {
+      opts.force = true;
+      continue;
+    }
+    if (nullptr == value) {
+
+      return false;
+    }
+
+    ++i;
+    if ("--source" == arg) {
+      opts.source = value;
+    } else if ("--out" == arg) {
+      opts.out = value;
+    } else if ("--bbox" == arg) {
+      if (4 != std::sscanf(value, "%lf,%lf,%lf,%lf", &opts.south, &opts.west, &opts.north, &opts.east)) {
+
+        return false;
+      }
+    } else if ("--lod" == arg) {
+      int n = std::sscanf(value, "%d-%d", &opts.min_lod, &opts.max_lod);
+      if (1 == n) {
+        opts.max_lod = opts.min_lod;
+      } else if (2 != n) {
+
+        return false;
+      }
+    } else if ("--format" == arg) {
+      opts.format = value;
+    } else if ("--threads" == arg) {
+      opts.threads = std::max(1, std::atoi(value));
+    } else if ("--retries" == arg) {
+      opts.retries = std::max(0, std::atoi(value));
+    } else {
+
+      return false;
+    }
+  }
+
+  return !opts.source.empty() && !opts.out.empty() &&
+         opts.south < opts.north && opts.west < opts.east &&
+         0 <= opts.min_lod && opts.min_lod <= opts.max_lod && opts.max_lod < 32 &&
+         ("encoded" == opts.format || "raw" == opts.format || "bc1" == opts.format);
+}
+
+void print_usage() noexcept {
+  std::cerr << "usage: esim_tilepack --source <uri> --out <dir> --bbox <south,west,north,east>\n"
+               "                     --lod <min[-max]> [--format encoded|raw|bc1]\n"
+               "                     [--threads <n>] [--retries <n>] [--force]\n"
+               "  uri: https://host/path/{z}/{x}/{y}, file://path/{z}/{x}/{y}.jpg,\n"
+               "       mbtiles://path/world.mbtiles or cache://path"
+            << std::endl;
+}
@@ -18,6 +18,8 @@ struct frame_info {
   class camera camera;
   class sun    sun;
   bool         is_moving        = {false};
+  /// the time step of imagery series, wrapped by the count of steps.
+  size_t       time_step        = {0};
   bool         debug_show_box   = {false};
   bool         debug_show_scene = {false};
   bool         debug_show_light = {false};
@@ -32,6 +34,7 @@ struct frame_info {
     return (camera != rhs.camera) ||
            (sun != rhs.sun) ||
            (is_moving != rhs.is_moving) ||
+           (time_step != rhs.time_step) ||
            (debug_show_box != rhs.debug_show_box) ||
            (debug_show_light != rhs.debug_show_light) ||
            (debug_show_ndc != rhs.debug_show_ndc) ||
@@ -31,6 +31,10 @@ enum class keycode : keycode_type {
   num3 = 51,
 
   b = 66,
+  p = 80,
+
+  comma = 188,
+  period = 190,
 };
 
 inline constexpr static keycode_type KEY_NONE  = enums::to_raw(keycode::none);
@@ -45,6 +49,9 @@ inline constexpr static keycode_type KEY_ONE  = enums::to_raw(keycode::num1);
 inline constexpr static keycode_type KEY_TWO  = enums::to_raw(keycode::num2);
 inline constexpr static keycode_type KEY_THREE = enums::to_raw(keycode::num3);
 inline constexpr static keycode_type KEY_B  = enums::to_raw(keycode::b);
+inline constexpr static keycode_type KEY_P  = enums::to_raw(keycode::p);
+inline constexpr static keycode_type KEY_COMMA  = enums::to_raw(keycode::comma);
+inline constexpr static keycode_type KEY_PERIOD = enums::to_raw(keycode::period);
 
 /**
  * @brief Esim controller event type.
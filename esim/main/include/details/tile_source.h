@@ -0,0 +1,254 @@
+#ifndef __ESIM_ESIM_DETAILS_TILE_SOURCE_H_
+#define __ESIM_ESIM_DETAILS_TILE_SOURCE_H_
+
+#include "core/transform.h"
+#include "core/utils.h"
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace esim {
+
+/**
+ * @brief Precompiled template to expand the location of a maptile.
+ *
+ * Supported placeholders:
+ *   {z}  the level of details.
+ *   {x}  the row of maptile (north to south), as maptile::x.
+ *   {y}  the column of maptile (west to east), as maptile::y.
+ *   {-x} the TMS-flipped row (south to north).
+ *   {q}  the Bing-style quadkey.
+ * Any other text is kept as-is.
+ */
+class tile_template {
+public:
+  /**
+   * @brief Expand the template with the maptile.
+   *
+   * @param tile specifies the target maptile.
+   * @param out specifies the string where stored in.
+   * @return the reference to expanded string.
+   */
+  std::string &expand(const geo::maptile &tile, std::string &out) const noexcept;
+
+  /**
+   * @brief Expand the template with the maptile.
+   *
+   * @param tile specifies the target maptile.
+   * @return the expanded string.
+   */
+  std::string expand(const geo::maptile &tile) const noexcept;
+
+  /**
+   * @brief Construct a new tile template object.
+   *
+   * @param pattern specifies the pattern with placeholders.
+   */
+  explicit tile_template(std::string_view pattern) noexcept;
+
+  ~tile_template() = default;
+
+private:
+  enum class token : uint8_t {
+    literal,
+    lod,
+    row,
+    column,
+    tms_row,
+    quadkey
+  };
+
+  struct segment {
+    token       type;
+    std::string text;
+  };
+
+  std::vector<segment> segments_;
+  size_t               reserve_;
+};
+
+/**
+ * @brief The interface providing the encoded imagery of maptiles.
+ *
+ * @note fetch may be called from multiple threads at the same time.
+ */
+class tile_source {
+public:
+  enum class status {
+    success,
+    no_data,
+    failure
+  };
+
+  /**
+   * @brief Fetch the encoded image of the maptile.
+   *
+   * @param tile specifies the target maptile.
+   * @param data specifies the buffer where the encoded image stored in.
+   * @return success if fetched, no_data if the source never provides the
+   * maptile, and failure if the fetching may success by retrying.
+   */
+  virtual status fetch(const geo::maptile &tile, std::string &data) noexcept = 0;
+
+  virtual ~tile_source() = default;
+};
+
+inline constexpr static tile_source::status TILE_SUCCESS = tile_source::status::success;
+inline constexpr static tile_source::status TILE_NO_DATA = tile_source::status::no_data;
+inline constexpr static tile_source::status TILE_FAILURE = tile_source::status::failure;
+
+/**
+ * @brief Tile source requesting the maptiles from a https server.
+ *
+ */
+class http_tile_source final : public tile_source {
+public:
+  status fetch(const geo::maptile &tile, std::string &data) noexcept final;
+
+  /**
+   * @brief Construct a new http tile source object.
+   *
+   * @param host specifies the host name of server.
+   * @param url_template specifies the url pattern, see tile_template.
+   */
+  http_tile_source(std::string_view host, std::string_view url_template) noexcept;
+
+  ~http_tile_source() = default;
+
+private:
+  const std::string   host_;
+  const tile_template url_;
+};
+
+/**
+ * @brief Tile source reading the maptiles from a directory of files.
+ *
+ */
+class file_tile_source final : public tile_source {
+public:
+  status fetch(const geo::maptile &tile, std::string &data) noexcept final;
+
+  /**
+   * @brief Construct a new file tile source object.
+   *
+   * @param path_template specifies the file pattern, see tile_template.
+   */
+  explicit file_tile_source(std::string_view path_template) noexcept;
+
+  ~file_tile_source() = default;
+
+private:
+  const tile_template path_;
+};
+
+/**
+ * @brief Tile source reading the maptiles from the on-disk tile cache laid
+ * out as {root}/{z}/{x}/{y}.tile, which esim_tilepack seeds ahead of time.
+ *
+ * @note an empty file records a maptile without data. Maptiles missing in
+ * the cache are fetched from the upstream source if any, those without data
+ * are recorded even if not written back.
+ */
+class cache_tile_source final : public tile_source {
+public:
+  status fetch(const geo::maptile &tile, std::string &data) noexcept final;
+
+  /**
+   * @brief Check if the maptile is stored in the cache, with or without data.
+   *
+   * @param tile specifies the target maptile.
+   * @return true if stored, false otherwise.
+   */
+  bool contains(const geo::maptile &tile) const noexcept;
+
+  /**
+   * @brief Store the maptile into the cache, replaced atomically.
+   *
+   * @param tile specifies the target maptile.
+   * @param data specifies the encoded data, empty if the maptile has no data.
+   * @return true if stored, false otherwise.
+   */
+  bool store(const geo::maptile &tile, std::string_view data) noexcept;
+
+  /**
+   * @brief Construct a new cache tile source object.
+   *
+   * @param root specifies the root directory of cache.
+   * @param upstream specifies the source of missing maptiles, optional.
+   * @param write_back specifies whether to store the upstream maptiles with data.
+   */
+  explicit cache_tile_source(std::string_view root,
+                             uptr<tile_source> upstream = nullptr,
+                             bool write_back = false) noexcept;
+
+  ~cache_tile_source() = default;
+
+private:
+  const tile_template     path_;
+  const uptr<tile_source> upstream_;
+  const bool              write_back_;
+};
+
+#if defined(ESIM_ENABLE_MBTILES)
+
+/**
+ * @brief Tile source reading the maptiles from a MBTiles (SQLite) file.
+ *
+ */
+class mbtiles_tile_source final : public tile_source {
+public:
+  status fetch(const geo::maptile &tile, std::string &data) noexcept final;
+
+  /**
+   * @brief Check if the MBTiles file is opened.
+   *
+   * @return true if opened, false otherwise.
+   */
+  bool is_open() const noexcept;
+
+  /**
+   * @brief Construct a new mbtiles tile source object.
+   *
+   * @param file specifies the path to MBTiles file.
+   */
+  explicit mbtiles_tile_source(std::string_view file) noexcept;
+
+  ~mbtiles_tile_source() noexcept;
+
+private:
+  std::mutex mutex_;
+  rptr<void> db_;
+  rptr<void> stmt_;
+};
+
+#endif
+
+/**
+ * @brief Create a tile source from uri.
+ *
+ * https://host/path/{z}/{x}/{y}  requests from a server.
+ * file://path/{z}/{x}/{y}.jpg    reads from a directory.
+ * mbtiles://path/world.mbtiles   reads from a MBTiles file.
+ * cache://path                   reads from a tile cache directory.
+ *
+ * @param uri specifies the uri of source.
+ * @return the tile source, nullptr if the uri is not supported.
+ */
+uptr<tile_source> make_tile_source(std::string_view uri) noexcept;
+
+/**
+ * @brief Create the tile sources of a time series, one per time step.
+ * Every {t} in the uri is replaced by the date of step, e.g.
+ * file://path/{t}/{z}/{x}/{y}.jpg with the dates 2024-01-01, 2024-01-02.
+ *
+ * @param uri specifies the uri of sources, see make_tile_source.
+ * @param dates specifies the dates of time steps in order.
+ * @return the tile sources, empty if any uri is not supported.
+ */
+std::vector<uptr<tile_source>> make_tile_series(std::string_view uri,
+                                                const std::vector<std::string> &dates) noexcept;
+
+} // namespace esim
+
+#endif
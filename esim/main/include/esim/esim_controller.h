@@ -1,13 +1,12 @@
 #ifndef __ESIM_MAIN_ESIM_ESIM_CONTROLLER_H_
 #define __ESIM_MAIN_ESIM_ESIM_CONTROLLER_H_
 
-#include "core/observer.h"
-#include "core/publisher.h"
 #include "core/utils.h"
 #include "details/information.h"
 #include "details/protocol.h"
 #include "esim_engine.h"
 #include <cassert>
+#include <chrono>
 #include <functional>
 
 namespace esim {
@@ -16,8 +15,7 @@ namespace esim {
  * @brief Earth controller managering the mouse and keyboard input
  * 
  */
-class esim_controller final : public core::publisher,
-                              public core::observer {
+class esim_controller final {
 public:
 
   /**
@@ -101,6 +99,22 @@ public:
    */
   void bind_after_render_process(std::function<void()> callback) noexcept;
 
+  /**
+   * @brief Bind the callback blocking on the window events while nothing to render.
+   * 
+   * @param callback specifies the callback waiting at most the timeout given,
+   * e.g. glfwWaitEventsTimeout.
+   */
+  void bind_idle_process(std::function<void(std::chrono::milliseconds)> callback) noexcept;
+
+  /**
+   * @brief Bind the callback waking up the idle process from any thread,
+   * invoked once a frame requested or stopped.
+   * 
+   * @param callback specifies the callback waking up, e.g. glfwPostEmptyEvent.
+   */
+  void bind_wake_process(std::function<void()> callback) noexcept;
+
   /**
    * @brief Construct a new esim controller object.
    * 
@@ -113,11 +127,10 @@ public:
    */
   ~esim_controller() noexcept;
 
-protected:
-  void update(rptr<void> msg) noexcept final;
+  /// the event handling, defined by the sources, driven alone by the benchmarks.
+  class opaque;
 
 private:
-  class opaque;
   uptr<opaque>      opaque_;
   uptr<esim_engine> engine_;
 };
@@ -1,27 +1,31 @@
 #ifndef __ESIM_MAIN_ESIM_ESIM_ENGINE_H_
 #define __ESIM_MAIN_ESIM_ESIM_ENGINE_H_
 
-#include "core/observer.h"
-#include "core/publisher.h"
+#include "core/channel.h"
 #include "core/utils.h"
 #include "details/information.h"
 #include "details/protocol.h"
+#include <chrono>
 #include <functional>
 
 namespace esim {
 
-class esim_engine final : public core::observer,
-                          public core::publisher {
+class esim_engine final {
 public:
   /**
-   * @brief Start drawing the scene loop.
+   * @brief Start drawing the scene loop, a frame is drawn only if requested
+   * or the scene still settling, e.g. the tiles loading.
    * 
    * @param before_render specifies the callback before rendering.
    * @param after_render specifies the callback after rendering.
-   * @return true if the scene open successfully.
+   * @param idle specifies the callback blocking on the window events while
+   * nothing to draw, at most the timeout given, e.g. glfwWaitEventsTimeout.
+   * The requesters must wake it up, e.g. glfwPostEmptyEvent. If null, the
+   * loop parks on the requests for a few milliseconds instead.
    */
   void start(std::function<void()> before_render,
-             std::function<void()> after_render) noexcept;
+             std::function<void()> after_render,
+             std::function<void(std::chrono::milliseconds)> idle = nullptr) noexcept;
 
   /**
    * @brief Stop the drawing loop.
@@ -35,6 +39,20 @@ public:
    */
   void render() noexcept;
 
+  /**
+   * @brief Obtain the channel of frames rendered, published once per frame.
+   *
+   * @return the channel of frames.
+   */
+  rptr<core::channel<scene::frame_info>> frames() noexcept;
+
+  /**
+   * @brief Request a frame to render, the latest one requested wins.
+   *
+   * @param info specifies the snapshot of frame, shared without copying.
+   */
+  void request(const core::snapshot<scene::frame_info> &info) noexcept;
+
   /**
    * @brief Construct a new esim engine object.
    * 
@@ -47,12 +65,10 @@ public:
    */
   ~esim_engine() noexcept;
 
-protected:
-  void update(rptr<void> msg) noexcept final;
-
 private:
   class opaque;
-  uptr<opaque> opaque_;
+  uptr<opaque>                     opaque_;
+  core::channel<scene::frame_info> frames_;
 };
 
 } // namespace esim
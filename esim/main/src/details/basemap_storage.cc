@@ -1,28 +1,221 @@
 #include "basemap_storage.h"
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <glm/gtx/string_cast.hpp>
 #include <ostream>
-#include <queue>
-#include <regex>
-#include <thread>
-
-#define CPPHTTPLIB_OPENSSL_SUPPORT
-#include <httplib.h>
 
 namespace esim {
 
+namespace details {
+
+constexpr static std::chrono::milliseconds min_retry_delay{1000};
+constexpr static std::chrono::milliseconds max_retry_delay{300000};
+
+struct fetch_result {
+  tile_source::status           status;
+  uptr<core::mip_chain>         mipmaps;
+  uptr<core::compressed_bitmap> compressed;
+  /// the generation of layers composited.
+  size_t                        generation;
+};
+
+/// every layer of the texture array shares the resolution of tiles.
+constexpr static int basemap_layer_size = 256;
+
+/// frames a released layer stays unused, covers the frames queued by driver.
+constexpr static size_t layer_release_latency = 3;
+
+/// fetches in flight at most, the others are requested in later frames.
+/// each of them blocks a fetcher thread of its own.
+constexpr static size_t max_requests = 16;
+
+static tile_source::status composite(const basemap_composition &composition,
+                                     const geo::maptile &tile, core::bitmap &image) noexcept {
+  int    w = image.width(), h = image.height(), channel = image.channel();
+  size_t count = static_cast<size_t>(w) * h;
+  /// layers blend onto rgb, gray is expanded and alpha is dropped.
+  auto buffer = core::bitmap::allocate(count * 3);
+  if (nullptr == buffer) {
+
+    return TILE_FAILURE;
+  }
+  auto rgb = reinterpret_cast<uint8_t *>(buffer.get());
+  auto base = reinterpret_cast<const uint8_t *>(image.buffer());
+  for (size_t i = 0; i < count; ++i) {
+    for (int c = 0; c < 3; ++c) {
+      rgb[i * 3 + c] = base[i * channel + (channel < 3 ? 0 : c)];
+    }
+  }
+
+  std::string          data;
+  std::vector<uint8_t> magnified;
+  for (auto &overlay : composition.overlays) {
+    auto source_tile = tile;
+    while (source_tile.lod > overlay.max_lod) {
+      source_tile = geo::maptile{static_cast<uint8_t>(source_tile.lod - 1), source_tile.x >> 1, source_tile.y >> 1};
+    }
+    auto status = overlay.source->fetch(source_tile, data);
+    if (TILE_NO_DATA == status) {
+      /// the layer never covers the tile, blend nothing.
+      continue;
+    }
+    if (TILE_SUCCESS != status) {
+
+      return status;
+    }
+
+    core::bitmap            layer;
+    core::compressed_bitmap compressed;
+    bool decoded = core::compressed_bitmap::probe(data.data(), data.size())
+                       ? compressed.load(data.data(), data.size()) && compressed.decode(layer)
+                       : layer.load(data.data(), data.size());
+    if (!decoded) {
+
+      return TILE_FAILURE;
+    }
+
+    /// finer tiles than provided magnify the region of the ancestor.
+    auto     pixels = reinterpret_cast<const uint8_t *>(layer.buffer());
+    uint32_t depth = tile.lod - source_tile.lod;
+    if (depth > 0 || layer.width() != w || layer.height() != h) {
+      float scale = 1.0f / static_cast<float>(1u << depth);
+      float rw = static_cast<float>(layer.width()) * scale;
+      float rh = static_cast<float>(layer.height()) * scale;
+      magnified.resize(count * layer.channel());
+      core::image_ops::resample_region(pixels, layer.width(), layer.height(), layer.channel(),
+                                       rw * static_cast<float>(tile.y - (source_tile.y << depth)),
+                                       rh * static_cast<float>(tile.x - (source_tile.x << depth)),
+                                       rw, rh, magnified.data(), w, h);
+      pixels = magnified.data();
+    }
+    core::image_ops::blend(rgb, pixels, layer.channel(), count, overlay.mode, overlay.opacity);
+  }
+  image.adopt(w, h, 3, std::move(buffer));
+
+  return TILE_SUCCESS;
+}
+
+static std::vector<uptr<tile_source>> make_series(uptr<tile_source> source) noexcept {
+  std::vector<uptr<tile_source>> series;
+  series.emplace_back(std::move(source));
+
+  return series;
+}
+
+/// fetches, decodes and composites the basemap, called by a worker.
+static fetch_result fetch(rptr<tile_source> source, const basemap_composition &composition, geo::maptile tile,
+                          const core::bitmap::allocator_type &alloc, bool compress) noexcept {
+  auto generation = composition.generation;
+  std::string data;
+  auto status = source->fetch(tile, data);
+  if (TILE_SUCCESS != status) {
+
+    return fetch_result{status, nullptr, nullptr, generation};
+  }
+
+  /// the texture array holds a single resolution and format,
+  /// other tiles never fit and the parent is used permanently.
+  auto compressed = make_uptr<core::compressed_bitmap>();
+  auto request_data = make_uptr<core::bitmap>();
+  if (core::compressed_bitmap::probe(data.data(), data.size())) {
+    if (!compressed->load(data.data(), data.size())) {
+
+      return fetch_result{TILE_FAILURE, nullptr, nullptr, generation};
+    }
+    if (compressed->width() != basemap_layer_size ||
+        compressed->height() != basemap_layer_size) {
+
+      return fetch_result{TILE_NO_DATA, nullptr, nullptr, generation};
+    }
+    /// compressed tiles persisted in the cache are uploaded as-is, decoded if layers stacked.
+    if (composition.overlays.empty()) {
+      if (!compress) {
+
+        return fetch_result{TILE_NO_DATA, nullptr, nullptr, generation};
+      }
+
+      return fetch_result{TILE_SUCCESS, nullptr, std::move(compressed), generation};
+    }
+    if (!compressed->decode(*request_data)) {
+
+      return fetch_result{TILE_FAILURE, nullptr, nullptr, generation};
+    }
+  } else if (!request_data->load(data.data(), data.size(), alloc)) {
+    /// undecodable data may be a truncated response.
+
+    return fetch_result{TILE_FAILURE, nullptr, nullptr, generation};
+  }
+
+  if (request_data->width() != basemap_layer_size ||
+      request_data->height() != basemap_layer_size) {
+
+    return fetch_result{TILE_NO_DATA, nullptr, nullptr, generation};
+  }
+  if (!composition.overlays.empty()) {
+    if (status = composite(composition, tile, *request_data); TILE_SUCCESS != status) {
+
+      return fetch_result{status, nullptr, nullptr, generation};
+    }
+  }
+  if (compress && compressed->encode(*request_data)) {
+
+    return fetch_result{TILE_SUCCESS, nullptr, std::move(compressed), generation};
+  }
+
+  /// the textures arrive complete, the driver generates no mipmap.
+  auto mipmaps = make_uptr<core::mip_chain>();
+  if (core::image_ops::generate_mip_chain(*request_data, *mipmaps, core::mip_filter::box, true)) {
+
+    return fetch_result{TILE_SUCCESS, std::move(mipmaps), nullptr, generation};
+  }
+
+  return fetch_result{TILE_FAILURE, nullptr, nullptr, generation};
+}
+
+} // namespace details
+
 struct basemap::opaque {
-  bool                            texture_created = {false};
-  gl::texture                     texture;
-  std::atomic<bool>               requested = {false};
-  uptr<core::bitmap>              bitmap = {nullptr};
-  std::future<uptr<core::bitmap>> bitmap_future;
+  bool                                  texture_created = {false};
+  /// accessed by rendering thread only.
+  bool                                  upload_scheduled = {false};
+  /// sampled, and being written by the upload.
+  int                                   layer = {-1};
+  int                                   upload_layer = {-1};
+  size_t                                uploaded_generation = {0};
+  /// the time step, and the slot of storage holding it.
+  size_t                                step = {0};
+  size_t                                slot = {0};
+  /// released with its slot while pending, never uploaded.
+  bool                                  retired = {false};
+  std::atomic<bool>                     requested = {false};
+  std::atomic<bool>                     received = {false};
+  std::atomic<bool>                     no_data = {false};
+  uptr<core::mip_chain>                 mipmaps = {nullptr};
+  uptr<core::compressed_bitmap>         compressed = {nullptr};
+  /// written by loader before received is set.
+  size_t                                generation = {0};
+  size_t                                bitmap_bytes = {0};
+  size_t                                texture_bytes = {0};
+
+  /// failure details, written by loader before requested is reset.
+  uint32_t                              failures = {0};
+  std::chrono::steady_clock::time_point retry_at;
+
+  /// lru details, accessed by rendering thread only.
+  bool                                                          in_lru = {false};
+  size_t                                                        last_used = {0};
+  std::list<std::pair<geo::maptile, rptr<basemap>>>::iterator lru_it;
 };
 
 bool basemap::is_ready() const noexcept {
 
-  return nullptr != opaque_->bitmap;
+  return opaque_->received.load(std::memory_order_acquire);
+}
+
+bool basemap::is_uploaded() const noexcept {
+
+  return opaque_->texture_created;
 }
 
 bool basemap::is_requested() const noexcept {
@@ -30,88 +223,363 @@ bool basemap::is_requested() const noexcept {
   return opaque_->requested.load(std::memory_order_acquire);
 }
 
+bool basemap::is_no_data() const noexcept {
+
+  return opaque_->no_data.load(std::memory_order_acquire);
+}
+
+bool basemap::is_requestable(std::chrono::steady_clock::time_point now) const noexcept {
+  if (is_requested() || is_no_data()) {
+
+    return false;
+  }
+
+  return 0 == opaque_->failures || now >= opaque_->retry_at;
+}
+
 void basemap::mark_requested() noexcept {
   opaque_->requested.store(true, std::memory_order_release);
 }
 
-void basemap::request(std::string host, std::string url) noexcept {
-  assert(nullptr != opaque_);
-  const static httplib::Headers headers = {
-      {"Accept-Encoding", "gzip, deflate, br"},
-      {"Connections", "keep-alive"},
-      {"User-Agent", "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/101.0.4951.67 Safari/537.36"}
-  };
-  opaque_->bitmap_future = std::async(std::launch::async, [=]() -> uptr<core::bitmap> {
-    httplib::SSLClient cli(host.data());
-    cli.set_connection_timeout(std::chrono::seconds(10));
-    if (auto res = cli.Get(url.data(), headers)) {
-      auto request_data = make_uptr<core::bitmap>();
-      request_data->load(res->body.data(), res->body.size());
-      return request_data;
-    } else {
-      std::cerr << res.error() << std::endl;
-      return nullptr;
-    }
-  });
-}
 
-void basemap::receive() noexcept {
-  opaque_->bitmap = opaque_->bitmap_future.get();
+tile_source::status basemap::load(rptr<tile_source> source, const basemap_composition &composition,
+                                  geo::maptile tile, const core::bitmap::allocator_type &alloc,
+                                  bool compress) noexcept {
+  using namespace std::chrono;
+  assert(nullptr != opaque_);
+  assert(nullptr != source);
+  auto [status, mipmaps, compressed, generation] = details::fetch(source, composition, tile, alloc, compress);
+
+  switch (status) {
+  case TILE_SUCCESS:
+    opaque_->mipmaps = std::move(mipmaps);
+    opaque_->compressed = std::move(compressed);
+    opaque_->bitmap_bytes = nullptr != opaque_->compressed ? opaque_->compressed->size()
+                                                           : opaque_->mipmaps->data.size();
+    opaque_->failures = 0;
+    opaque_->generation = generation;
+    opaque_->received.store(true, std::memory_order_release);
+    /// requestable again once the layers changed.
+    opaque_->requested.store(false, std::memory_order_release);
+    break;
 
-  if (nullptr == opaque_->bitmap) {
-    /// request again
+  case TILE_NO_DATA:
+    /// never request again, the parent is used permanently.
+    /// a recomposited one keeps the layer uploaded before, evictable as usual.
+    opaque_->no_data.store(true, std::memory_order_release);
     opaque_->requested.store(false, std::memory_order_release);
+    break;
+
+  case TILE_FAILURE: {
+    /// request again after exponential backoff.
+    auto shift = std::min<uint32_t>(opaque_->failures++, 16);
+    auto delay = std::min<milliseconds>(details::min_retry_delay * (1 << shift),
+                                        details::max_retry_delay);
+    opaque_->retry_at = steady_clock::now() + delay;
+    opaque_->requested.store(false, std::memory_order_release);
+  } break;
   }
+
+  return status;
 }
 
-rptr<const gl::texture> basemap::texture() noexcept {
-  if (!opaque_->texture_created) {
-    generate_texture();
+int basemap::layer() const noexcept {
+
+  return opaque_->texture_created ? opaque_->layer : -1;
+}
+
+size_t basemap::upload(gl::texture_array &textures) noexcept {
+  assert(opaque_->upload_layer >= 0);
+  auto layer = static_cast<size_t>(opaque_->upload_layer);
+  /// mip chain is built by the loader, nothing to generate here.
+  if (auto compressed = opaque_->compressed.get(); nullptr != compressed) {
+    if (!textures.store(layer, *compressed)) {
+
+      return 0;
+    }
+  } else if (auto mipmaps = opaque_->mipmaps.get(); nullptr != mipmaps) {
+    if (!textures.store(layer, *mipmaps)) {
+
+      return 0;
+    }
+  } else {
+
+    return 0;
   }
-  return &opaque_->texture;
+  opaque_->texture_bytes = textures.layer_bytes();
+
+  return opaque_->texture_bytes;
 }
 
-void basemap::generate_texture() noexcept {
-  auto bitmap = opaque_->bitmap.get();
-  if (nullptr != bitmap) {
-    assert(opaque_->texture.load(*bitmap, 0, gl::texture::options{GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR}));
-    opaque_->texture_created = true;
+void basemap::mark_uploaded(bool keep_bitmap) noexcept {
+  opaque_->texture_created = true;
+  opaque_->received.store(false, std::memory_order_release);
+  if (!keep_bitmap) {
+    release_bitmap();
   }
 }
 
+size_t basemap::release_bitmap() noexcept {
+  size_t released = opaque_->bitmap_bytes;
+  opaque_->mipmaps.reset();
+  opaque_->compressed.reset();
+  opaque_->bitmap_bytes = 0;
+
+  return released;
+}
+
+size_t basemap::bitmap_bytes() const noexcept {
+
+  return opaque_->bitmap_bytes;
+}
+
+size_t basemap::texture_bytes() const noexcept {
+
+  return opaque_->texture_bytes;
+}
+
 basemap::basemap() noexcept
     : opaque_{make_uptr<opaque>()} {}
 
-std::pair<rptr<basemap>, basemap_texinfo>
-basemap_storage::get(const geo::maptile &tile, bool perform_reqest, basemap_texinfo texinfo) noexcept {
+basemap_binding basemap_storage::resolve(const geo::maptile &tile) const noexcept {
+  auto target = clamp_lod(tile);
+  auto &maps = slots_[current_slot_].maps;
+  while (target.lod < maps.size()) {
+    auto &map = maps[target.lod];
+    if (auto it = map.find(target); it != map.end() && it->second->is_uploaded()) {
+
+      return bind(tile, target, it->second.get());
+    }
+    if (target.lod == 0) {
+      break;
+    }
+    target = geo::maptile{static_cast<uint8_t>(target.lod - 1), target.x >> 1, target.y >> 1};
+  }
+
+  return basemap_binding{tile, nullptr, basemap_texinfo{1.0f, glm::vec2{0.0f}}};
+}
+
+basemap_binding basemap_storage::bind(const geo::maptile &tile, const geo::maptile &ancestor,
+                                      rptr<basemap> map) noexcept {
   using namespace glm;
-  if (tile.lod >= maps_.size()) {
+  assert(tile.lod >= ancestor.lod);
+  /// the tile covers [offset, offset + scale] of the ancestor.
+  uint32_t depth = tile.lod - ancestor.lod;
+  float    scale = 1.0f / static_cast<float>(1u << depth);
+  vec2     offset = scale * vec2(tile.y - (ancestor.y << depth), tile.x - (ancestor.x << depth));
 
-    return get_from_parent(tile, perform_reqest, texinfo);
+  return basemap_binding{ancestor, map, basemap_texinfo{scale, offset}};
+}
+
+void basemap_storage::request(const geo::maptile &tile, bool perform_reqest) noexcept {
+  request(current_slot_, tile, perform_reqest, false);
+}
+
+void basemap_storage::prefetch(const geo::maptile &tile) noexcept {
+  for (size_t i = 1; i < slots_.size(); ++i) {
+    /// the textures of all steps but the current one are prefetched.
+    if (texture_bytes_.load(std::memory_order_relaxed) - slots_[current_slot_].texture_bytes >=
+        budget_.prefetch_bytes) {
+
+      return;
+    }
+    if (auto slot = find_slot((slots_[current_slot_].step + i) % sources_.size()); nullptr != slot) {
+      request(static_cast<size_t>(slot - slots_.data()), tile, true, true);
+    }
+  }
+}
+
+bool basemap_storage::set_time(size_t step) noexcept {
+  step %= sources_.size();
+  if (step == slots_[current_slot_].step) {
+
+    return false;
+  }
+
+  /// slots out of the window are released, and assigned to the steps entering it.
+  auto in_window = [&](size_t s) {
+    return s != SIZE_MAX && (s + sources_.size() - step) % sources_.size() < slots_.size();
+  };
+  for (auto &slot : slots_) {
+    if (!in_window(slot.step)) {
+      release_slot(slot);
+    }
   }
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    size_t s = (step + i) % sources_.size();
+    if (nullptr != find_slot(s)) {
+      continue;
+    }
+    for (auto &slot : slots_) {
+      if (SIZE_MAX == slot.step) {
+        slot.step = s;
+        break;
+      }
+    }
+  }
+  current_slot_ = static_cast<size_t>(find_slot(step) - slots_.data());
+
+  return true;
+}
+
+size_t basemap_storage::time() const noexcept {
+
+  return slots_[current_slot_].step;
+}
+
+size_t basemap_storage::steps() const noexcept {
+
+  return sources_.size();
+}
 
-  auto &target = maps_[tile.lod][tile];
-  if (nullptr == target) {
-    target = make_uptr<basemap>();
+void basemap_storage::request(size_t slot, const geo::maptile &tile, bool perform_reqest,
+                              bool prefetch) noexcept {
+  if (0 == max_lod_) {
+
+    return;
   }
 
-  if (!target->is_ready()) {
-    if (perform_reqest && !target->is_requested() &&
-        request_queue_.try_push(std::make_pair(target.get(), tile))) {
+  auto &maps = slots_[slot].maps;
+  for (auto target = clamp_lod(tile);;
+       target = geo::maptile{static_cast<uint8_t>(target.lod - 1), target.x >> 1, target.y >> 1}) {
+    auto &node = maps[target.lod][target];
+    if (nullptr == node) {
+      node = make_uptr<basemap>();
+      node->opaque_->step = slots_[slot].step;
+      node->opaque_->slot = slot;
+    }
+
+    /// uploaded basemaps are requested again to recomposite once the layers changed.
+    bool uploaded = node->is_uploaded();
+    if (node->is_ready()) {
+      schedule_upload(target, node.get());
+    } else if (perform_reqest &&
+               (!uploaded || node->opaque_->uploaded_generation != composition_.generation) &&
+               node->is_requestable(std::chrono::steady_clock::now()) &&
+               requests_.pending() < details::max_requests) {
+      /// the pixels kept are replaced by the recomposited ones.
+      if (size_t bytes = node->release_bitmap(); bytes > 0) {
+        bitmap_count_.fetch_sub(1, std::memory_order_relaxed);
+        bitmap_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+      }
 
-      target->mark_requested();
+      node->mark_requested();
+      load(node.get(), target, prefetch);
     }
-    if (tile.lod == 0) {
+    /// prefetched textures are kept as if drawn, until the step is passed.
+    if (uploaded && prefetch) {
+      touch(target, node.get());
+    }
+    /// the parent is used until uploaded.
+    if (uploaded || target.lod == 0) {
 
-      return std::make_pair(nullptr, texinfo);
-    } else {
+      return;
+    }
+  }
+}
+
+void basemap_storage::use(const basemap_binding &binding) noexcept {
+  if (nullptr != binding.map) {
+    touch(binding.tile, binding.map);
+  }
+}
 
-      return get_from_parent(tile, perform_reqest, texinfo);
+void basemap_storage::bind_listener(listener_type listener) noexcept {
+  listener_ = std::move(listener);
+}
+
+size_t basemap_storage::add_layer(basemap_layer layer) noexcept {
+  assert(nullptr != layer.source);
+  layers_.emplace_back(std::move(layer));
+  compose();
+
+  return layers_.size() - 1;
+}
+
+void basemap_storage::update_layer(size_t index, float opacity, bool visible) noexcept {
+  assert(index < layers_.size());
+  auto &layer = layers_[index];
+  if (layer.opacity == opacity && layer.visible == visible) {
+
+    return;
+  }
+
+  layer.opacity = opacity;
+  layer.visible = visible;
+  compose();
+}
+
+void basemap_storage::bind_textures(GLuint location) const noexcept {
+  textures_->bind(location);
+}
+
+size_t basemap_storage::max_lod() const noexcept {
+
+  return max_lod_;
+}
+
+void basemap_storage::trim() noexcept {
+  /// retired basemaps are destroyed once the loader and uploader finished with them.
+  retired_.erase(std::remove_if(retired_.begin(), retired_.end(), [](const uptr<basemap> &node) {
+    return !node->opaque_->upload_scheduled && (!node->is_requested() || node->is_no_data());
+  }), retired_.end());
+
+  while (!released_layers_.empty() &&
+         released_layers_.front().second + details::layer_release_latency <= frame_) {
+    free_layers_.emplace_back(released_layers_.front().first);
+    released_layers_.pop_front();
+  }
+
+  /// cpu pixels are never sampled after uploaded,
+  /// release them from the coldest one.
+  if (budget_.keep_bitmaps) {
+    for (auto it = lru_.rbegin(); it != lru_.rend() &&
+         bitmap_bytes_.load(std::memory_order_relaxed) > budget_.bitmap_bytes; ++it) {
+      if (is_busy(it->second)) {
+        continue;
+      }
+      if (size_t bytes = it->second->release_bitmap(); bytes > 0) {
+        bitmap_count_.fetch_sub(1, std::memory_order_relaxed);
+        bitmap_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+      }
     }
-  } else {
-    
-    return std::make_pair(target.get(), texinfo);
   }
+
+  size_t reserved = std::min(budget_.reserved_layers, textures_->layers() / 4);
+  for (auto it = lru_.end(); it != lru_.begin() &&
+       (texture_bytes_.load(std::memory_order_relaxed) > budget_.texture_bytes ||
+        free_layers_.size() + released_layers_.size() < reserved);) {
+    auto coldest = std::prev(it);
+    if (coldest->second->opaque_->last_used == frame_) {
+      /// everything left is in use by the current frame.
+      break;
+    }
+    if (is_busy(coldest->second)) {
+      /// being recomposited, evicted once uploaded.
+      it = coldest;
+      continue;
+    }
+    evict(coldest);
+  }
+
+  ++frame_;
+}
+
+basemap_statistics basemap_storage::statistics() const noexcept {
+
+  return basemap_statistics{texture_count_.load(std::memory_order_relaxed),
+                            texture_bytes_.load(std::memory_order_relaxed),
+                            bitmap_count_.load(std::memory_order_relaxed),
+                            bitmap_bytes_.load(std::memory_order_relaxed),
+                            requested_count_.load(std::memory_order_relaxed),
+                            succeeded_count_.load(std::memory_order_relaxed),
+                            failed_count_.load(std::memory_order_relaxed),
+                            no_data_count_.load(std::memory_order_relaxed)};
+}
+
+size_t basemap_storage::in_flight() const noexcept {
+
+  return requests_.pending();
 }
 
 bool basemap_storage::is_working() const noexcept {
@@ -123,59 +591,230 @@ void basemap_storage::stop() noexcept {
   is_working_.store(false, std::memory_order_release);
 }
 
-basemap_storage::basemap_storage(std::string_view host, 
-                                 std::string_view url_template,
-                                 size_t max_lod) noexcept
-    : host_{host}, url_template_{url_template}, request_queue_{16},
-      maps_(max_lod), is_working_{true} {
-
-  std::thread([=]() {
-    const std::regex z("\\{z\\}"), x("\\{x\\}"), y("\\{y\\}");
-    std::queue<rptr<basemap>> pending;
-    std::pair<rptr<basemap>, geo::maptile> item;
-    while (is_working()) {
-      size_t pending_count = 0;
-
-      while (request_queue_.try_pop(item)) {
-        ++pending_count;
-        auto &[node, tile] = item;
-        std::string url = url_template_;
-        url = std::regex_replace(url, z, std::to_string(tile.lod).c_str());
-        url = std::regex_replace(url, x, std::to_string(tile.x).c_str());
-        url = std::regex_replace(url, y, std::to_string(tile.y).c_str());
-        node->request(host_, url);
-        pending.emplace(node);
-      }
+basemap_storage::basemap_storage(uptr<tile_source> source,
+                                 size_t max_lod,
+                                 rptr<upload_scheduler> scheduler,
+                                 basemap_budget budget) noexcept
+    : basemap_storage{details::make_series(std::move(source)), max_lod, scheduler, budget} {}
+
+basemap_storage::basemap_storage(std::vector<uptr<tile_source>> series,
+                                 size_t max_lod,
+                                 rptr<upload_scheduler> scheduler,
+                                 basemap_budget budget) noexcept
+    : sources_{std::move(series)}, scheduler_{scheduler}, bitmap_pool_{256 * 256 * 4, 64},
+      fetchers_{details::max_requests}, requests_{&fetchers_}, is_working_{true}, max_lod_{max_lod}, current_slot_{0}, budget_{budget}, frame_{0},
+      texture_count_{0}, texture_bytes_{0}, bitmap_count_{0}, bitmap_bytes_{0},
+      requested_count_{0}, succeeded_count_{0}, failed_count_{0}, no_data_count_{0} {
+  assert(!sources_.empty());
+  /// the current step and the steps prefetched, each step once at most.
+  slots_.resize(std::min(budget_.prefetch_steps + 1, sources_.size()));
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    slots_[i].step = i;
+    slots_[i].texture_bytes = 0;
+    slots_[i].maps.resize(max_lod_);
+  }
+  size_t layers = budget_.texture_bytes /
+                  gl::texture_array::layer_bytes(details::basemap_layer_size, budget_.compress_textures);
+  layers = std::clamp<size_t>(layers, 1, std::max<size_t>(1, gl::texture_array::max_layers()));
+  textures_ = make_uptr<gl::texture_array>(details::basemap_layer_size, layers, budget_.compress_textures);
+  /// the lowest layers are acquired first.
+  for (size_t i = layers; i > 0; --i) {
+    free_layers_.emplace_back(static_cast<int>(i - 1));
+  }
+}
 
-      if (pending_count == 0) {
-        std::this_thread::yield();
-      } else {
-        while (!pending.empty()) {
-          auto node = pending.front(); pending.pop();
-          node->receive();
-        }
+basemap_storage::~basemap_storage() noexcept {
+  stop();
+  requests_.wait();
+}
+
+geo::maptile basemap_storage::clamp_lod(const geo::maptile &tile) const noexcept {
+  auto target = tile;
+  while (target.lod > 0 && target.lod >= max_lod_) {
+    target = geo::maptile{static_cast<uint8_t>(target.lod - 1), target.x >> 1, target.y >> 1};
+  }
+
+  return target;
+}
+
+void basemap_storage::schedule_upload(const geo::maptile &tile, rptr<basemap> target) noexcept {
+  auto &details = *target->opaque_;
+  if (details.upload_scheduled) {
+
+    return;
+  }
+
+  /// written into another layer, a recomposited basemap samples the stale one until uploaded.
+  details.upload_layer = acquire_layer();
+  if (details.upload_layer < 0) {
+    /// scheduled again once a layer released.
+
+    return;
+  }
+
+  details.upload_scheduled = true;
+  /// never evicted while pending, see is_busy.
+  scheduler_->schedule([this, target]() { return target->upload(*textures_); },
+                       [this, tile, target](size_t bytes) {
+    auto &details = *target->opaque_;
+    details.upload_scheduled = false;
+    if (0 == bytes || details.retired) {
+      /// scheduled again once used.
+      release_layer(details.upload_layer);
+      details.upload_layer = -1;
+
+      return;
+    }
+    if (target->is_uploaded()) {
+      /// recomposited, the count and bytes are unchanged.
+      release_layer(details.layer);
+    } else {
+      texture_count_.fetch_add(1, std::memory_order_relaxed);
+      texture_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+      slots_[details.slot].texture_bytes += bytes;
+    }
+    details.layer = details.upload_layer;
+    details.upload_layer = -1;
+    details.uploaded_generation = details.generation;
+    target->mark_uploaded(budget_.keep_bitmaps);
+    /// evictable even if never drawn.
+    touch(tile, target);
+    /// only the pixels kept after uploaded are accounted.
+    if (size_t kept = target->bitmap_bytes(); kept > 0) {
+      bitmap_count_.fetch_add(1, std::memory_order_relaxed);
+      bitmap_bytes_.fetch_add(kept, std::memory_order_relaxed);
+    }
+    /// the steps prefetched are bound once switched to.
+    if (listener_ && details.slot == current_slot_) {
+      listener_(tile, target);
+    }
+  });
+}
+
+rptr<basemap_storage::time_slot> basemap_storage::find_slot(size_t step) noexcept {
+  for (auto &slot : slots_) {
+    if (slot.step == step) {
+
+      return &slot;
+    }
+  }
+
+  return nullptr;
+}
+
+void basemap_storage::release_slot(time_slot &slot) noexcept {
+  for (auto &map : slot.maps) {
+    for (auto &[tile, node] : map) {
+      unload(node.get());
+      if (is_busy(node.get())) {
+        node->opaque_->retired = true;
+        retired_.emplace_back(std::move(node));
       }
+    }
+    map.clear();
+  }
+  slot.step = SIZE_MAX;
+  slot.texture_bytes = 0;
+}
 
+void basemap_storage::compose() noexcept {
+  composition_.overlays.clear();
+  for (auto &layer : layers_) {
+    if (layer.visible && layer.opacity > 0.0f) {
+      composition_.overlays.emplace_back(
+          basemap_composition::overlay{layer.source.get(), layer.mode, layer.opacity, layer.max_lod});
     }
-  }).detach();
+  }
+  ++composition_.generation;
 }
 
-basemap_storage::~basemap_storage() noexcept {
-  stop();
+void basemap_storage::load(rptr<basemap> node, const geo::maptile &tile, bool prefetch) noexcept {
+  requested_count_.fetch_add(1, std::memory_order_relaxed);
+  auto source = sources_[node->opaque_->step].get();
+  /// the node is never touched once loaded, it may be freed as soon as not requested.
+  requests_.submit([=, composition = composition_]() {
+    if (!is_working()) {
+
+      return;
+    }
+
+    switch (node->load(source, composition, tile, bitmap_pool_.allocator(), budget_.compress_textures)) {
+    case TILE_SUCCESS:
+      succeeded_count_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case TILE_NO_DATA:
+      no_data_count_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case TILE_FAILURE:
+      failed_count_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    }
+  }, prefetch ? core::task_priority::low : core::task_priority::normal);
 }
 
-std::pair<rptr<basemap>, basemap_texinfo> basemap_storage::get_from_parent(const geo::maptile &tile,
-                                                                           bool perform_reqest,
-                                                                           basemap_texinfo texinfo) noexcept {
-  using namespace glm;
-  geo::maptile parent_tile{static_cast<uint8_t>(tile.lod - 1),
-                           tile.x >> 1, tile.y >> 1};
-  texinfo.scale *= 0.5f;
-  texinfo.offset *= 0.5f;
-  texinfo.offset += 0.5f * vec2(tile.y - (parent_tile.y << 1),
-                                tile.x - (parent_tile.x << 1));
-
-  return get(parent_tile, perform_reqest, texinfo);
+bool basemap_storage::is_busy(rptr<basemap> target) noexcept {
+
+  return target->opaque_->upload_scheduled || target->is_requested() || target->is_ready();
+}
+
+int basemap_storage::acquire_layer() noexcept {
+  if (free_layers_.empty()) {
+
+    return -1;
+  }
+
+  int layer = free_layers_.back();
+  free_layers_.pop_back();
+
+  return layer;
+}
+
+void basemap_storage::release_layer(int layer) noexcept {
+  if (layer >= 0) {
+    released_layers_.emplace_back(layer, frame_);
+  }
+}
+
+void basemap_storage::touch(const geo::maptile &tile, rptr<basemap> target) noexcept {
+  auto &details = *target->opaque_;
+  details.last_used = frame_;
+  if (details.in_lru) {
+    lru_.splice(lru_.begin(), lru_, details.lru_it);
+  } else {
+    lru_.emplace_front(tile, target);
+    details.lru_it = lru_.begin();
+    details.in_lru = true;
+  }
+}
+
+void basemap_storage::unload(rptr<basemap> target) noexcept {
+  auto &details = *target->opaque_;
+  /// pixels of busy basemaps are written by loader, and never accounted.
+  if (!is_busy(target)) {
+    if (size_t bytes = target->release_bitmap(); bytes > 0) {
+      bitmap_count_.fetch_sub(1, std::memory_order_relaxed);
+      bitmap_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+  }
+  if (target->is_uploaded()) {
+    texture_count_.fetch_sub(1, std::memory_order_relaxed);
+    texture_bytes_.fetch_sub(target->texture_bytes(), std::memory_order_relaxed);
+    slots_[details.slot].texture_bytes -= target->texture_bytes();
+    release_layer(details.layer);
+    details.texture_created = false;
+  }
+  if (details.in_lru) {
+    lru_.erase(details.lru_it);
+    details.in_lru = false;
+  }
+}
+
+void basemap_storage::evict(lru_type::iterator it) noexcept {
+  auto [tile, target] = *it;
+  unload(target);
+  /// evicted basemap is never pending in loader, see is_busy,
+  /// it is safe to destroy here and request again later.
+  slots_[target->opaque_->slot].maps[tile.lod].erase(tile);
 }
 
 } // namespace esim
@@ -2,41 +2,129 @@
 #define __ESIM_ESIM_SOURCE_BASEMAP_STORAGE_H_
 
 #include "core/bitmap.h"
-#include "core/fifo.h"
+#include "core/buffer_pool.h"
+#include "core/compressed_bitmap.h"
+#include "core/executor.h"
+#include "core/flat_map.h"
+#include "core/image_ops.h"
 #include "core/transform.h"
 #include "core/utils.h"
-#include "glapi/texture.h"
+#include "details/tile_source.h"
+#include "details/upload_scheduler.h"
+#include "glapi/texture_array.h"
 #include <atomic>
-#include <future>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <glm/vec4.hpp>
-#include <string>
-#include <string_view>
+#include <list>
 #include <vector>
 
 namespace esim {
 
+/**
+ * @brief The visible layers stacked onto the basemap source, snapshot for the workers.
+ *
+ */
+struct basemap_composition {
+  struct overlay {
+    rptr<tile_source> source;
+    core::blend_mode  mode;
+    float             opacity;
+    uint8_t           max_lod;
+  };
+
+  std::vector<overlay> overlays;
+  /// bumped once the layers changed.
+  size_t               generation = 0;
+};
+
 class basemap {
 public:
+  /**
+   * @brief Check if the received pixels are waiting to upload, either the first
+   * or a recomposited one.
+   *
+   * @return true if ready, false otherwise.
+   */
   bool is_ready() const noexcept;
 
+  bool is_uploaded() const noexcept;
+
   bool is_requested() const noexcept;
 
+  /**
+   * @brief Check if the source never provides the basemap.
+   *
+   * @return true if no data, false otherwise.
+   */
+  bool is_no_data() const noexcept;
+
+  /**
+   * @brief Check if the basemap can be requested, i.e. not requested yet,
+   * not marked as no data and not backing off from a failure.
+   *
+   * @param now specifies the current time.
+   * @return true if requestable, false otherwise.
+   */
+  bool is_requestable(std::chrono::steady_clock::time_point now) const noexcept;
+
   void mark_requested() noexcept;
 
-  void request(std::string host, std::string url) noexcept;
+  /**
+   * @brief Fetch, decode and composite the basemap, then mark it received,
+   * called by a worker.
+   *
+   * @param source specifies the tile source.
+   * @param composition specifies the layers composited onto the source.
+   * @param tile specifies the target maptile.
+   * @param alloc specifies the allocator of decoded pixels.
+   * @param compress specifies whether to transcode into BC1 with mipmaps.
+   * @return the status of fetching.
+   */
+  tile_source::status load(rptr<tile_source> source, const basemap_composition &composition, geo::maptile tile,
+                           const core::bitmap::allocator_type &alloc, bool compress) noexcept;
+
+  /**
+   * @brief Obtain the layer of basemap in the texture array.
+   *
+   * @return the layer, -1 if not uploaded.
+   */
+  int layer() const noexcept;
 
-  void receive() noexcept;
+  /**
+   * @brief Upload the received bitmap into the layer acquired for uploading,
+   * may be called by the loader thread.
+   *
+   * @param textures specifies the texture array of basemaps.
+   * @return the bytes of the layer uploaded, 0 if nothing uploaded.
+   */
+  size_t upload(gl::texture_array &textures) noexcept;
 
-  rptr<const gl::texture> texture() noexcept;
+  /**
+   * @brief Mark the texture as usable once the upload is visible to the rendering thread.
+   *
+   * @param keep_bitmap specifies whether to keep the cpu pixels after uploaded.
+   */
+  void mark_uploaded(bool keep_bitmap) noexcept;
+
+  /**
+   * @brief Release the cpu pixels of the basemap.
+   *
+   * @return the bytes released.
+   */
+  size_t release_bitmap() noexcept;
+
+  size_t bitmap_bytes() const noexcept;
+
+  size_t texture_bytes() const noexcept;
 
   basemap() noexcept;
 
   ~basemap() = default;
 
 private:
-  void generate_texture() noexcept;
-
-private:
+  friend class basemap_storage;
   struct opaque;
   uptr<opaque>      opaque_;
 };
@@ -46,32 +134,309 @@ struct basemap_texinfo {
   glm::vec2 offset;
 };
 
+/**
+ * @brief The basemap resolved for a tile, its own or the nearest uploaded ancestor's.
+ *
+ */
+struct basemap_binding {
+  /// the tile of the basemap bound.
+  geo::maptile    tile;
+  rptr<basemap>   map;
+  basemap_texinfo texinfo;
+};
+
+/**
+ * @brief A layer of imagery stacked onto the basemaps in order.
+ *
+ */
+struct basemap_layer {
+  uptr<tile_source> source;
+  core::blend_mode  mode    = core::blend_mode::normal;
+  float             opacity = 1.0f;
+  /// the finest lod provided, finer tiles magnify the region of it.
+  uint8_t           max_lod = UINT8_MAX;
+  bool              visible = true;
+};
+
+/**
+ * @brief The memory budget of basemaps.
+ *
+ */
+struct basemap_budget {
+  size_t texture_bytes = 256UL << 20;
+  size_t bitmap_bytes  = 64UL << 20;
+  bool   keep_bitmaps  = false;
+  /// transcode into BC1 on loader, 1/6 memory of RGB.
+  bool   compress_textures = true;
+  /// layers of the texture array kept free for the uploads of next frames.
+  size_t reserved_layers = 32;
+  /// time steps after the current one requested ahead, see basemap_storage::prefetch.
+  size_t prefetch_steps = 4;
+  /// textures of the steps prefetched, beyond which nothing more is prefetched.
+  size_t prefetch_bytes = 64UL << 20;
+};
+
+/**
+ * @brief The live statistics of basemaps.
+ *
+ */
+struct basemap_statistics {
+  size_t texture_count;
+  size_t texture_bytes;
+  size_t bitmap_count;
+  size_t bitmap_bytes;
+
+  /// request counters since constructed.
+  size_t requested;
+  size_t succeeded;
+  size_t failed;
+  size_t no_data;
+};
+
 class basemap_storage final {
 public:
-  std::pair<rptr<basemap>, basemap_texinfo> get(const geo::maptile &tile,
-                                                bool perform_reqest,
-                                                basemap_texinfo texinfo = basemap_texinfo{1.0f, glm::vec2{0.0}}) noexcept;
+  /**
+   * @brief Notified by the rendering thread once the basemap of tile is uploaded.
+   *
+   */
+  typedef std::function<void(const geo::maptile &, rptr<basemap>)> listener_type;
+
+  /**
+   * @brief Find the uploaded basemap of the tile or its nearest ancestor.
+   *
+   * @param tile specifies the target maptile.
+   * @return the binding, no basemap bound if none uploaded.
+   */
+  basemap_binding resolve(const geo::maptile &tile) const noexcept;
+
+  /**
+   * @brief Bind the basemap of ancestor, or of the tile itself, to the tile.
+   *
+   * @param tile specifies the target maptile.
+   * @param ancestor specifies the maptile of basemap.
+   * @param map specifies the basemap.
+   * @return the binding.
+   */
+  static basemap_binding bind(const geo::maptile &tile, const geo::maptile &ancestor,
+                              rptr<basemap> map) noexcept;
+
+  /**
+   * @brief Request the basemaps of tile and its ancestors until an uploaded one.
+   * The received basemaps are scheduled to upload even if not performing request.
+   *
+   * @param tile specifies the target maptile.
+   * @param perform_reqest specifies whether to request from the source.
+   */
+  void request(const geo::maptile &tile, bool perform_reqest) noexcept;
+
+  /**
+   * @brief Request the basemaps of tile in the time steps following the current one,
+   * nearest first, until the textures prefetched exceed the budget.
+   *
+   * @param tile specifies the target maptile.
+   */
+  void prefetch(const geo::maptile &tile) noexcept;
+
+  /**
+   * @brief Switch to the time step, the basemaps prefetched are drawn at once
+   * and the steps out of the prefetched window are released.
+   *
+   * @param step specifies the time step, wrapped by the count of steps.
+   * @return true if switched, false if already the current one.
+   */
+  bool set_time(size_t step) noexcept;
+
+  size_t time() const noexcept;
+
+  /**
+   * @brief Obtain the count of time steps in the series.
+   *
+   * @return the count of steps.
+   */
+  size_t steps() const noexcept;
+
+  /**
+   * @brief Mark the bound basemap as used by the current frame.
+   *
+   * @param binding specifies the binding.
+   */
+  void use(const basemap_binding &binding) noexcept;
+
+  void bind_listener(listener_type listener) noexcept;
+
+  /**
+   * @brief Stack a layer onto the basemaps, composited by the workers into the
+   * same texture so that a frame still samples once per tile.
+   *
+   * @param layer specifies the layer, above the layers added before.
+   * @return the index of layer.
+   */
+  size_t add_layer(basemap_layer layer) noexcept;
+
+  /**
+   * @brief Update the blending of layer, the uploaded basemaps are recomposited
+   * once requested again and the stale textures are drawn until then.
+   *
+   * @param index specifies the index of layer.
+   * @param opacity specifies the opacity.
+   * @param visible specifies the visibility.
+   */
+  void update_layer(size_t index, float opacity, bool visible) noexcept;
+
+  /**
+   * @brief Bind the texture array of all basemaps, once per frame.
+   *
+   * @param location specifies the location to bind.
+   */
+  void bind_textures(GLuint location = 0) const noexcept;
+
+  /**
+   * @brief Obtain the count of levels stored, finer tiles use the finest level.
+   *
+   * @return the count of levels.
+   */
+  size_t max_lod() const noexcept;
+
+  /**
+   * @brief Evict the least recently used basemaps which exceed the budget
+   * or the free layers reserved. Basemaps used in the current frame are never evicted.
+   *
+   * @note must be called once per frame by the rendering thread.
+   */
+  void trim() noexcept;
+
+  /**
+   * @brief Obtain the live counts and bytes of basemaps.
+   *
+   * @return the statistics.
+   */
+  basemap_statistics statistics() const noexcept;
+
+  /**
+   * @brief Obtain the count of fetches not returned yet.
+   *
+   * @return the count of requests in flight.
+   */
+  size_t in_flight() const noexcept;
 
   bool is_working() const noexcept;
 
   void stop() noexcept;
 
-  basemap_storage(std::string_view host, std::string_view url_template, size_t max_lod) noexcept;
+  /**
+   * @brief Construct a new basemap storage object
+   *
+   * @param source specifies the tile source.
+   * @param max_lod specifies the count of levels stored.
+   * @param scheduler specifies the scheduler of texture uploads, must outlive the storage.
+   * @param budget specifies the memory budget, bounds the layers of texture array as well.
+   *
+   * @note must be constructed by the rendering thread.
+   */
+  basemap_storage(uptr<tile_source> source, size_t max_lod,
+                  rptr<upload_scheduler> scheduler,
+                  basemap_budget budget = basemap_budget{}) noexcept;
+
+  /**
+   * @brief Construct a new basemap storage object of a time series.
+   *
+   * @param series specifies the tile sources of time steps, see make_tile_series.
+   * @param max_lod specifies the count of levels stored.
+   * @param scheduler specifies the scheduler of texture uploads, must outlive the storage.
+   * @param budget specifies the memory budget, bounds the layers of texture array as well.
+   *
+   * @note must be constructed by the rendering thread.
+   */
+  basemap_storage(std::vector<uptr<tile_source>> series, size_t max_lod,
+                  rptr<upload_scheduler> scheduler,
+                  basemap_budget budget = basemap_budget{}) noexcept;
 
   ~basemap_storage() noexcept;
 
 private:
-  std::pair<rptr<basemap>, basemap_texinfo> get_from_parent(const geo::maptile &tile,
-                                                            bool perform_reqest,
-                                                            basemap_texinfo texinfo) noexcept;
+  typedef std::list<std::pair<geo::maptile, rptr<basemap>>> lru_type;
+
+  /**
+   * @brief The basemaps of a time step, keyed (step, lod, x, y).
+   *
+   */
+  struct time_slot {
+    /// SIZE_MAX if not assigned.
+    size_t                                                   step;
+    size_t                                                   texture_bytes;
+    std::vector<core::flat_map<geo::maptile, uptr<basemap>>> maps;
+  };
+
+  geo::maptile clamp_lod(const geo::maptile &tile) const noexcept;
+
+  void request(size_t slot, const geo::maptile &tile, bool perform_reqest, bool prefetch) noexcept;
+
+  /// submits the fetch of basemap, the prefetches at low priority.
+  void load(rptr<basemap> node, const geo::maptile &tile, bool prefetch) noexcept;
+
+  rptr<time_slot> find_slot(size_t step) noexcept;
+
+  /// releases all basemaps of the slot, in flight ones are retired until landed.
+  void release_slot(time_slot &slot) noexcept;
+
+  void schedule_upload(const geo::maptile &tile, rptr<basemap> target) noexcept;
+
+  int acquire_layer() noexcept;
+
+  /// rebuilds the composition under the lock of layers.
+  void compose() noexcept;
+
+  /// uploaded basemaps in flight, never evicted nor released.
+  static bool is_busy(rptr<basemap> target) noexcept;
+
+  void release_layer(int layer) noexcept;
+
+  void touch(const geo::maptile &tile, rptr<basemap> target) noexcept;
+
+  /// releases the textures and pixels of basemap, and removes it from lru.
+  void unload(rptr<basemap> target) noexcept;
+
+  void evict(lru_type::iterator it) noexcept;
 
 private:
-  std::string               host_, url_template_;
-  core::fifo<std::pair<rptr<basemap>, geo::maptile>>           request_queue_;
-  std::vector<std::unordered_map<geo::maptile, uptr<basemap>>> maps_;
+  /// one source per time step.
+  std::vector<uptr<tile_source>> sources_;
+  rptr<upload_scheduler>    scheduler_;
+  listener_type             listener_;
+  /// rendering thread only, the composition is snapshot into each request.
+  std::vector<basemap_layer> layers_;
+  basemap_composition       composition_;
+  /// recycles pixels buffers of decoded tiles.
+  core::buffer_pool         bitmap_pool_;
+  /// the fetches block on the network, never queued before the shared tasks.
+  core::executor            fetchers_;
+  /// fetches submitted by the rendering thread, joined once destroyed.
+  core::task_group          requests_;
   std::atomic<bool>         is_working_;
+  size_t                    max_lod_;
+
+  /// ring of the current and the prefetched time steps, rendering thread only.
+  std::vector<time_slot>    slots_;
+  size_t                    current_slot_;
+  /// basemaps of released slots still pending in loader.
+  std::vector<uptr<basemap>> retired_;
+
+  /// least recently used basemaps, front is the hottest.
+  const basemap_budget      budget_;
+  lru_type                  lru_;
+  size_t                    frame_;
+
+  /// fixed slots of basemaps, released layers are reused a few frames later
+  /// since the previous frames may still sample them.
+  uptr<gl::texture_array>   textures_;
+  std::vector<int>          free_layers_;
+  std::deque<std::pair<int, size_t>> released_layers_;
+  std::atomic<size_t>       texture_count_, texture_bytes_,
+                            bitmap_count_, bitmap_bytes_;
+  std::atomic<size_t>       requested_count_, succeeded_count_,
+                            failed_count_, no_data_count_;
 };
 
 } // namespace esim
 
-#endif
\ No newline at end of file
+#endif
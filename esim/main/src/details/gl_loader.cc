@@ -0,0 +1,160 @@
+#include "gl_loader.h"
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <iostream>
+
+namespace esim {
+
+rptr<gl_loader> gl_loader::get() noexcept {
+  static uptr<gl_loader> single;
+  if (nullptr == single) {
+    single = make_uptr<gl_loader>();
+  }
+
+  return single.get();
+}
+
+bool gl_loader::is_running() const noexcept {
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  return is_working_;
+}
+
+void gl_loader::submit(upload_type upload, ready_type ready) noexcept {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (is_working_) {
+      pending_.emplace_back(task{std::move(upload), std::move(ready), 0});
+      ++in_flight_;
+      cond_.notify_one();
+
+      return;
+    }
+  }
+
+  ready(upload());
+}
+
+void gl_loader::load_texture(gl::texture &target, std::string file,
+                             std::function<void(bool)> ready) noexcept {
+  submit([&target, file = std::move(file)]() -> size_t {
+    if (!target.load(file)) {
+      std::cerr << "[x] failed to load texture: " << file << std::endl;
+
+      return 0;
+    }
+    auto rez = target.resolution();
+
+    /// rgb with mipmaps.
+    return static_cast<size_t>(rez.x) * rez.y * 3 * 4 / 3;
+  }, [ready = std::move(ready)](size_t bytes) { ready(bytes > 0); });
+}
+
+size_t gl_loader::poll() noexcept {
+  std::vector<task> delivered;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    while (!finished_.empty()) {
+      auto &front = finished_.front();
+      /// zero timeout, only checks whether signaled.
+      GLenum status = glClientWaitSync(front.fence, 0, 0);
+      if (GL_ALREADY_SIGNALED != status && GL_CONDITION_SATISFIED != status) {
+        break;
+      }
+      glDeleteSync(front.fence);
+      for (auto &t : front.tasks) {
+        delivered.emplace_back(std::move(t));
+      }
+      finished_.pop_front();
+    }
+    in_flight_ -= delivered.size();
+  }
+
+  /// callbacks may submit again, invoked without lock.
+  for (auto &t : delivered) {
+    t.ready(t.bytes);
+  }
+
+  return delivered.size();
+}
+
+size_t gl_loader::in_flight() const noexcept {
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  return in_flight_;
+}
+
+void gl_loader::stop() noexcept {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!is_working_) {
+
+      return;
+    }
+    is_working_ = false;
+    cond_.notify_one();
+  }
+  thread_.join();
+
+  for (auto &b : finished_) {
+    glDeleteSync(b.fence);
+  }
+  finished_.clear();
+  pending_.clear();
+  in_flight_ = 0;
+  glfwDestroyWindow(window_);
+  window_ = nullptr;
+}
+
+gl_loader::gl_loader() noexcept
+    : window_{nullptr}, is_working_{false}, in_flight_{0} {
+  auto shared = glfwGetCurrentContext();
+  if (nullptr == shared) {
+    std::cerr << "[x] no current context, uploads on rendering thread." << std::endl;
+    return;
+  }
+
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  window_ = glfwCreateWindow(1, 1, "", nullptr, shared);
+  glfwDefaultWindowHints();
+  if (nullptr == window_) {
+    std::cerr << "[x] failed to create shared context, uploads on rendering thread." << std::endl;
+    return;
+  }
+
+  is_working_ = true;
+  thread_ = std::thread([this]() { run(); });
+}
+
+gl_loader::~gl_loader() noexcept {
+  stop();
+}
+
+void gl_loader::run() noexcept {
+  glfwMakeContextCurrent(window_);
+  std::vector<task> tasks;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      cond_.wait(lock, [this]() { return !is_working_ || !pending_.empty(); });
+      if (!is_working_) {
+        break;
+      }
+      tasks.swap(pending_);
+    }
+
+    for (auto &t : tasks) {
+      t.bytes = t.upload();
+    }
+    /// one fence for the batch, flushed so that it is signaled eventually.
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    finished_.emplace_back(batch{fence, std::move(tasks)});
+    tasks.clear();
+  }
+  glfwMakeContextCurrent(nullptr);
+}
+
+} // namespace esim
@@ -0,0 +1,114 @@
+#ifndef __ESIM_ESIM_SOURCE_GL_LOADER_H_
+#define __ESIM_ESIM_SOURCE_GL_LOADER_H_
+
+#include "core/utils.h"
+#include "glapi/texture.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <glad/glad.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct GLFWwindow;
+
+namespace esim {
+
+/**
+ * @brief Uploads buffers and textures on a hidden window whose context is
+ * shared with the rendering one, so that driver copies never stall a frame.
+ *
+ * Uploads are batched and fenced on the loader thread, the rendering thread
+ * polls the fences and receives the finished objects without waiting.
+ * Falls back to upload on the rendering thread if no shared context is created.
+ */
+class gl_loader final {
+public:
+  /// performed on the loader context, returns the bytes uploaded.
+  typedef std::function<size_t()>     upload_type;
+  /// performed on the rendering thread once the upload is visible to it.
+  typedef std::function<void(size_t)> ready_type;
+
+  /**
+   * @brief Obtain the loader, created with the context current on the calling thread.
+   *
+   * @note must be called from the main thread first, as glfw creates windows there only.
+   */
+  static rptr<gl_loader> get() noexcept;
+
+  bool is_running() const noexcept;
+
+  /**
+   * @brief Submit an upload, performed immediately if the loader is not running.
+   *
+   * @param upload specifies the upload.
+   * @param ready specifies the callback after uploaded.
+   */
+  void submit(upload_type upload, ready_type ready) noexcept;
+
+  /**
+   * @brief Decode the image file and upload it as texture.
+   *
+   * @param target specifies the texture, must outlive the upload.
+   * @param file specifies the image file.
+   * @param ready specifies the callback with whether loaded successfully.
+   */
+  void load_texture(gl::texture &target, std::string file, std::function<void(bool)> ready) noexcept;
+
+  /**
+   * @brief Deliver the uploads whose fences are signaled, never blocks.
+   *
+   * @note must be called by the rendering thread.
+   * @return the count of uploads delivered.
+   */
+  size_t poll() noexcept;
+
+  /**
+   * @brief Obtain the count of uploads submitted but not delivered yet.
+   *
+   * @return the count of uploads.
+   */
+  size_t in_flight() const noexcept;
+
+  /**
+   * @brief Stop the loader thread and destroy the hidden window,
+   * uploads not performed yet are dropped.
+   *
+   * @note must be called from the main thread before glfw terminated.
+   */
+  void stop() noexcept;
+
+  gl_loader() noexcept;
+
+  ~gl_loader() noexcept;
+
+private:
+  struct task {
+    upload_type upload;
+    ready_type  ready;
+    size_t      bytes;
+  };
+
+  struct batch {
+    GLsync            fence;
+    std::vector<task> tasks;
+  };
+
+  void run() noexcept;
+
+private:
+  rptr<GLFWwindow>          window_;
+  std::thread               thread_;
+  bool                      is_working_;
+  size_t                    in_flight_;
+  mutable std::mutex        mutex_;
+  std::condition_variable   cond_;
+  std::vector<task>         pending_;
+  std::deque<batch>         finished_;
+};
+
+} // namespace esim
+
+#endif
@@ -0,0 +1,142 @@
+#include "page_feedback.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace esim {
+
+void page_feedback::begin(glm::ivec2 viewport) noexcept {
+  using namespace glm;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_fbo_);
+  glGetIntegerv(GL_VIEWPORT, prev_viewport_);
+
+  resize(max(viewport / downscale_, ivec2{1}));
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+  glViewport(0, 0, size_.x, size_.y);
+
+  const GLuint empty[4] = {0, 0, 0, 0};
+  glClearBufferuiv(GL_COLOR, 0, empty);
+  glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void page_feedback::end() noexcept {
+  auto &target = readbacks_[next_readback_];
+  next_readback_ = (next_readback_ + 1) % readbacks_.size();
+  /// not analyzed in time, the older feedback is dropped.
+  if (nullptr != target.fence) {
+    glDeleteSync(target.fence);
+  }
+
+  target.size = size_;
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, target.pbo);
+  glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size_.x) * size_.y * 4 * sizeof(GLushort),
+               nullptr, GL_STREAM_READ);
+  glReadBuffer(GL_COLOR_ATTACHMENT0);
+  glReadPixels(0, 0, size_.x, size_.y, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  target.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(prev_fbo_));
+  glViewport(prev_viewport_[0], prev_viewport_[1], prev_viewport_[2], prev_viewport_[3]);
+}
+
+bool page_feedback::analyze(std::vector<feedback_page> &pages) noexcept {
+  /// the next one to be written is the oldest.
+  rptr<readback> oldest = nullptr;
+  for (size_t i = 0; i < readbacks_.size() && nullptr == oldest; ++i) {
+    auto &target = readbacks_[(next_readback_ + i) % readbacks_.size()];
+    if (nullptr != target.fence) {
+      oldest = &target;
+    }
+  }
+  /// the newer ones never finish before the oldest.
+  if (nullptr == oldest || GL_TIMEOUT_EXPIRED == glClientWaitSync(oldest->fence, 0, 0)) {
+
+    return false;
+  }
+
+  auto &target = *oldest;
+  glDeleteSync(target.fence);
+  target.fence = nullptr;
+
+  size_t count = static_cast<size_t>(target.size.x) * target.size.y;
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, target.pbo);
+  auto texels = static_cast<const GLushort *>(
+      glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, count * 4 * sizeof(GLushort), GL_MAP_READ_BIT));
+  if (nullptr == texels) {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return false;
+  }
+
+  counter_.clear();
+  for (size_t i = 0; i < count; ++i, texels += 4) {
+    /// zero lod means nothing sampled.
+    if (0 != texels[0]) {
+      ++counter_[geo::maptile{static_cast<uint8_t>(texels[0] - 1), texels[1], texels[2]}];
+    }
+  }
+  glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  pages.clear();
+  for (auto &[tile, pixels] : counter_) {
+    pages.emplace_back(feedback_page{tile, pixels});
+  }
+  std::sort(pages.begin(), pages.end(), [](const feedback_page &lhs, const feedback_page &rhs) {
+    return lhs.pixels > rhs.pixels;
+  });
+
+  return true;
+}
+
+float page_feedback::lod_bias() const noexcept {
+
+  return std::log2(static_cast<float>(downscale_));
+}
+
+page_feedback::page_feedback(int downscale) noexcept
+    : downscale_{std::max(downscale, 1)}, fbo_{0}, color_{0}, depth_{0}, size_{0, 0},
+      next_readback_{0}, prev_fbo_{0}, prev_viewport_{0, 0, 0, 0} {
+  glGenFramebuffers(1, &fbo_);
+  glGenTextures(1, &color_);
+  glGenRenderbuffers(1, &depth_);
+  for (auto &target : readbacks_) {
+    glGenBuffers(1, &target.pbo);
+  }
+}
+
+page_feedback::~page_feedback() noexcept {
+  for (auto &target : readbacks_) {
+    if (nullptr != target.fence) {
+      glDeleteSync(target.fence);
+    }
+    glDeleteBuffers(1, &target.pbo);
+  }
+  glDeleteRenderbuffers(1, &depth_);
+  glDeleteTextures(1, &color_);
+  glDeleteFramebuffers(1, &fbo_);
+}
+
+void page_feedback::resize(glm::ivec2 size) noexcept {
+  if (size == size_) {
+
+    return;
+  }
+
+  size_ = size;
+  glBindTexture(GL_TEXTURE_2D, color_);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16UI, size.x, size.y, 0, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindRenderbuffer(GL_RENDERBUFFER, depth_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, size.x, size.y);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color_, 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_);
+  assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+}
+
+} // namespace esim
@@ -0,0 +1,99 @@
+#ifndef __ESIM_ESIM_SOURCE_PAGE_FEEDBACK_H_
+#define __ESIM_ESIM_SOURCE_PAGE_FEEDBACK_H_
+
+#include "core/flat_map.h"
+#include "core/transform.h"
+#include "core/utils.h"
+#include <array>
+#include <functional>
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <utility>
+#include <vector>
+
+namespace esim {
+
+/**
+ * @brief A page of basemap sampled by the visible pixels.
+ *
+ */
+struct feedback_page {
+  geo::maptile tile;
+  /// pixels of the feedback sampling the page.
+  size_t       pixels;
+};
+
+/**
+ * @brief Renders the basemap pages sampled by each pixel into a low resolution
+ * framebuffer, and reads them back asynchronously to drive the basemap requests,
+ * so only the imagery really visible is fetched at the resolution needed.
+ *
+ * @note must be accessed by the rendering thread only.
+ */
+class page_feedback final {
+public:
+  /**
+   * @brief Bind the feedback framebuffer and clear it, the current framebuffer
+   * and viewport are restored by end().
+   *
+   * @param viewport specifies the viewport of the full resolution.
+   */
+  void begin(glm::ivec2 viewport) noexcept;
+
+  /**
+   * @brief Read the feedback back into a pixel buffer without stalling.
+   *
+   */
+  void end() noexcept;
+
+  /**
+   * @brief Collect the pages of the oldest finished read back.
+   *
+   * @param pages specifies the pages, sorted by the pixels descending.
+   * @return true if collected, false if no read back finished.
+   */
+  bool analyze(std::vector<feedback_page> &pages) noexcept;
+
+  /**
+   * @brief Obtain the log2 of the downscale, the feedback shader biases its lod by it.
+   *
+   * @return the bias of lod.
+   */
+  float lod_bias() const noexcept;
+
+  /**
+   * @brief Construct a new page feedback object.
+   *
+   * @param downscale specifies the downscale of the viewport, power of two.
+   */
+  page_feedback(int downscale = 8) noexcept;
+
+  ~page_feedback() noexcept;
+
+  page_feedback(const page_feedback &) = delete;
+
+  page_feedback &operator=(const page_feedback &) = delete;
+
+private:
+  struct readback {
+    GLuint     pbo = 0;
+    GLsync     fence = nullptr;
+    glm::ivec2 size = {0, 0};
+  };
+
+  void resize(glm::ivec2 size) noexcept;
+
+private:
+  const int                   downscale_;
+  GLuint                      fbo_, color_, depth_;
+  glm::ivec2                  size_;
+  /// read back of the previous feedbacks, the oldest is analyzed first.
+  std::array<readback, 2>     readbacks_;
+  size_t                      next_readback_;
+  GLint                       prev_fbo_, prev_viewport_[4];
+  core::flat_map<geo::maptile, size_t> counter_;
+};
+
+} // namespace esim
+
+#endif
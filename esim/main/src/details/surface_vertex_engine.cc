@@ -24,8 +24,8 @@ const glm::dvec3 &surface_vertices::offset() const noexcept {
 }
 
 const core::bounding_box &surface_vertices::obb() const noexcept {
-  assert(nullptr != obb_);
-  return *obb_;
+
+  return obb_;
 }
 
 double surface_vertices::tile_radius() const noexcept {
@@ -52,7 +52,7 @@ void surface_vertices::calculate() noexcept {
   middle = normalize(middle);
   dvec3 basis = normalize(cross(north - south, middle));
 
-  obb_ = make_uptr<core::bounding_box>(offset_, middle, basis);
+  obb_ = core::bounding_box{offset_, middle, basis};
 
   calculate_center();
   calculate_normal();
@@ -92,7 +92,7 @@ std::vector<surface_vertices::vbo_buffer_type> surface_vertices::export_buffer()
 std::vector<surface_vertices::obb_buffer_type> surface_vertices::export_obb_buffer() const noexcept {
   using namespace glm;
   std::vector<obb_buffer_type> res(8);
-  auto &obb = obb_->data();
+  auto &obb = obb_.data();
   auto v_it = res.begin();
   for (auto &v : obb) {
     (*v_it++).pos = static_cast<vec3>(v - offset_);
@@ -170,10 +170,10 @@ void surface_vertices::calculate_skirt() noexcept {
     s_vtx.pos = geo::geo_to_ecef(sv, sv);
 
     if (tile_.x == 0) {
-      obb_->update(n_vtx.pos);
+      obb_.update(n_vtx.pos);
     }
     if (tile_.x == static_cast<uint32_t>((1 << tile_.lod) - 1)) {
-      obb_->update(s_vtx.pos);
+      obb_.update(s_vtx.pos);
     }
 
     auto &n_neighbor = buffer_[to_index(1                  , i + 1)],
@@ -199,7 +199,7 @@ void surface_vertices::calculate_skirt() noexcept {
     }
   }
 
-  obb_->calculate_box();
+  obb_.calculate_box();
 }
 
 void surface_vertices::calculate_normal() noexcept {
@@ -209,7 +209,7 @@ void surface_vertices::calculate_normal() noexcept {
   for (size_t i = 1; i < vertex_details_ + 2; ++i) {
     for (size_t j = 1; j < vertex_details_ + 2; ++j) {
       auto &curr = buffer_[to_index(i, j)];
-      obb_->update(curr.pos);
+      obb_.update(curr.pos);
       tile_radius_ = max(tile_radius_, length(curr.pos - offset_));
 
       auto up = buffer_[to_index(i, j - 1)].pos - curr.pos;
@@ -232,11 +232,18 @@ void surface_vertices::calculate_normal() noexcept {
 
 surface_vertices::surface_vertices(const geo::maptile &tile, uint32_t details) noexcept
     : tile_{tile}, vertex_details_{details}, offset_{0.0},
-      obb_(nullptr) {}
+      obb_{glm::dvec3{0.0}} {}
+
+rptr<core::object_pool<surface_vertices>> surface_vertices::pool() noexcept {
+  /// never destroyed, the vertices may be released by static destructors.
+  static auto *single = new core::object_pool<surface_vertices>{};
+
+  return single;
+}
+
+core::pool_ptr<surface_vertices> surface_vertex_engine::gen_surface_vertices(const geo::maptile &tile) const noexcept {
 
-uptr<surface_vertices> surface_vertex_engine::gen_surface_vertices(const geo::maptile &tile) const noexcept {
-  
-  return make_uptr<surface_vertices>(tile, vertex_details_);
+  return surface_vertices::pool()->make(tile, vertex_details_);
 }
 
 std::vector<uint16_t> surface_vertex_engine::export_center_element_buffer() const noexcept {
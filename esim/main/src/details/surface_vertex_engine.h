@@ -2,6 +2,7 @@
 #define __ESIM_ESIM_SOURCE_DETAILS_SURFACE_VERTEX_ENGINE_H_
 
 #include "core/bounding_box.h"
+#include "core/object_pool.h"
 #include "core/transform.h"
 #include "programs/bounding_box_program.h"
 #include "programs/surface_program.h"
@@ -33,6 +34,13 @@ public:
 
   ~surface_vertices() = default;
 
+  /**
+   * @brief Obtain the pool the vertices generated from.
+   *
+   * @return the pool shared by the process.
+   */
+  static rptr<core::object_pool<surface_vertices>> pool() noexcept;
+
 private:
   void calculate_center() noexcept;
 
@@ -46,12 +54,12 @@ private:
   glm::dvec3               offset_;
   double                   tile_radius_;
   std::vector<vertex_type> buffer_;
-  uptr<core::bounding_box> obb_;
+  core::bounding_box       obb_;
 };
 
 class surface_vertex_engine final {
 public:
-  uptr<surface_vertices> gen_surface_vertices(const geo::maptile &tile) const noexcept;
+  core::pool_ptr<surface_vertices> gen_surface_vertices(const geo::maptile &tile) const noexcept;
 
   std::vector<uint16_t> export_center_element_buffer() const noexcept;
 
@@ -0,0 +1,398 @@
+#include "details/tile_source.h"
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include <httplib.h>
+
+#if defined(ESIM_ENABLE_MBTILES)
+#include <sqlite3.h>
+#endif
+
+namespace esim {
+
+namespace details {
+
+static void append_number(std::string &out, uint32_t value) noexcept {
+  char buffer[16];
+  auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  assert(ec == std::errc{});
+  out.append(buffer, end);
+}
+
+static void append_quadkey(std::string &out, const geo::maptile &tile) noexcept {
+  for (int i = tile.lod; i > 0; --i) {
+    uint32_t mask = 1U << (i - 1);
+    char digit = '0';
+    if (tile.y & mask) {
+      digit += 1;
+    }
+    if (tile.x & mask) {
+      digit += 2;
+    }
+    out.push_back(digit);
+  }
+}
+
+static uint32_t tms_row(const geo::maptile &tile) noexcept {
+
+  return ((1U << tile.lod) - 1) - tile.x;
+}
+
+} // namespace details
+
+std::string &tile_template::expand(const geo::maptile &tile, std::string &out) const noexcept {
+  out.clear();
+  out.reserve(reserve_);
+  for (auto &seg : segments_) {
+    switch (seg.type) {
+    case token::literal:
+      out.append(seg.text);
+      break;
+    case token::lod:
+      details::append_number(out, tile.lod);
+      break;
+    case token::row:
+      details::append_number(out, tile.x);
+      break;
+    case token::column:
+      details::append_number(out, tile.y);
+      break;
+    case token::tms_row:
+      details::append_number(out, details::tms_row(tile));
+      break;
+    case token::quadkey:
+      details::append_quadkey(out, tile);
+      break;
+    }
+  }
+
+  return out;
+}
+
+std::string tile_template::expand(const geo::maptile &tile) const noexcept {
+  std::string out;
+
+  return expand(tile, out);
+}
+
+tile_template::tile_template(std::string_view pattern) noexcept
+    : reserve_{pattern.size() + 32} {
+  auto push_literal = [&](std::string_view text) {
+    if (text.empty()) {
+      return;
+    }
+    if (!segments_.empty() && segments_.back().type == token::literal) {
+      segments_.back().text.append(text);
+    } else {
+      segments_.emplace_back(segment{token::literal, std::string{text}});
+    }
+  };
+
+  size_t pos = 0;
+  while (pos < pattern.size()) {
+    size_t open = pattern.find('{', pos);
+    size_t close = open == std::string_view::npos
+                       ? std::string_view::npos
+                       : pattern.find('}', open);
+    if (close == std::string_view::npos) {
+      push_literal(pattern.substr(pos));
+      break;
+    }
+
+    push_literal(pattern.substr(pos, open - pos));
+    auto name = pattern.substr(open + 1, close - open - 1);
+    if (name == "z") {
+      segments_.emplace_back(segment{token::lod, {}});
+    } else if (name == "x") {
+      segments_.emplace_back(segment{token::row, {}});
+    } else if (name == "y") {
+      segments_.emplace_back(segment{token::column, {}});
+    } else if (name == "-x") {
+      segments_.emplace_back(segment{token::tms_row, {}});
+    } else if (name == "q") {
+      segments_.emplace_back(segment{token::quadkey, {}});
+    } else {
+      /// unknown placeholder, keep as-is.
+      push_literal(pattern.substr(open, close - open + 1));
+    }
+    pos = close + 1;
+  }
+}
+
+tile_source::status http_tile_source::fetch(const geo::maptile &tile, std::string &data) noexcept {
+  const static httplib::Headers headers = {
+      {"Accept-Encoding", "gzip, deflate, br"},
+      {"Connections", "keep-alive"},
+      {"User-Agent", "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/101.0.4951.67 Safari/537.36"}
+  };
+  std::string url;
+  url_.expand(tile, url);
+
+  httplib::SSLClient cli(host_.data());
+  cli.set_connection_timeout(std::chrono::seconds(10));
+  if (auto res = cli.Get(url.data(), headers)) {
+    if (res->status == 200) {
+      data = std::move(res->body);
+
+      return TILE_SUCCESS;
+    } else if (res->status == 404 || res->status == 204) {
+
+      return TILE_NO_DATA;
+    } else {
+
+      return TILE_FAILURE;
+    }
+  } else {
+    std::cerr << res.error() << std::endl;
+
+    return TILE_FAILURE;
+  }
+}
+
+http_tile_source::http_tile_source(std::string_view host,
+                                   std::string_view url_template) noexcept
+    : host_{host}, url_{url_template} {}
+
+tile_source::status file_tile_source::fetch(const geo::maptile &tile, std::string &data) noexcept {
+  std::string path;
+  path_.expand(tile, path);
+
+  std::ifstream f(path, std::ios::binary | std::ios::ate);
+  if (!f.is_open()) {
+
+    return TILE_NO_DATA;
+  }
+
+  auto size = f.tellg();
+  if (size <= 0) {
+
+    return TILE_NO_DATA;
+  }
+
+  data.resize(static_cast<size_t>(size));
+  f.seekg(0);
+  if (!f.read(data.data(), size)) {
+
+    return TILE_FAILURE;
+  }
+
+  return TILE_SUCCESS;
+}
+
+file_tile_source::file_tile_source(std::string_view path_template) noexcept
+    : path_{path_template} {}
+
+tile_source::status cache_tile_source::fetch(const geo::maptile &tile, std::string &data) noexcept {
+  std::string path;
+  path_.expand(tile, path);
+
+  std::ifstream f(path, std::ios::binary | std::ios::ate);
+  if (f.is_open()) {
+    auto size = f.tellg();
+    if (0 == size) {
+
+      return TILE_NO_DATA;
+    }
+
+    /// fetched from the upstream as if missing if the size or the read failed.
+    if (size > 0) {
+      data.resize(static_cast<size_t>(size));
+      f.seekg(0);
+      if (f.read(data.data(), size)) {
+
+        return TILE_SUCCESS;
+      }
+    }
+  }
+
+  if (nullptr == upstream_) {
+
+    return TILE_NO_DATA;
+  }
+
+  auto status = upstream_->fetch(tile, data);
+  /// the maptiles without data are always recorded, never requested again.
+  if (TILE_NO_DATA == status) {
+    store(tile, std::string_view{});
+  } else if (write_back_ && TILE_SUCCESS == status) {
+    store(tile, data);
+  }
+
+  return status;
+}
+
+bool cache_tile_source::contains(const geo::maptile &tile) const noexcept {
+  std::string path;
+  path_.expand(tile, path);
+  std::error_code ec;
+
+  return std::filesystem::is_regular_file(path, ec);
+}
+
+bool cache_tile_source::store(const geo::maptile &tile, std::string_view data) noexcept {
+  std::string path;
+  path_.expand(tile, path);
+  std::error_code ec;
+  std::filesystem::path target(path);
+  std::filesystem::create_directories(target.parent_path(), ec);
+  if (ec) {
+
+    return false;
+  }
+
+  /// written aside and renamed, readers never see a partial maptile.
+  std::filesystem::path temp(path + ".part");
+  {
+    std::ofstream f(temp, std::ios::binary | std::ios::trunc);
+    if (!f.is_open() || !f.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+
+      return false;
+    }
+  }
+  std::filesystem::rename(temp, target, ec);
+
+  return !ec;
+}
+
+cache_tile_source::cache_tile_source(std::string_view root,
+                                     uptr<tile_source> upstream,
+                                     bool write_back) noexcept
+    : path_{std::string(root) + "/{z}/{x}/{y}.tile"},
+      upstream_{std::move(upstream)}, write_back_{write_back} {}
+
+#if defined(ESIM_ENABLE_MBTILES)
+
+tile_source::status mbtiles_tile_source::fetch(const geo::maptile &tile, std::string &data) noexcept {
+  if (!is_open()) {
+
+    return TILE_FAILURE;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stmt = static_cast<rptr<sqlite3_stmt>>(stmt_);
+  /// MBTiles stores rows in TMS order.
+  sqlite3_bind_int(stmt, 1, tile.lod);
+  sqlite3_bind_int64(stmt, 2, tile.y);
+  sqlite3_bind_int64(stmt, 3, details::tms_row(tile));
+
+  status res = TILE_NO_DATA;
+  switch (sqlite3_step(stmt)) {
+  case SQLITE_ROW:
+    if (int bytes = sqlite3_column_bytes(stmt, 0); bytes > 0) {
+      auto blob = static_cast<const char *>(sqlite3_column_blob(stmt, 0));
+      data.assign(blob, static_cast<size_t>(bytes));
+      res = TILE_SUCCESS;
+    }
+    break;
+  case SQLITE_DONE:
+    break;
+  default:
+    res = TILE_FAILURE;
+    break;
+  }
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  return res;
+}
+
+bool mbtiles_tile_source::is_open() const noexcept {
+
+  return nullptr != stmt_;
+}
+
+mbtiles_tile_source::mbtiles_tile_source(std::string_view file) noexcept
+    : db_{nullptr}, stmt_{nullptr} {
+  std::string path{file};
+  rptr<sqlite3> db = nullptr;
+  if (SQLITE_OK != sqlite3_open_v2(path.data(), &db, SQLITE_OPEN_READONLY, nullptr)) {
+    std::cerr << "[x] failed to open " << path << ": " << sqlite3_errmsg(db) << std::endl;
+    sqlite3_close(db);
+    return;
+  }
+
+  rptr<sqlite3_stmt> stmt = nullptr;
+  constexpr static const char *query = "SELECT tile_data FROM tiles "
+                                       "WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3";
+  if (SQLITE_OK != sqlite3_prepare_v2(db, query, -1, &stmt, nullptr)) {
+    std::cerr << "[x] invalid MBTiles " << path << ": " << sqlite3_errmsg(db) << std::endl;
+    sqlite3_close(db);
+    return;
+  }
+
+  db_ = db;
+  stmt_ = stmt;
+}
+
+mbtiles_tile_source::~mbtiles_tile_source() noexcept {
+  sqlite3_finalize(static_cast<rptr<sqlite3_stmt>>(stmt_));
+  sqlite3_close(static_cast<rptr<sqlite3>>(db_));
+}
+
+#endif
+
+uptr<tile_source> make_tile_source(std::string_view uri) noexcept {
+  constexpr static std::string_view https = "https://";
+  constexpr static std::string_view file = "file://";
+  constexpr static std::string_view mbtiles = "mbtiles://";
+  constexpr static std::string_view cache = "cache://";
+
+  if (0 == uri.rfind(https, 0)) {
+    auto rest = uri.substr(https.size());
+    auto slash = rest.find('/');
+    if (slash == std::string_view::npos) {
+
+      return nullptr;
+    }
+
+    return make_uptr<http_tile_source>(rest.substr(0, slash), rest.substr(slash));
+  } else if (0 == uri.rfind(file, 0)) {
+
+    return make_uptr<file_tile_source>(uri.substr(file.size()));
+  } else if (0 == uri.rfind(mbtiles, 0)) {
+#if defined(ESIM_ENABLE_MBTILES)
+    auto source = make_uptr<mbtiles_tile_source>(uri.substr(mbtiles.size()));
+    if (source->is_open()) {
+
+      return source;
+    }
+#else
+    std::cerr << "[x] MBTiles is not supported in this build." << std::endl;
+#endif
+  } else if (0 == uri.rfind(cache, 0)) {
+
+    return make_uptr<cache_tile_source>(uri.substr(cache.size()));
+  }
+
+  return nullptr;
+}
+
+std::vector<uptr<tile_source>> make_tile_series(std::string_view uri,
+                                                const std::vector<std::string> &dates) noexcept {
+  constexpr static std::string_view time = "{t}";
+
+  std::vector<uptr<tile_source>> series;
+  series.reserve(dates.size());
+  for (auto &date : dates) {
+    std::string expanded{uri};
+    for (auto pos = expanded.find(time); pos != std::string::npos;
+         pos = expanded.find(time, pos + date.size())) {
+      expanded.replace(pos, time.size(), date);
+    }
+    auto source = make_tile_source(expanded);
+    if (nullptr == source) {
+
+      return {};
+    }
+    series.emplace_back(std::move(source));
+  }
+
+  return series;
+}
+
+} // namespace esim
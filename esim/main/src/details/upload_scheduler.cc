@@ -0,0 +1,54 @@
+#include "upload_scheduler.h"
+
+namespace esim {
+
+void upload_scheduler::schedule(gl_loader::upload_type upload, gl_loader::ready_type ready) noexcept {
+  tasks_.emplace_back(task_type{std::move(upload), std::move(ready)});
+}
+
+void upload_scheduler::drain() noexcept {
+  using namespace std::chrono;
+  auto start = steady_clock::now();
+  auto elapsed = microseconds{0};
+  auto loader = gl_loader::get();
+  /// the loader thread is not bound to frames, everything is handed over.
+  bool async = loader->is_running();
+  size_t submitted = 0;
+
+  while (!tasks_.empty()) {
+    if (!async && submitted > 0 && (elapsed >= budget_.time || bytes_ >= budget_.bytes)) {
+      break;
+    }
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+    loader->submit(std::move(task.upload), [this, ready = std::move(task.ready)](size_t bytes) {
+      ready(bytes);
+      ++uploads_;
+      bytes_ += bytes;
+    });
+    ++submitted;
+    elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+  }
+  loader->poll();
+  elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+
+  /// deliveries polled elsewhere since the last frame are counted as well.
+  statistics_ = upload_statistics{tasks_.size() + loader->in_flight(), uploads_, bytes_, elapsed};
+  uploads_ = bytes_ = 0;
+}
+
+size_t upload_scheduler::pending() const noexcept {
+
+  return tasks_.size();
+}
+
+upload_statistics upload_scheduler::statistics() const noexcept {
+
+  return statistics_;
+}
+
+upload_scheduler::upload_scheduler(upload_budget budget) noexcept
+    : budget_{budget}, uploads_{0}, bytes_{0},
+      statistics_{0, 0, 0, std::chrono::microseconds{0}} {}
+
+} // namespace esim
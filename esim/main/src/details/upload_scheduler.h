@@ -0,0 +1,83 @@
+#ifndef __ESIM_ESIM_SOURCE_UPLOAD_SCHEDULER_H_
+#define __ESIM_ESIM_SOURCE_UPLOAD_SCHEDULER_H_
+
+#include "core/utils.h"
+#include "details/gl_loader.h"
+#include <chrono>
+#include <deque>
+#include <functional>
+
+namespace esim {
+
+/**
+ * @brief The per-frame budget of gpu uploads.
+ *
+ */
+struct upload_budget {
+  std::chrono::microseconds time  = std::chrono::microseconds{2000};
+  size_t                    bytes = 8UL << 20;
+};
+
+/**
+ * @brief The statistics of uploads performed by the last frame.
+ *
+ */
+struct upload_statistics {
+  /// scheduled or in flight on the loader.
+  size_t                    queue_depth;
+  size_t                    uploads;
+  size_t                    bytes;
+  /// spent by the rendering thread.
+  std::chrono::microseconds time;
+};
+
+/**
+ * @brief Defers vertex buffers and textures uploads to the loader thread, or
+ * drains them under the per-frame budget on the rendering thread if the loader
+ * is not running, to avoid hitches when a burst of tiles is ready.
+ *
+ * @note not thread-safety, must be accessed by the rendering thread only.
+ */
+class upload_scheduler final {
+public:
+  struct task_type {
+    gl_loader::upload_type upload;
+    gl_loader::ready_type  ready;
+  };
+
+  /**
+   * @brief Schedule an upload.
+   *
+   * @param upload specifies the upload, may be performed on the loader thread.
+   * @param ready specifies the callback on the rendering thread after uploaded.
+   */
+  void schedule(gl_loader::upload_type upload, gl_loader::ready_type ready) noexcept;
+
+  /**
+   * @brief Submit the scheduled uploads in order and deliver the finished ones.
+   * Without the loader, uploads are performed until the budget is exhausted,
+   * at least one is performed so that the queue always makes progress.
+   *
+   * @note must be called once per frame.
+   */
+  void drain() noexcept;
+
+  size_t pending() const noexcept;
+
+  upload_statistics statistics() const noexcept;
+
+  upload_scheduler(upload_budget budget = upload_budget{}) noexcept;
+
+  ~upload_scheduler() = default;
+
+private:
+  const upload_budget   budget_;
+  std::deque<task_type> tasks_;
+  /// delivered by the current frame.
+  size_t                uploads_, bytes_;
+  upload_statistics     statistics_;
+};
+
+} // namespace esim
+
+#endif
@@ -9,6 +9,11 @@ static std::function<void()> before_render_callback = []() {};
 
 static std::function<void()> after_render_callback = []() {};
 
+/// the engine parks on the requests itself if unbound.
+static std::function<void(std::chrono::milliseconds)> idle_callback = nullptr;
+
+static std::function<void()> wake_callback = []() {};
+
 } // namespace details
 
 void esim_controller::start() noexcept {
@@ -20,7 +25,12 @@ void esim_controller::start() noexcept {
     return;
   }
 
-  engine_->start([&]() { details::before_render_callback(); }, [&]() { details::after_render_callback(); });
+  std::function<void(std::chrono::milliseconds)> idle = nullptr;
+  if (nullptr != details::idle_callback) {
+    idle = [&](std::chrono::milliseconds timeout) { details::idle_callback(timeout); };
+  }
+  engine_->start([&]() { details::before_render_callback(); }, [&]() { details::after_render_callback(); },
+                 std::move(idle));
 }
 
 void esim_controller::stop() noexcept {
@@ -28,6 +38,7 @@ void esim_controller::stop() noexcept {
   assert(nullptr != opaque_);
   opaque_->stop();
   engine_->stop();
+  details::wake_callback();
 }
 
 void esim_controller::render() noexcept {
@@ -99,11 +110,25 @@ void esim_controller::bind_after_render_process(std::function<void()> callback)
   details::after_render_callback = callback;
 }
 
+void esim_controller::bind_idle_process(std::function<void(std::chrono::milliseconds)> callback) noexcept {
+  details::idle_callback = callback;
+}
+
+void esim_controller::bind_wake_process(std::function<void()> callback) noexcept {
+  details::wake_callback = callback;
+}
+
 esim_controller::esim_controller() noexcept
-    : opaque_{make_uptr<opaque>([&](rptr<void> msg) { notify(msg); })},
+    : opaque_{make_uptr<opaque>()},
       engine_{make_uptr<esim_engine>()} {
-  subscribe(engine_.get());
-  engine_->subscribe(this);
+  opaque_->requests()->subscribe([engine = engine_.get()](const core::snapshot<scene::frame_info> &info) {
+    engine->request(info);
+    /// the rendering thread may block on the window events.
+    details::wake_callback();
+  });
+  engine_->frames()->subscribe([opaque = opaque_.get()](const core::snapshot<scene::frame_info> &info) {
+    opaque->receive_last_frame(*info);
+  });
 }
 
 esim_controller::~esim_controller() noexcept {
@@ -111,9 +136,4 @@ esim_controller::~esim_controller() noexcept {
   opaque_->stop();
 }
 
-void esim_controller::update(rptr<void> msg) noexcept {
-  assert(nullptr != opaque_);
-  opaque_->receive_last_frame(msg);
-}
-
 }
\ No newline at end of file
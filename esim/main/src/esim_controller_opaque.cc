@@ -1,7 +1,18 @@
 #include "esim_controller_opaque.h"
+#include <algorithm>
 
 namespace esim {
 
+namespace details {
+
+/// interval between the time steps played.
+constexpr static std::chrono::milliseconds playback_interval{500};
+
+/// parked while idle, wakes up to check if still working.
+constexpr static std::chrono::milliseconds idle_interval{100};
+
+} // namespace details
+
 bool esim_controller::opaque::is_working() const noexcept {
   using namespace enums;
   return status() & state::working;
@@ -23,7 +34,8 @@ bool esim_controller::opaque::start() noexcept {
     return false;
   }
   state_.fetch_or(enums::to_raw(state::working), std::memory_order_release);
-  std::thread([&]() { event_handler(); }).detach();
+  /// parks between events, occupies its own worker while working.
+  handler_.submit([this]() { event_handler(); }, core::task_priority::high);
 
   return true;
 }
@@ -33,6 +45,8 @@ void esim_controller::opaque::stop() noexcept {
     /// multiple thread may repeatly xor
     /// finally cause non-stop
     state_.fetch_xor(enums::to_raw(state::working), std::memory_order_release);
+    resumed_.notify_all();
+    handler_.wait();
   }
 }
 
@@ -40,14 +54,10 @@ void esim_controller::opaque::push_event(protocol::event event) noexcept {
   event_queue_.push(event);
 }
 
-esim_controller::opaque::opaque(
-    std::function<void(rptr<void>)> notify_callback) noexcept
+esim_controller::opaque::opaque() noexcept
     : frame_info_{}, taggled_pos_{0.0},
-      left_mouse_pressed_{false},
-      info_callback_{notify_callback},
-      event_queue_{1024}, state_{0} {
-  assert(nullptr != info_callback_);
-}
+      left_mouse_pressed_{false}, playing_{false}, moving_{false},
+      event_queue_{}, state_{0}, handler_worker_{1}, handler_{&handler_worker_} {}
 
 esim_controller::opaque::~opaque() noexcept {
   stop();
@@ -59,19 +69,24 @@ esim_controller::opaque::status(std::memory_order mo) const noexcept {
   return state_.load(mo);
 }
 
-void esim_controller::opaque::receive_last_frame(rptr<void> msg) noexcept {
-  auto info = reinterpret_cast<rptr<scene::frame_info>>(msg);
-  frame_info_.update_cursor(*info);
-  if (frame_info_.expect_redraw(*info)) {
+void esim_controller::opaque::receive_last_frame(const scene::frame_info &info) noexcept {
+  frame_info_.update_cursor(info);
+  if (frame_info_.expect_redraw(info)) {
     send_event();
   } else {
     state_.fetch_and(~enums::to_raw(state::pause), std::memory_order_release);
+    resumed_.notify_one();
   }
 }
 
+rptr<core::channel<scene::frame_info>> esim_controller::opaque::requests() noexcept {
+
+  return &requests_;
+}
+
 void esim_controller::opaque::send_event() noexcept {
-  scene::frame_info fork = frame_info_;
-  info_callback_(&fork);
+  /// the snapshot is the only copy, shared by the subscribers.
+  requests_.emplace(frame_info_);
 }
 
 void esim_controller::opaque::event_reset() noexcept {
@@ -170,6 +185,37 @@ bool esim_controller::opaque::calculate_motion() noexcept {
   return frame_info_.is_moving;
 }
 
+std::chrono::milliseconds esim_controller::opaque::event_timeout() const noexcept {
+  using namespace std::chrono;
+  if (moving_) {
+
+    return milliseconds{0};
+  }
+  if (!playing_) {
+
+    return details::idle_interval;
+  }
+
+  /// parked until the next step, the held keys never moving the camera are ignored.
+  auto remaining = ceil<milliseconds>(last_step_ + details::playback_interval - steady_clock::now());
+
+  return std::clamp(remaining, milliseconds{0}, details::idle_interval);
+}
+
+bool esim_controller::opaque::calculate_playback() noexcept {
+  using namespace std::chrono;
+  auto now = steady_clock::now();
+  if (!playing_ || now - last_step_ < details::playback_interval) {
+
+    return false;
+  }
+
+  last_step_ = now;
+  ++frame_info_.time_step;
+
+  return true;
+}
+
 bool esim_controller::opaque::event_key_press(protocol::keycode_type key) noexcept {
   pressed_keys_.insert(key);
 
@@ -189,6 +235,22 @@ bool esim_controller::opaque::event_key_press(protocol::keycode_type key) noexce
   case protocol::KEY_B:
     frame_info_.debug_show_box = !frame_info_.debug_show_box;
     return true;
+
+  case protocol::KEY_P:
+    playing_ = !playing_;
+    last_step_ = std::chrono::steady_clock::now();
+    return false;
+
+  case protocol::KEY_COMMA:
+    if (0 == frame_info_.time_step) {
+      return false;
+    }
+    --frame_info_.time_step;
+    return true;
+
+  case protocol::KEY_PERIOD:
+    ++frame_info_.time_step;
+    return true;
   
   default:
 
@@ -263,12 +325,20 @@ void esim_controller::opaque::event_handler() noexcept {
   while(is_working()) {
     bool resend_event = false;
 
-    if (!is_pause()) {
-      while (event_queue_.try_pop(event_msg)) {
-        resend_event |= event_perform(event_msg);
+    if (is_pause()) {
+      /// the events are queued meanwhile.
+      resumed_.park_until_for([this]() { return !is_pause() || !is_working(); }, details::idle_interval);
+    } else {
+      /// parked until an event arrives, the next step played or moving.
+      if (event_queue_.try_pop_for(event_msg, event_timeout())) {
+        do {
+          resend_event |= event_perform(event_msg);
+        } while (event_queue_.try_pop(event_msg));
       }
 
-      resend_event |= calculate_motion();
+      moving_ = calculate_motion();
+      resend_event |= moving_;
+      resend_event |= calculate_playback();
 
       if (resend_event) {
         send_event();
@@ -1,11 +1,15 @@
 #ifndef __ESIM_ESIM_SOURCE_ESIM_CONTROLLER_OPAQUE_H_
 #define __ESIM_ESIM_SOURCE_ESIM_CONTROLLER_OPAQUE_H_
 
-#include "core/fifo.h"
+#include "core/channel.h"
+#include "core/executor.h"
+#include "core/parker.h"
 #include "core/transform.h"
+#include "core/unbounded_queue.h"
 #include "details/camera.h"
 #include "esim/esim_controller.h"
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <thread>
 #include <unordered_set>
@@ -31,11 +35,18 @@ public:
 
   void stop() noexcept;
 
-  void receive_last_frame(rptr<void> msg) noexcept;
+  void receive_last_frame(const scene::frame_info &info) noexcept;
+
+  /**
+   * @brief Obtain the channel of frames requested, the snapshots are
+   * shared by the subscribers.
+   *
+   */
+  rptr<core::channel<scene::frame_info>> requests() noexcept;
   
   void push_event(protocol::event event) noexcept;
 
-  opaque(std::function<void(rptr<void>)> notify_callback) noexcept;
+  opaque() noexcept;
 
   ~opaque() noexcept;
 
@@ -54,6 +65,12 @@ private:
 
   bool calculate_motion() noexcept;
 
+  /// waits for the events no longer than the camera moving or the next step played.
+  std::chrono::milliseconds event_timeout() const noexcept;
+
+  /// steps the time forward while playing, the following steps are prefetched by renderer.
+  bool calculate_playback() noexcept;
+
   bool event_key_press(protocol::keycode_type key) noexcept;
 
   bool event_key_release(protocol::keycode_type key) noexcept;
@@ -78,11 +95,22 @@ private:
     double    speed;
   }                                          cursor_;
   std::unordered_set<protocol::keycode_type> pressed_keys_;
+  bool                                       playing_;
+  /// the camera moved by the last pass, calculated again without waiting.
+  bool                                       moving_;
+  std::chrono::steady_clock::time_point      last_step_;
 
   /// event handler
-  std::function<void(rptr<void>)> info_callback_;
-  core::fifo<protocol::event>     event_queue_;
+  core::channel<scene::frame_info> requests_;
+  /// pushed by the window thread, which must never block on a flood of events.
+  core::unbounded_queue<protocol::event> event_queue_;
+  /// parks the handler until the last frame received.
+  core::parker                    resumed_;
   std::atomic<enums::raw<state>>  state_;
+  /// the event handler never returns until stopped, kept off the shared executor.
+  core::executor                  handler_worker_;
+  /// runs the event handler until stopped.
+  core::task_group                handler_;
 };
 
 } // namespace esim
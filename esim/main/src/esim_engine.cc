@@ -6,20 +6,28 @@
 namespace esim {
 
 void esim_engine::start(std::function<void()> before_render,
-                        std::function<void()> after_render) noexcept {
+                        std::function<void()> after_render,
+                        std::function<void(std::chrono::milliseconds)> idle) noexcept {
   assert(nullptr != opaque_);
-  opaque_->start();
+  opaque_->start(std::move(idle));
   while (before_render(), opaque_->is_rendering()) {
-    opaque_->poll_events();
+    /// a request is answered even if nothing redrawn, the requester waits for the frame.
+    bool requested = opaque_->poll_events();
 
     if (!opaque_->is_pause()) {
       opaque_->render();
       after_render();
+      /// nothing differs until the next request once settled.
+      if (!opaque_->is_settling()) {
+        opaque_->pause();
+      }
+    } else if (!requested) {
+      opaque_->idle();
+      continue;
     }
     opaque_->after_render();
 
-    auto info = opaque_->frame_info();
-    notify(&info);
+    frames_.emplace(opaque_->frame_info());
   }
   opaque_->terminate();
 }
@@ -33,8 +41,17 @@ void esim_engine::render() noexcept {
   assert(nullptr != opaque_);
   opaque_->poll_events();
   opaque_->render();
-  auto info = opaque_->frame_info();
-  notify(&info);
+  frames_.emplace(opaque_->frame_info());
+}
+
+rptr<core::channel<scene::frame_info>> esim_engine::frames() noexcept {
+
+  return &frames_;
+}
+
+void esim_engine::request(const core::snapshot<scene::frame_info> &info) noexcept {
+  assert(nullptr != opaque_);
+  opaque_->push_frame_info(info);
 }
 
 esim_engine::esim_engine() noexcept
@@ -45,10 +62,4 @@ esim_engine::~esim_engine() noexcept {
   opaque_->stop();
 }
 
-void esim_engine::update(rptr<void> msg) noexcept {
-  assert(nullptr != opaque_);
-  auto info = reinterpret_cast<rptr<scene::frame_info>>(msg);
-  opaque_->push_frame_info(info);
-}
-
 } // namespace esim
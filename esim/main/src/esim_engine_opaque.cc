@@ -1,11 +1,21 @@
 #include "esim_engine_opaque.h"
 #include "core/transform.h"
+#include "details/gl_loader.h"
 #include <glad/glad.h>
 
 namespace esim {
 
-scene::frame_info esim_engine::opaque::frame_info() const noexcept {
-  
+namespace details {
+
+/// a paused renderer parks until the next frame info, window events are polled in between.
+constexpr static std::chrono::milliseconds idle_interval{4};
+/// the longest blocked on the window events, woken up earlier by the requests.
+constexpr static std::chrono::milliseconds idle_timeout{500};
+
+} // namespace details
+
+const scene::frame_info &esim_engine::opaque::frame_info() const noexcept {
+
   return frame_info_;
 }
 
@@ -14,6 +24,9 @@ void esim_engine::opaque::render() noexcept {
   auto &cmr = frame_info_.camera;
   auto &sun = frame_info_.sun;
 
+  /// receive the objects uploaded by the loader thread.
+  gl_loader::get()->poll();
+
   glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -79,7 +92,9 @@ void esim_engine::opaque::render() noexcept {
   blend_prog->update_exposure_uniform(2.0f);
   blend_prog->update_ndc_sun_uniform(static_cast<vec4>(sun_ndc));
   blend_prog->update_resolution_uniform(static_cast<vec2>(cmr.viewport()));
-  blend_prog->update_dither_resolution_uniform(static_cast<vec2>(noise_.resolution()));
+  /// an incomplete texture samples zero, no dithering until loaded.
+  blend_prog->update_dither_resolution_uniform(noise_ready_ ? static_cast<vec2>(noise_.resolution())
+                                                            : vec2{1.0f});
   glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(quad_vbo_.size()));
 
   /// debug
@@ -121,7 +136,13 @@ bool esim_engine::opaque::is_terminated() const noexcept {
   return state(std::memory_order_acquire) & status::terminate;
 }
 
-void esim_engine::opaque::start() noexcept {
+bool esim_engine::opaque::is_settling() const noexcept {
+
+  return surface_entity_->is_settling() || gl_loader::get()->in_flight() > 0;
+}
+
+void esim_engine::opaque::start(std::function<void(std::chrono::milliseconds)> idle) noexcept {
+  idle_ = std::move(idle);
   state_.fetch_or(enums::to_raw(status::rendering), std::memory_order_release);
 }
 
@@ -133,51 +154,62 @@ void esim_engine::opaque::resume() noexcept {
   state_.fetch_and(~enums::to_raw(status::pause), std::memory_order_release);
 }
 
+void esim_engine::opaque::idle() noexcept {
+  if (nullptr != idle_) {
+    idle_(details::idle_timeout);
+  }
+}
+
 void esim_engine::opaque::stop() noexcept {
   state_.fetch_and(~enums::to_raw(status::rendering), std::memory_order_release);
 }
 
 void esim_engine::opaque::terminate() noexcept {
+  /// the hidden window must be destroyed before glfw terminated.
+  gl_loader::get()->stop();
   state_.fetch_or(enums::to_raw(status::terminate), std::memory_order_release);
 }
 
-void esim_engine::opaque::push_frame_info(rptr<scene::frame_info> info) noexcept {
+void esim_engine::opaque::push_frame_info(const core::snapshot<scene::frame_info> &info) noexcept {
   resume();
-  frame_info_queue_.try_push(*info);
+  std::lock_guard<std::mutex> lock{publish_mutex_};
+  frame_info_mailbox_.publish(info);
 }
 
 bool esim_engine::opaque::poll_events() noexcept {
-  scene::frame_info info;
-  if (!frame_info_queue_.try_pop(info)) {
-    std::this_thread::yield();
+  /// blocked by idle() instead if bound.
+  auto timeout = is_pause() && nullptr == idle_ ? details::idle_interval : std::chrono::milliseconds{0};
+
+  /// the frames published meanwhile are skipped, the latest one wins.
+  if (!frame_info_mailbox_.acquire_for(timeout)) {
     return false;
   }
 
-  while (frame_info_queue_.try_pop(info))
-    ;
-
+  auto &info = *frame_info_mailbox_.read_buffer();
   if (frame_info_.expect_redraw(info)) {
     frame_info_ = info;
     resume();
-
-    return true;
   } else {
-
-    return frame_info_.update_cursor(info);
+    frame_info_.update_cursor(info);
   }
+
+  return true;
 }
 
 esim_engine::opaque::opaque() noexcept
-    : state_{0}, frame_info_queue_{512},
+    : state_{0},
       pipeline_{make_uptr<esim_render_pipe>(20)},
       sun_entity_{make_uptr<scene::stellar>()},
       skysphere_entity_{make_uptr<scene::skysphere>()},
       surface_entity_{make_uptr<scene::surface_collection>(33)},
       atmosphere_entity_{make_uptr<scene::atmosphere>()},
-      color_buffers_(3), quad_vbo_{GL_ARRAY_BUFFER} {
+      color_buffers_(3), noise_ready_{false}, quad_vbo_{GL_ARRAY_BUFFER} {
   using namespace glm;
 
-  assert(noise_.load("assets/img/noise.png"));
+  gl_loader::get()->load_texture(noise_, "assets/img/noise.png", [this](bool loaded) {
+    assert(loaded);
+    noise_ready_ = loaded;
+  });
 
   glGenFramebuffers(1, &hdr_fbo_);
   glBindFramebuffer(GL_FRAMEBUFFER, hdr_fbo_);
@@ -1,7 +1,8 @@
 #ifndef __ESIM_ESIM_SOURCE_ESIM_ENGINE_OPAQUE_H_
 #define __ESIM_ESIM_SOURCE_ESIM_ENGINE_OPAQUE_H_
 
-#include "core/fifo.h"
+#include "core/channel.h"
+#include "core/triple_buffer.h"
 #include "core/utils.h"
 #include "esim/esim_engine.h"
 #include "esim_render_pipe.h"
@@ -14,7 +15,10 @@
 #include "scene/stellar.h"
 #include "scene/surface_collections.h"
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <glad/glad.h>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -30,7 +34,7 @@ private:
   };
 
 public:
-  scene::frame_info frame_info() const noexcept;
+  const scene::frame_info &frame_info() const noexcept;
 
   void render() noexcept;
 
@@ -42,7 +46,13 @@ public:
   
   bool is_terminated() const noexcept;
 
-  void start() noexcept;
+  /// true if the following frames may differ without any request.
+  bool is_settling() const noexcept;
+
+  void start(std::function<void(std::chrono::milliseconds)> idle) noexcept;
+
+  /// blocks on the idle callback bound, woken up by the window events or the requests.
+  void idle() noexcept;
 
   void pause() noexcept;
 
@@ -52,8 +62,9 @@ public:
 
   void terminate() noexcept;
 
-  void push_frame_info(rptr<scene::frame_info> info) noexcept;
+  void push_frame_info(const core::snapshot<scene::frame_info> &info) noexcept;
 
+  /// true if a frame info received, resumed only if it expects to redraw.
   bool poll_events() noexcept;
 
   opaque() noexcept;
@@ -69,7 +80,13 @@ private:
 
 private:
   std::atomic<enums::raw<status>> state_;
-  core::fifo<scene::frame_info>   frame_info_queue_;
+  /// bound before the loop started, rendering thread only.
+  std::function<void(std::chrono::milliseconds)> idle_;
+  /// published by the controller thread and by the render thread when it
+  /// redraws, the writers are serialized, the reader never locks.
+  /// the snapshots are handed over rather than the frames copied.
+  std::mutex                      publish_mutex_;
+  core::triple_buffer<core::snapshot<scene::frame_info>> frame_info_mailbox_;
   scene::frame_info               frame_info_;
   uptr<esim_render_pipe>          pipeline_;
 
@@ -83,6 +100,7 @@ private:
   GLuint                                   hdr_fbo_, rbo_depth_;
   std::vector<GLuint>                      color_buffers_;
   gl::texture                              noise_;
+  bool                                     noise_ready_;
   gl::buffer<esim::details::screen_vertex> quad_vbo_;
 };
 
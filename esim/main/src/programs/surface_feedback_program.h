@@ -0,0 +1,96 @@
+#ifndef __ESIM_MAIN_SOURCE_SCENE_PROGRAM_SURFACE_FEEDBACK_PROGRAM_H_
+#define __ESIM_MAIN_SOURCE_SCENE_PROGRAM_SURFACE_FEEDBACK_PROGRAM_H_
+
+#include "common_program.h"
+#include "surface_program.h"
+
+namespace esim {
+
+namespace program {
+
+/**
+ * @brief Writes the basemap page sampled by each pixel of the surface,
+ * shares the vertex buffers of surface_program.
+ *
+ */
+class surface_feedback_program final : public common_program {
+public:
+  typedef details::surface_vertex vertex_type;
+
+  static rptr<surface_feedback_program> get() noexcept;
+
+  void update_tile_uniform(const geo::maptile &tile) const noexcept;
+
+  void update_max_lod_uniform(uint32_t max_lod) const noexcept;
+
+  void update_lod_bias_uniform(float bias) const noexcept;
+
+  void enable_position_pointer() const noexcept;
+
+  void enable_texcoord_pointer() const noexcept;
+
+  surface_feedback_program() noexcept;
+
+  ~surface_feedback_program() noexcept;
+
+private:
+  gl::shader vshader_, fshader_;
+  GLint location_tile_, location_max_lod_, location_lod_bias_;
+  GLint location_pos_, location_texcoord_;
+};
+
+inline rptr<surface_feedback_program> surface_feedback_program::get() noexcept {
+  static uptr<surface_feedback_program> single;
+  if (nullptr == single) {
+    single = make_uptr<surface_feedback_program>();
+  }
+
+  return single.get();
+}
+
+inline void surface_feedback_program::update_tile_uniform(const geo::maptile &tile) const noexcept {
+  glUniform3ui(location_tile_, tile.lod, tile.x, tile.y);
+}
+
+inline void surface_feedback_program::update_max_lod_uniform(uint32_t max_lod) const noexcept {
+  glUniform1ui(location_max_lod_, max_lod);
+}
+
+inline void surface_feedback_program::update_lod_bias_uniform(float bias) const noexcept {
+  glUniform1f(location_lod_bias_, bias);
+}
+
+inline void surface_feedback_program::enable_position_pointer() const noexcept {
+  glEnableVertexAttribArray(location_pos_);
+  glVertexAttribPointer(location_pos_, 3, GL_FLOAT, GL_FALSE,
+                        sizeof(vertex_type), (void *)0);
+}
+
+inline void surface_feedback_program::enable_texcoord_pointer() const noexcept {
+  glEnableVertexAttribArray(location_texcoord_);
+  glVertexAttribPointer(location_texcoord_, 2, GL_FLOAT, GL_FALSE,
+                        sizeof(vertex_type),
+                        (void *)(sizeof(vertex_type::pos) + sizeof(vertex_type::normal)));
+}
+
+inline surface_feedback_program::surface_feedback_program() noexcept
+    : vshader_{GL_VERTEX_SHADER}, fshader_{GL_FRAGMENT_SHADER} {
+  vshader_.compile_from_file("assets/glsl/surface_feedback.vert");
+  fshader_.compile_from_file("assets/glsl/surface_feedback.frag");
+  assert(link_shader_and_common_shaders(vshader_, fshader_));
+
+  location_tile_     = uniform_location("u_Tile");
+  location_max_lod_  = uniform_location("u_MaxLod");
+  location_lod_bias_ = uniform_location("u_LodBias");
+
+  location_pos_      = attribute_location("a_Pos");
+  location_texcoord_ = attribute_location("a_TexCoord");
+}
+
+inline surface_feedback_program::~surface_feedback_program() noexcept {}
+
+} // namespace program
+
+} // namespace esim
+
+#endif
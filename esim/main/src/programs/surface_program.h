@@ -24,7 +24,12 @@ public:
 
   static rptr<surface_program> get() noexcept;
 
-  void update_basemap_uniform(rptr<basemap> bm, basemap_texinfo info) const noexcept;
+  /**
+   * @brief Select the layer and region of basemap, the texture array is bound once per frame.
+   *
+   * @param binding specifies the basemap bound to the tile.
+   */
+  void update_basemap_uniform(const basemap_binding &binding) const noexcept;
 
   void enable_position_pointer() const noexcept;
 
@@ -38,7 +43,7 @@ public:
 
 private:
   gl::shader vshader_, fshader_;
-  GLint location_use_basemap_, location_tex_offset_, location_tex_scale_;
+  GLint location_tex_transform_;
   GLint location_pos_, location_normal_, location_texcoord_;
 };
 
@@ -51,20 +56,11 @@ inline rptr<surface_program> surface_program::get() noexcept {
   return single.get();
 }
 
-inline void surface_program::update_basemap_uniform(rptr<basemap> bm, basemap_texinfo info) const noexcept {
-  if (nullptr == bm) {
-    glUniform1i(location_use_basemap_, 0);
-  } else {
-    auto texture = bm->texture();
-    if (nullptr != texture) {
-      texture->bind();
-      glUniform1i(location_use_basemap_, 1);
-      glUniform1f(location_tex_scale_, info.scale);
-      glUniform2fv(location_tex_offset_, 1, glm::value_ptr(info.offset));
-    } else {
-      glUniform1i(location_use_basemap_, 0);
-    }
-  }
+inline void surface_program::update_basemap_uniform(const basemap_binding &binding) const noexcept {
+  /// offset, scale and layer, a negative layer means no basemap.
+  int layer = nullptr == binding.map ? -1 : binding.map->layer();
+  glUniform4f(location_tex_transform_, binding.texinfo.offset.x, binding.texinfo.offset.y,
+              binding.texinfo.scale, static_cast<float>(layer));
 }
 
 inline void surface_program::enable_position_pointer() const noexcept {
@@ -93,9 +89,7 @@ inline surface_program::surface_program() noexcept
   fshader_.compile_from_file("assets/glsl/surface.frag");
   assert(link_shader_and_common_shaders(vshader_, fshader_));
 
-  location_use_basemap_ = uniform_location("u_UseBaseMap");
-  location_tex_offset_ = uniform_location("u_TexOffset");
-  location_tex_scale_ = uniform_location("u_TexScale");
+  location_tex_transform_ = uniform_location("u_TexTransform");
 
   location_pos_      = attribute_location("a_Pos");
   location_normal_   = attribute_location("a_Normal");
@@ -1,11 +1,17 @@
 #include "scene/skysphere.h"
 #include "core/transform.h"
+#include "details/gl_loader.h"
 
 namespace esim {
 
 namespace scene {
 
 void skysphere::render(const frame_info &info) noexcept {
+  if (!skymap_ready_) {
+
+    return;
+  }
+
   auto &cmr = info.camera;
   auto program = program::skysphere_program::get();
   program->use();
@@ -24,11 +30,15 @@ skysphere::skysphere() noexcept
     : GC_rotation_{astron::mat_equator_to_galactic<float>()},
       offset_{0.0f},
       ebo_{GL_ELEMENT_ARRAY_BUFFER, 1},
-      vbo_{GL_ARRAY_BUFFER, 1} {
+      vbo_{GL_ARRAY_BUFFER, 1}, skymap_ready_{false} {
 
   vbo_.bind_buffer(gen_vertex_buffer());
   ebo_.bind_buffer(gen_element_buffer());
-  assert(skymap_.load("assets/img/starmap_g4k.jpg"));
+  /// 4k starmap is decoded and uploaded off the rendering thread.
+  gl_loader::get()->load_texture(skymap_, "assets/img/starmap_g4k.jpg", [this](bool loaded) {
+    assert(loaded);
+    skymap_ready_ = loaded;
+  });
 }
 
 skysphere::~skysphere() noexcept {}
@@ -32,6 +32,8 @@ private:
   gl::buffer<uint32_t>                        ebo_;
   gl::buffer<esim::details::skysphere_vertex> vbo_;
   gl::texture                                 skymap_;
+  /// uploaded by the loader thread.
+  bool                                        skymap_ready_;
 };
 
 } // namespace scene
@@ -5,23 +5,87 @@ namespace esim {
 
 namespace scene {
 
+namespace details {
+
+/// frames between feedbacks, each costs a draw per tile at low resolution.
+constexpr static size_t feedback_interval = 4;
+/// preparations a candidate stays collapsed before its descendants evicted.
+constexpr static size_t tile_evict_delay = 120;
+/// quiet frames before settled, the feedbacks read back late request the last pages.
+constexpr static size_t settle_frames = 3 * feedback_interval;
+
+} // namespace details
+
 void surface_collection::render(const scene::frame_info &info) noexcept {
+  render_epoch_.enter();
   auto program = program::surface_program::get();
   program->use();
   program->update_common_uniform(info);
 
-  updating_queue_.try_push(info);
+  updating_frame_.publish(info);
+  schedule_prepare();
   if (next_frame_prepared_.load(std::memory_order_acquire)) {
     render_tiles_.swap(next_frame_tiles_);
     next_frame_prepared_.store(false, std::memory_order_release);
   }
 
-  for (auto &node : render_tiles_) {
-    auto [basemap, texinfo] = basemaps_.get(node->details(), !info.is_moving);
-    program->update_basemap_uniform(basemap, texinfo);
+  /// the prefetched steps are swapped in without fetching.
+  prepare_draw_tiles(basemaps_.set_time(info.time_step));
+  basemaps_.bind_textures();
+  for (auto &node : draw_tiles_) {
+    auto &binding = node->binding();
+    basemaps_.use(binding);
+    program->update_basemap_uniform(binding);
     ebo_.bind(0); node->render(info, ebo_.size(0));
     ebo_.bind(1); node->render(info, ebo_.size(1));
   }
+  render_feedback(info);
+  basemaps_.trim();
+  ++frame_;
+  uploads_.drain();
+  /// the frame published but not acquired yet by the preparation is not counted.
+  if (outdated_.load(std::memory_order_acquire) || next_frame_prepared_.load(std::memory_order_acquire) ||
+      uploads_.statistics().queue_depth > 0 || basemaps_.in_flight() > 0) {
+    quiet_frames_ = 0;
+  } else if (!updating_frame_.dirty()) {
+    ++quiet_frames_;
+  }
+  render_epoch_.leave();
+  /// the frame boundary, the tiles retired two frames before are deleted here
+  /// along with their buffers, the context is current on this thread.
+  tiles_epoch_.advance();
+}
+
+void surface_collection::render_feedback(const scene::frame_info &info) noexcept {
+  /// only the pages really sampled are requested, the most visible first.
+  if (feedback_.analyze(feedback_pages_)) {
+    for (auto &page : feedback_pages_) {
+      basemaps_.request(page.tile, !info.is_moving);
+    }
+    /// the current step first, the following steps share the rest of queue.
+    if (!info.is_moving) {
+      for (auto &page : feedback_pages_) {
+        basemaps_.prefetch(page.tile);
+      }
+    }
+  }
+  if (0 != frame_ % details::feedback_interval || draw_tiles_.empty()) {
+
+    return;
+  }
+
+  auto program = program::surface_feedback_program::get();
+  feedback_.begin(info.camera.viewport());
+  program->use();
+  program->update_common_uniform(info);
+  program->update_max_lod_uniform(static_cast<uint32_t>(basemaps_.max_lod() - 1));
+  program->update_lod_bias_uniform(feedback_.lod_bias());
+  /// skirts hide cracks only, never sample pages of their own.
+  ebo_.bind(0);
+  for (auto &node : draw_tiles_) {
+    node->render_feedback(info, ebo_.size(0));
+  }
+  feedback_.end();
 }
 
 void surface_collection::render_bounding_box([[maybe_unused]] const scene::frame_info &info) noexcept {
@@ -31,53 +95,72 @@ void surface_collection::render_bounding_box([[maybe_unused]] const scene::frame
   program->use();
   program->update_common_uniform(info);
   program->update_line_color_uniform(vec4{0.0, 1.0, 0.0, 0.8});
-  for (auto &node : render_tiles_) {
+  for (auto &node : draw_tiles_) {
     node->render_bounding_box(info, ebo_.size(2));
   }
 }
 
+upload_statistics surface_collection::uploads() const noexcept {
+
+  return uploads_.statistics();
+}
+
+bool surface_collection::is_settling() const noexcept {
+
+  return quiet_frames_ < details::settle_frames;
+}
+
 surface_collection::surface_collection(size_t vertex_details) noexcept
     : vertex_details_{vertex_details}, ebo_{GL_ELEMENT_ARRAY_BUFFER, 3},
-      next_frame_prepared_{false}, is_working_{false},
-      surface_root_{make_uptr<surface_tile>(geo::maptile{0, 0, 0})},
-      basemaps_{"server.arcgisonline.com", "/arcgis/rest/services/World_Imagery/MapServer/tile/{z}/{x}/{y}", 16}, 
-      surface_vertices_engine_{make_uptr<surface_vertex_engine>(30)}, updating_queue_{256} {
+      next_frame_prepared_{false}, is_working_{false}, prepare_scheduled_{false}, outdated_{false},
+      surface_root_{surface_tile::pool()->make(geo::maptile{0, 0, 0})},
+      generation_{0}, published_{0}, consumed_{0},
+      frame_{1}, quiet_frames_{0},
+      /// tiles seeded by esim_tilepack are preferred to the server.
+      basemaps_{make_uptr<cache_tile_source>(
+                    "tiles",
+                    make_uptr<http_tile_source>("server.arcgisonline.com",
+                                                "/arcgis/rest/services/World_Imagery/MapServer/tile/{z}/{x}/{y}")),
+                16, &uploads_},
+      surface_vertices_engine_{make_uptr<surface_vertex_engine>(30)},
+      render_epoch_{tiles_epoch_} {
   ebo_.bind_buffer(surface_vertices_engine_->export_center_element_buffer(), GL_STATIC_DRAW, 0);
   ebo_.bind_buffer(surface_vertices_engine_->export_skirt_element_buffer(), GL_STATIC_DRAW, 1);
   ebo_.bind_buffer(surface_vertices_engine_->export_obb_element_buffer(), GL_STATIC_DRAW, 2);
-  candidate_tiles_.emplace(surface_root_.get());
+  candidate_tiles_.try_emplace(surface_root_->details(), surface_root_.get());
+  basemaps_.bind_listener([this](const geo::maptile &tile, rptr<basemap> map) {
+    this->refine_bindings(tile, map);
+  });
   is_working_.store(true, std::memory_order_release);
-
-  std::thread([=]() {
-    while (is_working_.load(std::memory_order_acquire)) {
-      this->prepare_render();
-    }
-  }).detach();
 }
 
 surface_collection::~surface_collection() noexcept {
-  is_working_.store(false, std::memory_order_relaxed);
+  is_working_.store(false, std::memory_order_release);
+  prepare_.wait();
 }
 
 void surface_collection::adjust_candidates() noexcept {
+  ++generation_;
   auto prev_candidates = std::move(candidate_tiles_);
+  candidate_tiles_.reserve(prev_candidates.size() * 4);
 
-  for (auto &node : prev_candidates) {
+  for (auto &[tile, node] : prev_candidates) {
     auto [too_far, too_near] = node->is_enough_resolution(last_frame_);
-    if (too_far) {
-      candidate_tiles_.emplace(node->collapse());
+    if (auto parent = node->collapse(); too_far && nullptr != parent) {
+      candidate_tiles_.try_emplace(parent->details(), parent);
     } else if (too_near) {
-      auto children = node->expand();
-      candidate_tiles_.insert(children.begin(), children.end());
+      for (auto child : node->expand()) {
+        candidate_tiles_.try_emplace(child->details(), child);
+      }
     } else {
-      candidate_tiles_.emplace(node);
+      candidate_tiles_.try_emplace(tile, node);
     }
   }
 
   std::vector<rptr<surface_tile>> slice_tiles;
-  for (auto &node : candidate_tiles_) {
+  for (auto &[tile, node] : candidate_tiles_) {
     auto parent = node->collapse();
-    if (candidate_tiles_.count(parent)) {
+    if (nullptr != parent && candidate_tiles_.count(parent->details())) {
       /// the parent existence means
       /// there exists at least one collapsed brother before,
       /// ignore the current node therefore.
@@ -86,40 +169,160 @@ void surface_collection::adjust_candidates() noexcept {
   }
 
   for (auto &node : slice_tiles) {
-    candidate_tiles_.erase(node);
+    candidate_tiles_.erase(node->details());
+  }
+  for (auto &[tile, node] : candidate_tiles_) {
+    node->mark_candidate(generation_);
   }
 }
 
 void surface_collection::prepare_render() noexcept {
-  frame_info next_frame;
-
-  if (!updating_queue_.try_pop(next_frame)) {
-    std::this_thread::yield();
+  if (!updating_frame_.acquire()) {
     return;
   }
 
-  while (updating_queue_.try_pop(next_frame))
-    ;
-
+  auto &next_frame = updating_frame_.read_buffer();
   if (last_frame_.expect_redraw(next_frame)) {
-    last_frame_ = std::move(next_frame);
+    last_frame_ = next_frame;
     adjust_candidates();
-    if (next_frame_prepared_.load(std::memory_order_acquire)) {
-      std::this_thread::yield();
-    } else {
-      next_frame_tiles_.clear();
+    outdated_.store(true, std::memory_order_release);
+  }
+  /// the candidates adjusted before the last tiles consumed are published
+  /// by the preparation of a following frame, even if nothing changed since.
+  if (!outdated_.load(std::memory_order_relaxed) || next_frame_prepared_.load(std::memory_order_acquire)) {
+
+    return;
+  }
+
+  /// the render tiles are those published last once consumed.
+  consumed_ = published_;
+  evict_tiles();
+  next_frame_tiles_.clear();
+
+  for (auto &[tile, node] : candidate_tiles_) {
+    if (!node->is_ready_to_render()) {
+      node->gen_vertex_buffer(surface_vertices_engine_->gen_surface_vertices(node->details()));
+    }
+
+    if (node->is_visible(last_frame_)) {
+      next_frame_tiles_.emplace_back(node);
+    }
+  }
 
-      for (auto &node : candidate_tiles_) {
-        if (!node->is_ready_to_render()) {
-          node->gen_vertex_buffer(surface_vertices_engine_->gen_surface_vertices(node->details()));
-        }
+  published_ = generation_;
+  /// prepared before no longer outdated, the rendering thread sees either.
+  next_frame_prepared_.store(true, std::memory_order_release);
+  outdated_.store(false, std::memory_order_release);
+}
+
+void surface_collection::schedule_prepare() noexcept {
+  if (!is_working_.load(std::memory_order_acquire) ||
+      prepare_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+
+    return;
+  }
+
+  /// the refinement of lod never queues behind the background work.
+  prepare_.submit([this]() {
+    prepare_render();
+    prepare_scheduled_.store(false, std::memory_order_release);
+    /// published while preparing, picked up rather than waiting for the next frame.
+    if (updating_frame_.dirty()) {
+      schedule_prepare();
+    }
+  }, core::task_priority::high);
+}
+
+void surface_collection::evict_tiles() noexcept {
+  for (auto &[tile, node] : candidate_tiles_) {
+    /// the descendants are absent from the frames published since,
+    /// and the rendering thread holds one of them already.
+    auto since = node->candidate_since();
+    if (!node->is_expanded() || since > consumed_ || generation_ - since < details::tile_evict_delay) {
+      continue;
+    }
+    for (auto &child : node->prune()) {
+      tiles_epoch_.retire([this, child = child.release()]() { release(child); });
+    }
+  }
+}
+
+void surface_collection::release(rptr<surface_tile> node) noexcept {
+  /// delivered on the rendering thread, the loader may still upload.
+  if (is_working_.load(std::memory_order_acquire) && node->is_busy()) {
+    tiles_epoch_.retire([this, node]() { release(node); });
+
+    return;
+  }
+
+  surface_tile::pool()->destroy(node);
+}
+
+void surface_collection::prepare_draw_tiles(bool rebind) noexcept {
+  auto is_substituted = [this](rptr<surface_tile> node) {
+    for (auto parent = node->collapse(); nullptr != parent; parent = parent->collapse()) {
+      if (substitute_tiles_.count(parent->details())) {
+
+        return true;
+      }
+    }
+
+    return false;
+  };
+
+  draw_tiles_.clear();
+  substitute_tiles_.clear();
+  for (auto &node : render_tiles_) {
+    if (node->is_uploaded()) {
+      continue;
+    }
+    if (node->mark_upload_scheduled()) {
+      uploads_.schedule([node]() { return node->upload_buffers(); },
+                        [node](size_t) { node->mark_uploaded(); });
+    }
+    auto parent = node->collapse();
+    while (nullptr != parent && !parent->is_uploaded()) {
+      parent = parent->collapse();
+    }
+    if (nullptr != parent) {
+      substitute_tiles_.try_emplace(parent->details(), parent);
+    }
+  }
 
-        if (node->is_visible(last_frame_)) {
-          next_frame_tiles_.emplace_back(node);
-        }
+  if (substitute_tiles_.empty()) {
+    draw_tiles_.assign(render_tiles_.begin(), render_tiles_.end());
+  } else {
+    /// an ancestor covers all its descendants, siblings are drawn by it as well.
+    for (auto &[tile, node] : substitute_tiles_) {
+      if (!is_substituted(node)) {
+        draw_tiles_.emplace_back(node);
       }
-      
-      next_frame_prepared_.store(true, std::memory_order_release);
+    }
+    for (auto &node : render_tiles_) {
+      if (node->is_uploaded() && !is_substituted(node)) {
+        draw_tiles_.emplace_back(node);
+      }
+    }
+  }
+
+  /// basemaps used by the previous frame are never evicted, bindings of
+  /// tiles drawn continuously stay valid and are refined once uploaded.
+  for (auto &node : draw_tiles_) {
+    if (!node->mark_drawn(frame_) || rebind) {
+      node->bind_basemap(basemaps_.resolve(node->details()));
+    }
+  }
+}
+
+void surface_collection::refine_bindings(const geo::maptile &tile, rptr<basemap> map) noexcept {
+  for (auto &node : draw_tiles_) {
+    auto &current = node->details();
+    if (current.lod < tile.lod || node->binding().tile.lod >= tile.lod) {
+      continue;
+    }
+    uint32_t depth = current.lod - tile.lod;
+    if ((current.x >> depth) == tile.x && (current.y >> depth) == tile.y) {
+      node->bind_basemap(basemap_storage::bind(current, tile, map));
     }
   }
 }
@@ -1,18 +1,22 @@
 #ifndef __ESIM_MAIN_SOURCE_SCENE_SURFACE_COLLECTION_H_
 #define __ESIM_MAIN_SOURCE_SCENE_SURFACE_COLLECTION_H_
 
-#include "core/fifo.h"
+#include "core/epoch.h"
+#include "core/executor.h"
+#include "core/flat_map.h"
+#include "core/triple_buffer.h"
 #include "core/utils.h"
 #include "details/basemap_storage.h"
+#include "details/page_feedback.h"
 #include "details/surface_vertex_engine.h"
+#include "details/upload_scheduler.h"
 #include "glapi/buffer.h"
+#include "programs/surface_feedback_program.h"
 #include "programs/surface_program.h"
 #include "scene_entity.h"
 #include "surface_tile.h"
 #include <atomic>
 #include <thread>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace esim {
 
@@ -24,6 +28,21 @@ public:
 
   void render_bounding_box(const scene::frame_info &info) noexcept;
 
+  /**
+   * @brief Obtain the uploads performed by the last frame.
+   *
+   * @return the statistics of uploads.
+   */
+  upload_statistics uploads() const noexcept;
+
+  /**
+   * @brief Check if the following frames may differ without any new frame info,
+   * e.g. the tiles preparing, the basemaps fetching or uploading.
+   *
+   * @return true until a few frames passed with nothing in flight.
+   */
+  bool is_settling() const noexcept;
+
   surface_collection(size_t vertex_details) noexcept;
 
   ~surface_collection() noexcept;
@@ -34,18 +53,60 @@ private:
 
   void prepare_render() noexcept;
 
+  /// prepares the frame published on a worker, at most one in flight.
+  void schedule_prepare() noexcept;
+
+  /// retires the descendants of the candidates collapsed long enough,
+  /// once the rendering thread consumed a frame without them.
+  void evict_tiles() noexcept;
+
+  /// deletes the subtree retired on the rendering thread,
+  /// retired again while any upload of it in flight.
+  void release(rptr<surface_tile> node) noexcept;
+
+  /// schedules the uploads of render tiles,
+  /// the nearest uploaded ancestor is drawn until uploaded.
+  /// all bindings are resolved again if rebind, e.g. the time step switched.
+  void prepare_draw_tiles(bool rebind) noexcept;
+
+  /// rebinds the drawn tiles covered by the basemap just uploaded.
+  void refine_bindings(const geo::maptile &tile, rptr<basemap> map) noexcept;
+
+  /// requests the pages of the last feedback finished and prefetches them
+  /// in the next time steps, then renders the next feedback.
+  void render_feedback(const scene::frame_info &info) noexcept;
+
 private:
   size_t                                 vertex_details_;
   gl::buffer<uint16_t>                   ebo_;
-  std::atomic<bool>                      next_frame_prepared_, is_working_;
-  uptr<surface_tile>                     surface_root_;
+  std::atomic<bool>                      next_frame_prepared_, is_working_, prepare_scheduled_;
+  /// the candidates adjusted to a frame not published as render tiles yet.
+  std::atomic<bool>                      outdated_;
+  core::pool_ptr<surface_tile>           surface_root_;
   std::vector<rptr<surface_tile>>        render_tiles_, next_frame_tiles_;
-  std::unordered_set<rptr<surface_tile>> candidate_tiles_;
+  core::flat_map<geo::maptile, rptr<surface_tile>> candidate_tiles_;
+  /// preparations counted, the generation published last and consumed last.
+  size_t                                 generation_, published_, consumed_;
+  /// rendering thread only.
+  std::vector<rptr<surface_tile>>        draw_tiles_;
+  core::flat_map<geo::maptile, rptr<surface_tile>> substitute_tiles_;
+  size_t                                 frame_;
+  /// frames drawn since anything in flight, the feedbacks need a few of them.
+  size_t                                 quiet_frames_;
+  page_feedback                          feedback_;
+  std::vector<feedback_page>             feedback_pages_;
+  upload_scheduler                       uploads_;
   basemap_storage                        basemaps_;
   uptr<surface_vertex_engine>            surface_vertices_engine_;
   
-  core::fifo<frame_info> updating_queue_;
-  frame_info             last_frame_;
+  /// published by the render thread, acquired by the prepare task.
+  core::triple_buffer<frame_info> updating_frame_;
+  frame_info                      last_frame_;
+  /// tiles retired by the preparation, deleted once the rendering thread
+  /// passed the frame boundaries, where the epoch advances.
+  core::epoch_domain              tiles_epoch_;
+  core::epoch_participant         render_epoch_;
+  core::task_group                prepare_;
 };
 
 } // namespace scene
@@ -12,7 +12,7 @@ const geo::maptile &surface_tile::details() const noexcept {
   return info_;
 }
 
-void surface_tile::gen_vertex_buffer(uptr<surface_vertices> generator) noexcept {
+void surface_tile::gen_vertex_buffer(core::pool_ptr<surface_vertices> generator) noexcept {
   assert(nullptr != generator);
   vertices_generator_ = std::move(generator);
   vertices_generator_->calculate();
@@ -25,59 +25,126 @@ bool surface_tile::is_ready_to_render() const noexcept {
   return ready_to_render_;
 }
 
-void surface_tile::before_render() noexcept {
-  if (!buffer_generated_) {
-    vbo_ = make_uptr<gl::buffer<details::surface_vertex>>(GL_ARRAY_BUFFER, 2);
-    vbo_->bind_buffer(vertices_generator_->export_buffer(), GL_STATIC_DRAW, 0);
+bool surface_tile::is_uploaded() const noexcept {
 
-    obb_vbo_ = make_uptr<gl::buffer<details::bounding_box_vertex>>(GL_ARRAY_BUFFER);
-    obb_vbo_->bind_buffer(vertices_generator_->export_obb_buffer());
+  return buffer_generated_;
+}
+
+bool surface_tile::is_busy() const noexcept {
+  if (upload_scheduled_) {
+
+    return true;
+  }
+  for (auto &child : children_) {
+    if (nullptr != child && child->is_busy()) {
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool surface_tile::mark_upload_scheduled() noexcept {
+  if (buffer_generated_ || upload_scheduled_) {
 
-    buffer_generated_ = true;
+    return false;
   }
+  upload_scheduled_ = true;
+
+  return true;
+}
+
+size_t surface_tile::upload_buffers() noexcept {
+  assert(ready_to_render_);
+  auto vertices = vertices_generator_->export_buffer();
+  auto obb_vertices = vertices_generator_->export_obb_buffer();
+  size_t bytes = vertices.size() * sizeof(details::surface_vertex) +
+                 obb_vertices.size() * sizeof(details::bounding_box_vertex);
+
+  vbo_ = make_uptr<gl::buffer<details::surface_vertex>>(GL_ARRAY_BUFFER, 2);
+  vbo_->bind_buffer(std::move(vertices), GL_STATIC_DRAW, 0);
+
+  obb_vbo_ = make_uptr<gl::buffer<details::bounding_box_vertex>>(GL_ARRAY_BUFFER);
+  obb_vbo_->bind_buffer(std::move(obb_vertices));
+
+  return bytes;
+}
+
+void surface_tile::mark_uploaded() noexcept {
+  buffer_generated_ = true;
+  upload_scheduled_ = false;
+}
+
+const basemap_binding &surface_tile::binding() const noexcept {
+
+  return binding_;
+}
+
+void surface_tile::bind_basemap(const basemap_binding &binding) noexcept {
+  binding_ = binding;
+}
+
+bool surface_tile::mark_drawn(size_t frame) noexcept {
+  bool continuous = last_drawn_ + 1 == frame;
+  last_drawn_ = frame;
+
+  return continuous;
 }
 
 void surface_tile::render(const scene::frame_info &info,
                           size_t indices_count) noexcept {
-  using namespace glm;
-  before_render();
-  auto &sun = info.sun;
-  auto &cmr = info.camera;
-  auto ERA = rotate(dmat4x4{1.0f}, astron::era<double>(sun.julian_date()), dvec3{0.0f, 0.0f, 1.0f});
-  dvec3 offset_era = ERA * dvec4{offset_, 1.0};
-  auto model = cmr.translate(dmat4x4{1.0f}, offset_era) * ERA;
-
+  assert(buffer_generated_);
   auto program = program::surface_program::get();
   vbo_->bind();
   program->enable_position_pointer();
   program->enable_normal_pointer();
   program->enable_texcoord_pointer();
-  program->update_model_uniform(static_cast<mat4x4>(model));
+  program->update_model_uniform(model_matrix(info));
   glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices_count), GL_UNSIGNED_SHORT, nullptr);
 }
 
 void surface_tile::render_bounding_box(const scene::frame_info &info,
                                        size_t indices_count) noexcept {
-  using namespace glm;
-  before_render();
-  auto &sun = info.sun;
-  auto &cmr = info.camera;
-  auto ERA = rotate(dmat4x4{1.0f}, astron::era<double>(sun.julian_date()), dvec3{0.0f, 0.0f, 1.0f});
-  dvec3 offset_era = ERA * dvec4{offset_, 1.0};
-  auto model = cmr.translate(dmat4x4{1.0f}, offset_era) * ERA;
-  
+  assert(buffer_generated_);
   auto program = program::bounding_box_program::get();
   obb_vbo_->bind();
   program->enable_position_pointer();
-  program->update_model_uniform(static_cast<mat4x4>(model));
+  program->update_model_uniform(model_matrix(info));
   glPointSize(10.f);
   glDrawElements(GL_LINES, static_cast<GLsizei>(indices_count), GL_UNSIGNED_SHORT, nullptr);
   glDrawElements(GL_POINTS, static_cast<GLsizei>(indices_count), GL_UNSIGNED_SHORT, nullptr);
 }
 
+void surface_tile::render_feedback(const scene::frame_info &info,
+                                   size_t indices_count) noexcept {
+  assert(buffer_generated_);
+  auto program = program::surface_feedback_program::get();
+  vbo_->bind();
+  program->enable_position_pointer();
+  program->enable_texcoord_pointer();
+  program->update_model_uniform(model_matrix(info));
+  program->update_tile_uniform(info_);
+  glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices_count), GL_UNSIGNED_SHORT, nullptr);
+}
+
+glm::mat4x4 surface_tile::model_matrix(const scene::frame_info &info) const noexcept {
+  using namespace glm;
+  auto &sun = info.sun;
+  auto &cmr = info.camera;
+  auto ERA = rotate(dmat4x4{1.0f}, astron::era<double>(sun.julian_date()), dvec3{0.0f, 0.0f, 1.0f});
+  dvec3 offset_era = ERA * dvec4{offset_, 1.0};
+  auto model = cmr.translate(dmat4x4{1.0f}, offset_era) * ERA;
+
+  return static_cast<mat4x4>(model);
+}
+
 surface_tile::surface_tile(geo::maptile tile) noexcept
     : info_{tile}, ready_to_render_{false}, buffer_generated_{false},
-      offset_{0.0f}, parent_{nullptr} {
+      upload_scheduled_{false},
+      offset_{0.0f}, binding_{tile, nullptr, basemap_texinfo{1.0f, glm::vec2{0.0f}}},
+      last_drawn_{SIZE_MAX}, last_candidate_{SIZE_MAX}, candidate_since_{0},
+      parent_{nullptr} {
 }
 
 std::pair<bool, bool>
@@ -149,7 +216,7 @@ std::array<rptr<surface_tile>, 4> surface_tile::expand() noexcept {
                                                  geo::maptile{child_info.lod, child_info.x + 1, child_info.y},
                                                  geo::maptile{child_info.lod, child_info.x + 1, child_info.y + 1}};
     for (size_t i = 0; i < 4; ++i) {
-      children_[i] = make_uptr<surface_tile>(children_info[i]);
+      children_[i] = pool()->make(children_info[i]);
       children_[i]->parent_ = this;
     }
   }
@@ -166,6 +233,35 @@ rptr<surface_tile> surface_tile::collapse() noexcept {
   return parent_;
 }
 
+bool surface_tile::is_expanded() const noexcept {
+
+  return nullptr != children_.front();
+}
+
+std::array<core::pool_ptr<surface_tile>, 4> surface_tile::prune() noexcept {
+
+  return std::move(children_);
+}
+
+void surface_tile::mark_candidate(size_t generation) noexcept {
+  if (last_candidate_ + 1 != generation) {
+    candidate_since_ = generation;
+  }
+  last_candidate_ = generation;
+}
+
+size_t surface_tile::candidate_since() const noexcept {
+
+  return candidate_since_;
+}
+
+rptr<core::object_pool<surface_tile>> surface_tile::pool() noexcept {
+  /// never destroyed, the tiles may be released by static destructors.
+  static auto *single = new core::object_pool<surface_tile>{};
+
+  return single;
+}
+
 } // namespace scene
 
 } // namespace esim
@@ -2,12 +2,15 @@
 #define __ESIM_MAIN_SOURCE_SCENE_SURFACE_TILE_H_
 
 #include "core/bounding_box.h"
+#include "core/object_pool.h"
 #include "core/transform.h"
+#include "details/basemap_storage.h"
 #include "details/information.h"
 #include "details/surface_vertex_engine.h"
 #include "glapi/buffer.h"
 #include "glapi/texture.h"
 #include "programs/bounding_box_program.h"
+#include "programs/surface_feedback_program.h"
 #include "programs/surface_program.h"
 #include <array>
 
@@ -19,14 +22,68 @@ class surface_tile final {
 public:
   const geo::maptile &details() const noexcept;
 
-  void gen_vertex_buffer(uptr<surface_vertices> generator) noexcept;
+  void gen_vertex_buffer(core::pool_ptr<surface_vertices> generator) noexcept;
 
   bool is_ready_to_render() const noexcept;
 
+  bool is_uploaded() const noexcept;
+
+  /**
+   * @brief Check if an upload of the tile or its descendants is in flight,
+   * accessed by the rendering thread only.
+   *
+   */
+  bool is_busy() const noexcept;
+
+  /**
+   * @brief Mark the vertex buffers as scheduled to upload.
+   *
+   * @return true if marked, false if already scheduled or uploaded.
+   */
+  bool mark_upload_scheduled() noexcept;
+
+  /**
+   * @brief Upload the generated vertices into vertex buffers,
+   * may be called by the loader thread.
+   *
+   * @return the bytes uploaded.
+   */
+  size_t upload_buffers() noexcept;
+
+  /**
+   * @brief Mark the buffers as usable once the upload is visible to the rendering thread.
+   *
+   */
+  void mark_uploaded() noexcept;
+
+  /**
+   * @brief Obtain the basemap bound, resolved once rather than per draw.
+   *
+   */
+  const basemap_binding &binding() const noexcept;
+
+  void bind_basemap(const basemap_binding &binding) noexcept;
+
+  /**
+   * @brief Mark the tile as drawn by the frame.
+   *
+   * @param frame specifies the index of frame.
+   * @return true if drawn by the previous frame as well, false otherwise.
+   */
+  bool mark_drawn(size_t frame) noexcept;
+
   void render(const scene::frame_info &info, size_t indices_count) noexcept;
 
   void render_bounding_box(const scene::frame_info &info, size_t indices_count) noexcept;
 
+  /**
+   * @brief Draw the basemap pages sampled into the feedback framebuffer bound.
+   *
+   * @param info specifies the frame.
+   * @param indices_count specifies the count of indices.
+   */
+  void render_feedback(const scene::frame_info &info, size_t indices_count) noexcept;
+
   surface_tile(geo::maptile tile) noexcept;
 
   ~surface_tile() = default;
@@ -39,20 +96,54 @@ public:
 
   rptr<surface_tile> collapse() noexcept;
 
+  bool is_expanded() const noexcept;
+
+  /**
+   * @brief Detach the children along with their descendants, expanded again
+   * from scratch if needed.
+   *
+   * @return the children detached, empty if not expanded.
+   */
+  std::array<core::pool_ptr<surface_tile>, 4> prune() noexcept;
+
+  /**
+   * @brief Mark the tile as a candidate by the preparation.
+   *
+   * @param generation specifies the index of preparation.
+   */
+  void mark_candidate(size_t generation) noexcept;
+
+  /**
+   * @brief Obtain the first preparation the tile being a candidate continuously since.
+   *
+   */
+  size_t candidate_since() const noexcept;
+
+  /**
+   * @brief Obtain the pool the tiles expanded from, the siblings are adjacent.
+   *
+   * @return the pool shared by the process.
+   */
+  static rptr<core::object_pool<surface_tile>> pool() noexcept;
+
 private:
-  void before_render() noexcept;
+  glm::mat4x4 model_matrix(const scene::frame_info &info) const noexcept;
 
 private:
   const geo::maptile                        info_;
-  bool                                      ready_to_render_, buffer_generated_;
+  bool                                      ready_to_render_, buffer_generated_,
+                                            upload_scheduled_;
   glm::dvec3                                offset_;
-  gl::texture                               basemap_;
-  uptr<surface_vertices>                    vertices_generator_;
+  basemap_binding                           binding_;
+  size_t                                    last_drawn_;
+  /// accessed by the preparation only.
+  size_t                                    last_candidate_, candidate_since_;
+  core::pool_ptr<surface_vertices>          vertices_generator_;
   uptr<gl::buffer<details::surface_vertex>>      vbo_;
   uptr<gl::buffer<details::bounding_box_vertex>> obb_vbo_;
 
   rptr<surface_tile>                parent_;
-  std::array<uptr<surface_tile>, 4> children_;
+  std::array<core::pool_ptr<surface_tile>, 4> children_;
 };
 
 } // namespace scene
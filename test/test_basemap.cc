@@ -0,0 +1,94 @@
+#include "details/basemap_storage.h"
+#include "test_helper.h"
+#include "tile_source_helper.h"
+#include <chrono>
+
+#define TEST_NAME esim_basemap_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+namespace {
+
+using namespace std::chrono;
+
+using esim_test::scripted_tile_source;
+
+/// loads the basemap once, returning the time before and after the load.
+std::pair<steady_clock::time_point, steady_clock::time_point> load(esim::basemap &map,
+                                                                   scripted_tile_source &source) noexcept {
+  esim::basemap_composition composition;
+  esim::core::bitmap::allocator_type alloc = [](size_t size) {
+    return esim::core::bitmap::buffer_type(new char[size], [](char *p) { delete[] p; });
+  };
+  map.mark_requested();
+  auto before = steady_clock::now();
+  EXPECT_EQ(map.load(&source, composition, {3, 5, 2}, alloc, false), source.result);
+  auto after = steady_clock::now();
+
+  return {before, after};
+}
+
+} // namespace
+
+TEST_F(TEST_NAME, backoff) {
+  scripted_tile_source source{esim::TILE_FAILURE};
+  esim::basemap map;
+  EXPECT_TRUE(map.is_requestable(steady_clock::now()));
+
+  /// 1s doubled on every failure.
+  for (auto delay : {seconds{1}, seconds{2}, seconds{4}, seconds{8}, seconds{16}}) {
+    auto [before, after] = load(map, source);
+    EXPECT_FALSE(map.is_requested());
+    EXPECT_FALSE(map.is_no_data());
+    EXPECT_FALSE(map.is_requestable(before + delay - milliseconds{1}));
+    EXPECT_TRUE(map.is_requestable(after + delay));
+  }
+
+  /// capped at 5min, however many failures.
+  for (int i = 0; i < 20; ++i) {
+    auto [before, after] = load(map, source);
+    auto delay = std::min<milliseconds>(seconds{32} * (1 << i), minutes{5});
+    EXPECT_FALSE(map.is_requestable(before + delay - milliseconds{1}));
+    EXPECT_TRUE(map.is_requestable(after + delay));
+  }
+  EXPECT_TRUE(map.is_requestable(steady_clock::now() + minutes{5}));
+  EXPECT_EQ(source.fetches, 25u);
+}
+
+TEST_F(TEST_NAME, requested) {
+  esim::basemap map;
+  map.mark_requested();
+  EXPECT_TRUE(map.is_requested());
+  EXPECT_FALSE(map.is_requestable(steady_clock::now()));
+}
+
+TEST_F(TEST_NAME, no_data) {
+  scripted_tile_source source{esim::TILE_NO_DATA};
+  esim::basemap map;
+  load(map, source);
+
+  /// never requested again, the parent is used permanently.
+  EXPECT_TRUE(map.is_no_data());
+  EXPECT_FALSE(map.is_requested());
+  EXPECT_FALSE(map.is_ready());
+  EXPECT_FALSE(map.is_requestable(steady_clock::now()));
+  EXPECT_FALSE(map.is_requestable(steady_clock::now() + hours{24}));
+  EXPECT_EQ(map.layer(), -1);
+}
+
+TEST_F(TEST_NAME, no_data_after_failures) {
+  scripted_tile_source source{esim::TILE_FAILURE};
+  esim::basemap map;
+  load(map, source);
+  load(map, source);
+
+  /// the backoff never overrides the no data.
+  source.result = esim::TILE_NO_DATA;
+  load(map, source);
+  EXPECT_TRUE(map.is_no_data());
+  EXPECT_FALSE(map.is_requested());
+  EXPECT_FALSE(map.is_requestable(steady_clock::now() + hours{24}));
+  EXPECT_EQ(source.fetches, 3u);
+}
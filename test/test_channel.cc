@@ -0,0 +1,111 @@
+#include "core/channel.h"
+#include "test_helper.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define TEST_NAME esim_channel_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+namespace {
+
+struct message {
+  static std::atomic<int> copies;
+
+  std::string text;
+  int         value;
+
+  message(std::string t, int v) : text{std::move(t)}, value{v} {}
+
+  message(const message &other) : text{other.text}, value{other.value} { ++copies; }
+};
+
+std::atomic<int> message::copies{0};
+
+} // namespace
+
+TEST_F(TEST_NAME, snapshot_shared) {
+  esim::core::channel<message> ch;
+  auto first = ch.make("globe", 1);
+  EXPECT_TRUE(first);
+  EXPECT_EQ(first.use_count(), 1U);
+
+  auto second = first;
+  EXPECT_EQ(first.use_count(), 2U);
+  EXPECT_EQ(second.get(), first.get());
+  EXPECT_EQ(second->text, "globe");
+
+  auto moved = std::move(second);
+  EXPECT_FALSE(second);
+  EXPECT_EQ(first.use_count(), 2U);
+
+  moved = esim::core::snapshot<message>{};
+  EXPECT_EQ(first.use_count(), 1U);
+}
+
+TEST_F(TEST_NAME, fan_out_without_copies) {
+  esim::core::channel<message> ch;
+  std::vector<const message *> received;
+  for (int i = 0; i < 8; ++i) {
+    ch.subscribe([&](const esim::core::snapshot<message> &msg) { received.emplace_back(msg.get()); });
+  }
+  EXPECT_EQ(ch.subscribers(), 8U);
+
+  message::copies = 0;
+  auto msg = ch.make("frame", 42);
+  ch.publish(msg);
+  EXPECT_EQ(message::copies.load(), 0);
+  ASSERT_EQ(received.size(), 8U);
+  for (auto target : received) {
+    EXPECT_EQ(target, msg.get());
+  }
+}
+
+TEST_F(TEST_NAME, unsubscribe) {
+  esim::core::channel<message> ch;
+  int first = 0, second = 0;
+  auto id = ch.subscribe([&](const esim::core::snapshot<message> &msg) { first += msg->value; });
+  ch.subscribe([&](const esim::core::snapshot<message> &msg) { second += msg->value; });
+
+  ch.emplace("a", 1);
+  ch.unsubscribe(id);
+  ch.emplace("b", 2);
+  EXPECT_EQ(first, 1);
+  EXPECT_EQ(second, 3);
+  EXPECT_EQ(ch.subscribers(), 1U);
+}
+
+TEST_F(TEST_NAME, async_delivery) {
+  esim::core::executor pool{2};
+  std::atomic<int> sum{0};
+  std::atomic<int> mismatched{0};
+  {
+    esim::core::channel<message> ch{&pool};
+    for (int i = 0; i < 4; ++i) {
+      ch.subscribe([&](const esim::core::snapshot<message> &msg) {
+        if (msg->text != std::to_string(msg->value)) {
+          ++mismatched;
+        }
+        sum += msg->value;
+      }, esim::core::delivery::async);
+    }
+    for (int i = 0; i < 1000; ++i) {
+      ch.emplace(std::to_string(i), i);
+    }
+    /// the deliveries in flight are joined by the destruction.
+  }
+  EXPECT_EQ(mismatched.load(), 0);
+  EXPECT_EQ(sum.load(), 4 * 999 * 1000 / 2);
+}
+
+TEST_F(TEST_NAME, recycled) {
+  /// the snapshots released return into the pool, made again in place.
+  esim::core::channel<message> ch{esim::core::executor::get(), 4};
+  auto first = ch.make("x", 1).get();
+  auto again = ch.make("y", 2);
+  EXPECT_EQ(again.get(), first);
+}
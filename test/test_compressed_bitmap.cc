@@ -0,0 +1,123 @@
+#include "core/bitmap.h"
+#include "core/compressed_bitmap.h"
+#include "test_helper.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#define TEST_NAME esim_compressed_bitmap_test
+
+class TEST_NAME : public testing::Test {
+protected:
+  static esim::core::bitmap &solid(esim::core::bitmap &b, int width, int height, int channel,
+                                   const unsigned char *color) noexcept {
+    size_t size = static_cast<size_t>(width) * height * channel;
+    auto buffer = esim::core::bitmap::allocate(size);
+    for (size_t i = 0; i < size; ++i) {
+      buffer[i] = static_cast<char>(color[i % channel]);
+    }
+    b.adopt(width, height, channel, std::move(buffer));
+
+    return b;
+  }
+};
+
+TEST_F(TEST_NAME, mip_chain_layout) {
+  const unsigned char gray[] = {128};
+  esim::core::bitmap image;
+  esim::core::compressed_bitmap c;
+  ASSERT_TRUE(c.encode(solid(image, 256, 256, 1, gray)));
+
+  auto &levels = c.levels();
+  ASSERT_EQ(levels.size(), 9u);
+  EXPECT_EQ(levels[0].width, 256);
+  EXPECT_EQ(levels[0].size, 64u * 64u * 8u);
+  EXPECT_EQ(levels[8].width, 1);
+  EXPECT_EQ(levels[8].size, 8u);
+  EXPECT_EQ(c.size(), levels[8].offset + levels[8].size);
+
+  /// ~1/6 of rgb, both with mipmaps.
+  EXPECT_LT(c.size() * 5, 256u * 256u * 3u * 4u / 3u);
+}
+
+TEST_F(TEST_NAME, solid_color) {
+  const unsigned char color[] = {255, 0, 0};
+  esim::core::bitmap image;
+  esim::core::compressed_bitmap c;
+  ASSERT_TRUE(c.encode(solid(image, 8, 4, 3, color)));
+
+  /// 565 endpoint of pure red, all indices to it.
+  auto block = reinterpret_cast<const unsigned char *>(c.buffer());
+  uint16_t c0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+  EXPECT_EQ(c0, 0xF800);
+  EXPECT_EQ(block[4] | block[5] | block[6] | block[7], 0);
+}
+
+TEST_F(TEST_NAME, odd_size) {
+  const unsigned char color[] = {10, 20, 30, 255};
+  esim::core::bitmap image;
+  esim::core::compressed_bitmap c;
+  ASSERT_TRUE(c.encode(solid(image, 5, 3, 4, color)));
+  ASSERT_EQ(c.levels().size(), 3u);
+  EXPECT_EQ(c.levels()[1].width, 2);
+  EXPECT_EQ(c.levels()[1].height, 1);
+  EXPECT_EQ(c.levels()[0].size, 2u * 1u * 8u);
+}
+
+TEST_F(TEST_NAME, dds_roundtrip) {
+  std::ifstream f(std::string(ESIM_TEST_ASSETS) + "/img/test_base000.jpg", std::ios::binary);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  auto jpeg = ss.str();
+
+  esim::core::bitmap image;
+  ASSERT_TRUE(image.load(jpeg.data(), jpeg.size()));
+  esim::core::compressed_bitmap a, b;
+  ASSERT_TRUE(a.encode(image));
+
+  std::string dds;
+  ASSERT_TRUE(a.save(dds));
+  EXPECT_TRUE(esim::core::compressed_bitmap::probe(dds.data(), dds.size()));
+  ASSERT_TRUE(b.load(dds.data(), dds.size()));
+  EXPECT_EQ(a.width(), b.width());
+  EXPECT_EQ(a.height(), b.height());
+  EXPECT_EQ(a.levels().size(), b.levels().size());
+  ASSERT_EQ(a.size(), b.size());
+  EXPECT_EQ(0, std::memcmp(a.buffer(), b.buffer(), a.size()));
+
+  /// truncated dds is rejected.
+  EXPECT_FALSE(b.load(dds.data(), dds.size() - 1));
+}
+
+TEST_F(TEST_NAME, decode) {
+  const unsigned char color[] = {200, 100, 50};
+  esim::core::bitmap image, decoded;
+  esim::core::compressed_bitmap c;
+  ASSERT_TRUE(c.encode(solid(image, 6, 5, 3, color)));
+  ASSERT_TRUE(c.decode(decoded));
+
+  ASSERT_EQ(decoded.width(), 6);
+  ASSERT_EQ(decoded.height(), 5);
+  ASSERT_EQ(decoded.channel(), 3);
+  auto pixels = reinterpret_cast<const unsigned char *>(decoded.buffer());
+  /// within the quantization of 565.
+  for (int i = 0; i < 6 * 5; ++i) {
+    for (int ch = 0; ch < 3; ++ch) {
+      ASSERT_NEAR(pixels[i * 3 + ch], color[ch], 4);
+    }
+  }
+
+  esim::core::compressed_bitmap empty;
+  EXPECT_FALSE(empty.decode(decoded));
+}
+
+TEST_F(TEST_NAME, reject) {
+  const char garbage[256] = "DDS garbage";
+  esim::core::compressed_bitmap c;
+  EXPECT_FALSE(esim::core::compressed_bitmap::probe(garbage, sizeof(garbage)));
+  EXPECT_FALSE(c.load(garbage, sizeof(garbage)));
+  EXPECT_FALSE(c.encode(esim::core::bitmap{}));
+
+  std::string out;
+  EXPECT_FALSE(c.save(out));
+}
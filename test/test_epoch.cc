@@ -0,0 +1,141 @@
+#include "core/epoch.h"
+#include "test_helper.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define TEST_NAME esim_epoch_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+namespace {
+
+struct tracked {
+  std::atomic<int> &alive;
+  int               value;
+
+  tracked(std::atomic<int> &counter, int x) : alive{counter}, value{x} { ++alive; }
+
+  ~tracked() { --alive; }
+};
+
+} // namespace
+
+TEST_F(TEST_NAME, reclaim_unpinned) {
+  std::atomic<int> alive{0};
+  esim::core::epoch_domain domain;
+  domain.retire(new tracked{alive, 1});
+  EXPECT_EQ(domain.retired(), 1U);
+
+  /// two epochs passed at least.
+  EXPECT_TRUE(domain.advance());
+  EXPECT_EQ(alive.load(), 1);
+  EXPECT_TRUE(domain.advance());
+  EXPECT_EQ(alive.load(), 0);
+  EXPECT_EQ(domain.retired(), 0U);
+  EXPECT_EQ(domain.current(), 2U);
+}
+
+TEST_F(TEST_NAME, pinned_blocks) {
+  std::atomic<int> alive{0};
+  esim::core::epoch_domain domain;
+  {
+    esim::core::epoch_participant reader{domain};
+    reader.enter();
+    EXPECT_TRUE(reader.entered());
+    domain.retire(new tracked{alive, 1});
+
+    /// the reader pinned the epoch retired in, never passes the next.
+    EXPECT_TRUE(domain.advance());
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_FALSE(domain.advance());
+    }
+    EXPECT_EQ(alive.load(), 1);
+
+    reader.leave();
+    EXPECT_TRUE(domain.advance());
+    EXPECT_EQ(alive.load(), 0);
+
+    /// entered again, the retired since are kept.
+    esim::core::epoch_guard guard{reader};
+    domain.retire(new tracked{alive, 2});
+    EXPECT_TRUE(domain.advance());
+    EXPECT_FALSE(domain.advance());
+    EXPECT_EQ(alive.load(), 1);
+  }
+  EXPECT_EQ(domain.retired(), 1U);
+}
+
+TEST_F(TEST_NAME, retire_again) {
+  std::atomic<int> alive{0};
+  int attempts = 0;
+  /// outlives the domain, invoked by its destruction.
+  std::function<void()> reclaim;
+  {
+    esim::core::epoch_domain domain;
+    auto target = new tracked{alive, 1};
+    reclaim = [&, target]() {
+      if (++attempts < 3) {
+        domain.retire(reclaim);
+      } else {
+        delete target;
+      }
+    };
+    domain.retire(reclaim);
+    for (int i = 0; i < 3; ++i) {
+      domain.advance();
+    }
+    EXPECT_EQ(alive.load(), 1);
+    EXPECT_EQ(attempts, 1);
+  }
+  /// the domain reclaims the left, retired again included.
+  EXPECT_EQ(attempts, 3);
+  EXPECT_EQ(alive.load(), 0);
+}
+
+TEST_F(TEST_NAME, concurrent) {
+  constexpr static int readers = 3, swaps = 2000;
+  std::atomic<int> alive{0};
+  esim::core::epoch_domain domain;
+  std::atomic<tracked *> shared{new tracked{alive, 0}};
+  std::atomic<bool> done{false};
+  std::atomic<int> corrupted{0};
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; ++r) {
+    threads.emplace_back([&]() {
+      esim::core::epoch_participant reader{domain};
+      while (!done.load()) {
+        esim::core::epoch_guard guard{reader};
+        auto target = shared.load(std::memory_order_acquire);
+        /// freed objects are poisoned before deleted.
+        if (target->value < 0) {
+          ++corrupted;
+        }
+      }
+    });
+  }
+  threads.emplace_back([&]() {
+    for (int i = 1; i <= swaps; ++i) {
+      auto old = shared.exchange(new tracked{alive, i}, std::memory_order_acq_rel);
+      domain.retire([old]() {
+        old->value = -1;
+        delete old;
+      });
+      domain.advance();
+    }
+    done.store(true);
+  });
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(corrupted.load(), 0);
+  while (0 != domain.retired()) {
+    domain.advance();
+  }
+  EXPECT_EQ(alive.load(), 1);
+  delete shared.load();
+}
@@ -0,0 +1,144 @@
+#include "core/executor.h"
+#include "test_helper.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define TEST_NAME esim_executor_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+TEST_F(TEST_NAME, deque_owner) {
+  esim::core::details::work_deque<int> deque{4};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(deque.push(i));
+  }
+  EXPECT_FALSE(deque.push(4));
+
+  int x = -1;
+  EXPECT_TRUE(deque.steal(x));
+  EXPECT_EQ(x, 0);
+  EXPECT_TRUE(deque.pop(x));
+  EXPECT_EQ(x, 3);
+  EXPECT_TRUE(deque.pop(x));
+  EXPECT_EQ(x, 2);
+  EXPECT_TRUE(deque.pop(x));
+  EXPECT_EQ(x, 1);
+  EXPECT_FALSE(deque.pop(x));
+  EXPECT_FALSE(deque.steal(x));
+}
+
+TEST_F(TEST_NAME, deque_steal) {
+  /// every item is taken exactly once, either by the owner or a thief.
+  constexpr static int count = 100000, thieves = 3;
+  esim::core::details::work_deque<int> deque{64};
+  std::vector<std::atomic<int>> taken(count);
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thieves; ++t) {
+    threads.emplace_back([&]() {
+      int x;
+      while (!done.load()) {
+        if (deque.steal(x)) {
+          ++taken[x];
+        }
+      }
+    });
+  }
+  int x;
+  for (int i = 0; i < count;) {
+    if (deque.push(i)) {
+      ++i;
+    } else if (deque.pop(x)) {
+      ++taken[x];
+    }
+  }
+  while (deque.pop(x)) {
+    ++taken[x];
+  }
+  done.store(true);
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(taken[i].load(), 1);
+  }
+}
+
+TEST_F(TEST_NAME, group_wait) {
+  esim::core::executor pool{4};
+  std::atomic<int> sum{0};
+  {
+    esim::core::task_group group{&pool};
+    for (int i = 1; i <= 1000; ++i) {
+      group.submit([&, i]() { sum += i; });
+    }
+    group.wait();
+    EXPECT_EQ(group.pending(), 0u);
+  }
+  EXPECT_EQ(sum.load(), 500500);
+}
+
+TEST_F(TEST_NAME, nested) {
+  /// the tasks submitted by a worker are stolen by the others.
+  esim::core::executor pool{4};
+  esim::core::task_group group{&pool};
+  std::atomic<int> count{0};
+  for (int i = 0; i < 8; ++i) {
+    group.submit([&]() {
+      for (int j = 0; j < 100; ++j) {
+        group.submit([&]() { ++count; });
+      }
+    });
+  }
+  group.wait();
+  EXPECT_EQ(count.load(), 800);
+}
+
+TEST_F(TEST_NAME, priority) {
+  esim::core::executor pool{1};
+  esim::core::task_group group{&pool};
+  std::atomic<bool> blocked{true};
+  std::mutex mutex;
+  std::vector<int> order;
+
+  /// the only worker is busy until all queued.
+  group.submit([&]() {
+    while (blocked.load()) {
+      std::this_thread::yield();
+    }
+  });
+  auto record = [&](int value) {
+    return [&, value]() {
+      std::lock_guard<std::mutex> lock{mutex};
+      order.emplace_back(value);
+    };
+  };
+  group.submit(record(2), esim::core::task_priority::low);
+  group.submit(record(1), esim::core::task_priority::normal);
+  group.submit(record(0), esim::core::task_priority::high);
+  blocked.store(false);
+  group.wait();
+
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+}
+
+TEST_F(TEST_NAME, shutdown) {
+  std::atomic<int> count{0};
+  esim::core::executor pool{2};
+  for (int i = 0; i < 100; ++i) {
+    pool.submit([&]() { ++count; });
+  }
+  pool.shutdown();
+  EXPECT_EQ(count.load(), 100);
+
+  /// run in place once shutdown.
+  pool.submit([&]() { ++count; });
+  EXPECT_EQ(count.load(), 101);
+}
@@ -1,5 +1,9 @@
 #include "core/fifo.h"
 #include "test_helper.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #define TEST_NAME esim_fifo_test
 
@@ -79,4 +83,117 @@ TEST_F(TEST_NAME, push_pop) {
   }
   EXPECT_TRUE(q.empty());
   EXPECT_EQ(actual, expect);
-}
\ No newline at end of file
+}
+TEST_F(TEST_NAME, try_pop_for) {
+  using namespace std::chrono;
+  esim::core::fifo<int> q;
+  int x = 0;
+
+  auto start = steady_clock::now();
+  EXPECT_FALSE(q.try_pop_for(x, milliseconds{20}));
+  EXPECT_GE(steady_clock::now() - start, milliseconds{20});
+
+  std::thread producer([&]() {
+    std::this_thread::sleep_for(milliseconds{10});
+    q.push(42);
+  });
+  EXPECT_TRUE(q.try_pop_for(x, seconds{5}));
+  EXPECT_EQ(x, 42);
+  producer.join();
+}
+
+TEST_F(TEST_NAME, blocking_handover) {
+  /// both ends park on a tiny queue, every item must get through in order.
+  esim::core::fifo<int> q{2};
+  constexpr static int count = 10000;
+  std::vector<int> actual;
+
+  std::thread consumer([&]() {
+    int x;
+    for (int i = 0; i < count; ++i) {
+      q.pop(x);
+      actual.emplace_back(x);
+    }
+  });
+  for (int i = 0; i < count; ++i) {
+    q.push(i);
+  }
+  consumer.join();
+
+  ASSERT_EQ(actual.size(), static_cast<size_t>(count));
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(actual[i], i);
+  }
+  EXPECT_TRUE(q.empty());
+}
+
+TEST_F(TEST_NAME, spsc_full) {
+  esim::core::fifo<int, esim::core::spsc> q{4};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(q.try_push(i));
+  }
+  EXPECT_FALSE(q.try_push(4));
+
+  int x = -1;
+  EXPECT_TRUE(q.try_pop(x));
+  EXPECT_EQ(x, 0);
+  EXPECT_TRUE(q.try_push(4));
+
+  for (int i = 1; i <= 4; ++i) {
+    EXPECT_TRUE(q.try_pop(x));
+    EXPECT_EQ(x, i);
+  }
+  EXPECT_FALSE(q.try_pop(x));
+  EXPECT_TRUE(q.empty());
+}
+
+TEST_F(TEST_NAME, spsc_destroy) {
+  auto value = std::make_shared<int>(10);
+  {
+    esim::core::fifo<std::shared_ptr<int>, esim::core::spsc> q{4};
+    q.push(value);
+    q.emplace(value);
+    EXPECT_EQ(value.use_count(), 3);
+  }
+  EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST_F(TEST_NAME, spsc_try_pop_for) {
+  using namespace std::chrono;
+  esim::core::fifo<int, esim::core::spsc> q;
+  int x = 0;
+
+  EXPECT_FALSE(q.try_pop_for(x, milliseconds{10}));
+
+  std::thread producer([&]() {
+    std::this_thread::sleep_for(milliseconds{10});
+    q.push(42);
+  });
+  EXPECT_TRUE(q.try_pop_for(x, seconds{5}));
+  EXPECT_EQ(x, 42);
+  producer.join();
+}
+
+TEST_F(TEST_NAME, spsc_blocking_handover) {
+  esim::core::fifo<int, esim::core::spsc> q{2};
+  constexpr static int count = 10000;
+  std::vector<int> actual;
+
+  std::thread consumer([&]() {
+    int x;
+    for (int i = 0; i < count; ++i) {
+      q.pop(x);
+      actual.emplace_back(x);
+    }
+  });
+  for (int i = 0; i < count; ++i) {
+    q.push(i);
+  }
+  consumer.join();
+
+  ASSERT_EQ(actual.size(), static_cast<size_t>(count));
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(actual[i], i);
+  }
+  EXPECT_TRUE(q.empty());
+}
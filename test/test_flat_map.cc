@@ -0,0 +1,120 @@
+#include "core/flat_map.h"
+#include "core/transform.h"
+#include "test_helper.h"
+#include <unordered_map>
+#include <unordered_set>
+
+#define TEST_NAME esim_flat_map_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+TEST_F(TEST_NAME, empty) {
+  esim::core::flat_map<int, int> m;
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.size(), 0u);
+  EXPECT_EQ(m.count(10), 0u);
+  EXPECT_TRUE(m.find(10) == m.end());
+  EXPECT_TRUE(m.begin() == m.end());
+  EXPECT_EQ(m.erase(10), 0u);
+}
+
+TEST_F(TEST_NAME, try_emplace) {
+  esim::core::flat_map<int, std::string> m;
+  auto [it, inserted] = m.try_emplace(10, "ten");
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(it->first, 10);
+  EXPECT_EQ(it->second, "ten");
+
+  auto [again, reinserted] = m.try_emplace(10, "TEN");
+  EXPECT_FALSE(reinserted);
+  EXPECT_EQ(again->second, "ten");
+  EXPECT_EQ(m.size(), 1u);
+}
+
+TEST_F(TEST_NAME, subscript) {
+  esim::core::flat_map<int, int> m;
+  m[3] += 2;
+  m[3] += 2;
+  EXPECT_EQ(m[3], 4);
+  EXPECT_EQ(m.size(), 1u);
+}
+
+TEST_F(TEST_NAME, move_only) {
+  esim::core::flat_map<int, esim::uptr<int>> m;
+  for (int i = 0; i < 100; ++i) {
+    m[i] = esim::make_uptr<int>(i);
+  }
+  auto moved = std::move(m);
+  EXPECT_TRUE(m.empty());
+  ASSERT_EQ(moved.size(), 100u);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(*moved[i], i);
+  }
+}
+
+TEST_F(TEST_NAME, erase_and_iterate) {
+  esim::core::flat_map<int, int> m;
+  for (int i = 0; i < 1000; ++i) {
+    m[i] = i * 2;
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    EXPECT_EQ(m.erase(i), 1u);
+  }
+  EXPECT_EQ(m.size(), 500u);
+
+  size_t count = 0;
+  for (auto &[key, value] : m) {
+    EXPECT_EQ(key % 2, 1);
+    EXPECT_EQ(value, key * 2);
+    ++count;
+  }
+  EXPECT_EQ(count, 500u);
+
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  EXPECT_TRUE(m.begin() == m.end());
+}
+
+TEST_F(TEST_NAME, random_against_unordered_map) {
+  auto rng = esim_test::gen_testcase();
+  esim::core::flat_map<uint32_t, uint32_t> m;
+  std::unordered_map<uint32_t, uint32_t> expect;
+
+  for (int i = 0; i < 100000; ++i) {
+    uint32_t key = esim_test::random<uint32_t>(rng, 0, 4096);
+    switch (esim_test::random<int>(rng, 0, 2)) {
+    case 0:
+      m[key] = static_cast<uint32_t>(i);
+      expect[key] = static_cast<uint32_t>(i);
+      break;
+    case 1:
+      ASSERT_EQ(m.erase(key), expect.erase(key));
+      break;
+    default:
+      ASSERT_EQ(m.count(key), expect.count(key));
+      if (expect.count(key)) {
+        ASSERT_EQ(m.find(key)->second, expect[key]);
+      }
+    }
+  }
+  EXPECT_EQ(m.size(), expect.size());
+}
+
+TEST_F(TEST_NAME, maptile_hash) {
+  std::unordered_set<size_t> hashes;
+  std::hash<esim::geo::maptile> hasher;
+  for (uint8_t lod = 0; lod < 10; ++lod) {
+    uint32_t n = 1u << lod;
+    for (uint32_t x = 0; x < n && x < 64; ++x) {
+      for (uint32_t y = 0; y < n && y < 64; ++y) {
+        EXPECT_TRUE(hashes.insert(hasher(esim::geo::maptile{lod, x, y})).second);
+      }
+    }
+  }
+
+  /// high bits of row are kept at deep zoom.
+  EXPECT_NE(hasher(esim::geo::maptile{30, 1u << 29, 7}),
+            hasher(esim::geo::maptile{30, 0, 7}));
+}
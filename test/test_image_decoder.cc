@@ -0,0 +1,146 @@
+#include "core/bitmap.h"
+#include "core/buffer_pool.h"
+#include "core/image_decoder.h"
+#include "test_helper.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#define TEST_NAME esim_image_decoder_test
+
+class TEST_NAME : public testing::Test {
+protected:
+  void SetUp() override {
+    std::ifstream f(std::string(ESIM_TEST_ASSETS) + "/img/test_base000.jpg", std::ios::binary);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    jpeg = ss.str();
+    ASSERT_FALSE(jpeg.empty());
+  }
+
+  std::string jpeg;
+};
+
+TEST_F(TEST_NAME, stb_probe) {
+  esim::core::image_info info{};
+  EXPECT_TRUE(esim::core::stb_image_decoder::get()->probe(jpeg.data(), jpeg.size(), info));
+  EXPECT_GT(info.width, 0);
+  EXPECT_GT(info.height, 0);
+  EXPECT_EQ(info.channel, 3);
+}
+
+TEST_F(TEST_NAME, stb_decode_adopt) {
+  esim::core::bitmap b;
+  EXPECT_TRUE(esim::core::stb_image_decoder::get()->decode(jpeg.data(), jpeg.size(), b, {}));
+  EXPECT_NE(b.buffer(), nullptr);
+  EXPECT_EQ(b.size(), static_cast<size_t>(b.width()) * b.height() * b.channel());
+}
+
+TEST_F(TEST_NAME, invalid_data) {
+  const char garbage[] = "not an image";
+  esim::core::bitmap b;
+  EXPECT_FALSE(b.load(garbage, sizeof(garbage)));
+  EXPECT_EQ(b.buffer(), nullptr);
+}
+
+TEST_F(TEST_NAME, truncated_data) {
+  esim::core::bitmap b;
+  EXPECT_FALSE(b.load(jpeg.data(), 16));
+}
+
+TEST_F(TEST_NAME, release) {
+  esim::core::bitmap b;
+  ASSERT_TRUE(b.load(jpeg.data(), jpeg.size()));
+  auto buffer = b.release();
+  EXPECT_NE(buffer, nullptr);
+  EXPECT_EQ(b.buffer(), nullptr);
+  EXPECT_EQ(b.size(), 0u);
+}
+
+TEST_F(TEST_NAME, raw_roundtrip) {
+  esim::core::bitmap a, b;
+  ASSERT_TRUE(a.load(jpeg.data(), jpeg.size()));
+
+  std::string raw;
+  ASSERT_TRUE(esim::core::encode_raw_image(a, raw));
+  EXPECT_EQ(esim::core::select_image_decoder(raw.data(), raw.size()),
+            esim::core::raw_image_decoder::get());
+  ASSERT_TRUE(b.load(raw.data(), raw.size()));
+  EXPECT_EQ(a.width(), b.width());
+  EXPECT_EQ(a.height(), b.height());
+  EXPECT_EQ(a.channel(), b.channel());
+  ASSERT_EQ(a.size(), b.size());
+  EXPECT_EQ(0, std::memcmp(a.buffer(), b.buffer(), a.size()));
+
+  /// truncated raw data is rejected.
+  EXPECT_FALSE(b.load(raw.data(), raw.size() - 1));
+}
+
+#if defined(ESIM_ENABLE_LIBJPEG)
+
+TEST_F(TEST_NAME, select_jpeg) {
+  EXPECT_EQ(esim::core::select_image_decoder(jpeg.data(), jpeg.size()),
+            esim::core::jpeg_image_decoder::get());
+}
+
+TEST_F(TEST_NAME, jpeg_matches_stb) {
+  esim::core::bitmap a, b;
+  ASSERT_TRUE(esim::core::stb_image_decoder::get()->decode(jpeg.data(), jpeg.size(), a, {}));
+  ASSERT_TRUE(esim::core::jpeg_image_decoder::get()->decode(jpeg.data(), jpeg.size(), b, {}));
+  ASSERT_EQ(a.width(), b.width());
+  ASSERT_EQ(a.height(), b.height());
+  ASSERT_EQ(a.size(), b.size());
+
+  /// IDCT implementations differ slightly.
+  size_t off = 0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    int d = static_cast<unsigned char>(a.buffer()[i]) - static_cast<unsigned char>(b.buffer()[i]);
+    off += (d > 4 || d < -4);
+  }
+  EXPECT_LT(off, a.size() / 100);
+}
+
+#endif
+
+TEST_F(TEST_NAME, buffer_pool_recycle) {
+  esim::core::buffer_pool pool(1024, 2);
+  auto a = pool.acquire(1000);
+  auto pa = a.get();
+  EXPECT_EQ(pool.available(), 0u);
+  a.reset();
+  EXPECT_EQ(pool.available(), 1u);
+  auto b = pool.acquire(512);
+  EXPECT_EQ(b.get(), pa);
+  EXPECT_EQ(pool.available(), 0u);
+}
+
+TEST_F(TEST_NAME, buffer_pool_capacity) {
+  esim::core::buffer_pool pool(64, 2);
+  {
+    auto a = pool.acquire(64), b = pool.acquire(64), c = pool.acquire(64);
+  }
+  EXPECT_EQ(pool.available(), 2u);
+
+  /// oversized buffers are not recycled.
+  pool.acquire(65).reset();
+  EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST_F(TEST_NAME, buffer_pool_outlived) {
+  esim::core::bitmap::buffer_type buffer;
+  {
+    esim::core::buffer_pool pool(64, 2);
+    buffer = pool.acquire(64);
+  }
+  std::memset(buffer.get(), 0, 64);
+  buffer.reset();
+}
+
+TEST_F(TEST_NAME, load_with_pool) {
+  esim::core::buffer_pool pool(256 * 256 * 4, 4);
+  {
+    esim::core::bitmap b;
+    ASSERT_TRUE(b.load(jpeg.data(), jpeg.size(), pool.allocator()));
+  }
+  EXPECT_EQ(pool.available(), 1u);
+}
@@ -0,0 +1,190 @@
+#include "core/bitmap.h"
+#include "core/image_ops.h"
+#include "test_helper.h"
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#define TEST_NAME esim_image_ops_test
+
+class TEST_NAME : public testing::Test {
+protected:
+  static std::vector<uint8_t> noise(size_t size, uint32_t seed) noexcept {
+    std::mt19937 rng{seed};
+    std::vector<uint8_t> pixels(size);
+    for (auto &p : pixels) {
+      p = static_cast<uint8_t>(rng() & 0xFF);
+    }
+
+    return pixels;
+  }
+
+  static void adopt(esim::core::bitmap &b, int width, int height, int channel,
+                    const std::vector<uint8_t> &pixels) noexcept {
+    auto buffer = esim::core::bitmap::allocate(pixels.size());
+    std::copy(pixels.begin(), pixels.end(), buffer.get());
+    b.adopt(width, height, channel, std::move(buffer));
+  }
+};
+
+TEST_F(TEST_NAME, expand_rgb_to_rgba) {
+  /// covers both the vectorized body and the scalar tail.
+  const size_t count = 16 * 7 + 5;
+  auto rgb = noise(count * 3, 1);
+  std::vector<uint8_t> rgba(count * 4);
+  esim::core::image_ops::expand_rgb_to_rgba(rgb.data(), rgba.data(), count, 200);
+
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(rgba[i * 4 + 0], rgb[i * 3 + 0]);
+    ASSERT_EQ(rgba[i * 4 + 1], rgb[i * 3 + 1]);
+    ASSERT_EQ(rgba[i * 4 + 2], rgb[i * 3 + 2]);
+    ASSERT_EQ(rgba[i * 4 + 3], 200);
+  }
+}
+
+TEST_F(TEST_NAME, downsample_box) {
+  for (auto [w, h, channel] : {std::make_tuple(64, 32, 4), std::make_tuple(37, 21, 4),
+                               std::make_tuple(15, 9, 3), std::make_tuple(1, 7, 4)}) {
+    auto src = noise(static_cast<size_t>(w) * h * channel, w * h);
+    int dw = std::max(1, w / 2), dh = std::max(1, h / 2);
+    std::vector<uint8_t> dst(static_cast<size_t>(dw) * dh * channel);
+    esim::core::image_ops::downsample_box(src.data(), w, h, channel, dst.data());
+
+    for (int y = 0; y < dh; ++y) {
+      for (int x = 0; x < dw; ++x) {
+        int x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+        int y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+        for (int c = 0; c < channel; ++c) {
+          int sum = src[(y0 * w + x0) * channel + c] + src[(y0 * w + x1) * channel + c] +
+                    src[(y1 * w + x0) * channel + c] + src[(y1 * w + x1) * channel + c];
+          ASSERT_EQ(dst[(y * dw + x) * channel + c], (sum + 2) / 4) << w << "x" << h;
+        }
+      }
+    }
+  }
+}
+
+TEST_F(TEST_NAME, downsample_srgb) {
+  /// black and white average to the srgb of half linear, alpha stays linear.
+  const std::vector<uint8_t> src = {0, 0, 0, 0, 255, 255, 255, 255,
+                                    0, 0, 0, 0, 255, 255, 255, 255};
+  uint8_t box[4], kaiser[4];
+  esim::core::image_ops::downsample_box(src.data(), 2, 2, 4, box, true);
+  EXPECT_EQ(box[0], 188);
+  EXPECT_EQ(box[2], 188);
+  EXPECT_EQ(box[3], 128);
+
+  esim::core::image_ops::downsample_box(src.data(), 2, 2, 4, box, false);
+  EXPECT_EQ(box[0], 128);
+
+  esim::core::image_ops::downsample_kaiser(src.data(), 2, 2, 4, kaiser, true);
+  EXPECT_NEAR(kaiser[0], 188, 1);
+  EXPECT_NEAR(kaiser[3], 128, 1);
+}
+
+TEST_F(TEST_NAME, downsample_kaiser_solid) {
+  std::vector<uint8_t> src(32 * 16 * 3);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i % 3 == 0 ? 40 : (i % 3 == 1 ? 120 : 250));
+  }
+  std::vector<uint8_t> dst(16 * 8 * 3);
+  esim::core::image_ops::downsample_kaiser(src.data(), 32, 16, 3, dst.data(), true);
+
+  for (size_t i = 0; i < dst.size(); ++i) {
+    ASSERT_NEAR(dst[i], src[i % 3], 1);
+  }
+}
+
+TEST_F(TEST_NAME, flip_vertical) {
+  auto pixels = noise(7 * 5 * 3, 5);
+  auto flipped = pixels;
+  esim::core::image_ops::flip_vertical(flipped.data(), 7, 5, 3);
+  EXPECT_TRUE(std::equal(flipped.begin(), flipped.begin() + 21, pixels.end() - 21));
+  EXPECT_TRUE(std::equal(flipped.begin() + 42, flipped.begin() + 63, pixels.begin() + 42));
+
+  esim::core::image_ops::flip_vertical(flipped.data(), 7, 5, 3);
+  EXPECT_EQ(flipped, pixels);
+}
+
+TEST_F(TEST_NAME, blend) {
+  using esim::core::blend_mode;
+  const std::vector<uint8_t> below = {100, 200, 50};
+  const std::vector<uint8_t> layer = {200, 100, 255, 255};
+  auto blended = [&](blend_mode mode, float opacity, int channel) {
+    auto pixels = below;
+    esim::core::image_ops::blend(pixels.data(), layer.data(), channel, 1, mode, opacity);
+
+    return pixels;
+  };
+
+  EXPECT_EQ(blended(blend_mode::normal, 1.0f, 4), (std::vector<uint8_t>{200, 100, 255}));
+  EXPECT_EQ(blended(blend_mode::multiply, 1.0f, 4), (std::vector<uint8_t>{78, 78, 50}));
+  EXPECT_EQ(blended(blend_mode::screen, 1.0f, 4), (std::vector<uint8_t>{222, 222, 255}));
+  EXPECT_EQ(blended(blend_mode::add, 1.0f, 4), (std::vector<uint8_t>{255, 255, 255}));
+  EXPECT_EQ(blended(blend_mode::normal, 0.0f, 4), below);
+
+  /// half opacity, and gray replicated.
+  auto half = blended(blend_mode::normal, 0.5f, 3);
+  EXPECT_NEAR(half[0], 150, 1);
+  EXPECT_NEAR(half[2], 152, 1);
+  auto gray = blended(blend_mode::normal, 1.0f, 1);
+  EXPECT_EQ(gray, (std::vector<uint8_t>{200, 200, 200}));
+
+  /// transparent layer keeps the pixels below.
+  const std::vector<uint8_t> clear = {0, 0, 0, 0};
+  auto pixels = below;
+  esim::core::image_ops::blend(pixels.data(), clear.data(), 4, 1, blend_mode::normal);
+  EXPECT_EQ(pixels, below);
+}
+
+TEST_F(TEST_NAME, resample_region) {
+  /// horizontal gradient, 4 pixels of 0, 85, 170, 255.
+  std::vector<uint8_t> src(4 * 2);
+  for (int y = 0; y < 2; ++y) {
+    for (int x = 0; x < 4; ++x) {
+      src[y * 4 + x] = static_cast<uint8_t>(x * 85);
+    }
+  }
+
+  /// the identity.
+  std::vector<uint8_t> dst(4 * 2);
+  esim::core::image_ops::resample_region(src.data(), 4, 2, 1, 0.0f, 0.0f, 4.0f, 2.0f, dst.data(), 4, 2);
+  EXPECT_EQ(dst, src);
+
+  /// the right half magnified, interpolated between the pixels.
+  std::vector<uint8_t> half(4);
+  esim::core::image_ops::resample_region(src.data(), 4, 2, 1, 2.0f, 0.0f, 2.0f, 1.0f, half.data(), 4, 1);
+  EXPECT_NEAR(half[0], 149, 1);
+  EXPECT_NEAR(half[1], 191, 1);
+  EXPECT_NEAR(half[2], 234, 1);
+  EXPECT_EQ(half[3], 255);
+}
+
+TEST_F(TEST_NAME, generate_mip_chain) {
+  esim::core::bitmap image;
+  adopt(image, 256, 128, 3, noise(256 * 128 * 3, 7));
+  esim::core::mip_chain chain;
+  ASSERT_TRUE(esim::core::image_ops::generate_mip_chain(image, chain, esim::core::mip_filter::box, true));
+
+  ASSERT_EQ(chain.channel, 4);
+  ASSERT_EQ(chain.levels.size(), 9u);
+  EXPECT_EQ(chain.levels[1].width, 128);
+  EXPECT_EQ(chain.levels[1].height, 64);
+  EXPECT_EQ(chain.levels[7].height, 1);
+  EXPECT_EQ(chain.levels[8].width, 1);
+  EXPECT_EQ(chain.data.size(), chain.levels[8].offset + 4);
+  EXPECT_EQ(chain.data[3], 255);
+
+  esim::core::bitmap gray;
+  auto pixels = noise(16, 9);
+  adopt(gray, 4, 4, 1, pixels);
+  ASSERT_TRUE(esim::core::image_ops::generate_mip_chain(gray, chain));
+  ASSERT_EQ(chain.levels.size(), 3u);
+  EXPECT_EQ(chain.data[4 * 5 + 0], pixels[5]);
+  EXPECT_EQ(chain.data[4 * 5 + 2], pixels[5]);
+  EXPECT_EQ(chain.data[4 * 5 + 3], 255);
+
+  esim::core::bitmap empty;
+  EXPECT_FALSE(esim::core::image_ops::generate_mip_chain(empty, chain));
+}
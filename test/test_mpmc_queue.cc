@@ -0,0 +1,195 @@
+#include "core/mpmc_queue.h"
+#include "test_helper.h"
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define TEST_NAME esim_mpmc_queue_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+TEST_F(TEST_NAME, empty) {
+  esim::core::mpmc_queue<int> q;
+  EXPECT_TRUE(q.empty());
+
+  int x = 0;
+  EXPECT_FALSE(q.try_pop(x));
+}
+
+TEST_F(TEST_NAME, push_pop) {
+  auto rng = esim_test::gen_testcase();
+  std::vector<int> expect, actual;
+  esim::core::mpmc_queue<int> q;
+
+  for (size_t i = 0; i < 100; ++i) {
+    int x = esim_test::random(rng, 0, 2000);
+    q.push(x);
+    expect.emplace_back(x);
+  }
+
+  int x;
+  while (q.try_pop(x)) {
+    actual.emplace_back(x);
+  }
+  EXPECT_TRUE(q.empty());
+  EXPECT_EQ(actual, expect);
+}
+
+TEST_F(TEST_NAME, full) {
+  esim::core::mpmc_queue<int> q{4};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(q.try_push(i));
+  }
+  EXPECT_FALSE(q.try_push(4));
+
+  int x = -1;
+  q.pop(x);
+  EXPECT_EQ(x, 0);
+  EXPECT_TRUE(q.try_emplace(4));
+
+  /// the slots are recycled over laps.
+  for (int i = 1; i <= 4; ++i) {
+    EXPECT_TRUE(q.try_pop(x));
+    EXPECT_EQ(x, i);
+  }
+  EXPECT_TRUE(q.empty());
+}
+
+TEST_F(TEST_NAME, capacity_one) {
+  /// rounded up to 2 slots, a single one never tells full from empty.
+  for (uint32_t size : {0U, 1U}) {
+    esim::core::mpmc_queue<int> q{size};
+    EXPECT_TRUE(q.try_push(1));
+    EXPECT_TRUE(q.try_push(2));
+    EXPECT_FALSE(q.try_push(3));
+
+    int x = -1;
+    EXPECT_TRUE(q.try_pop(x));
+    EXPECT_EQ(x, 1);
+    EXPECT_TRUE(q.try_pop(x));
+    EXPECT_EQ(x, 2);
+    EXPECT_FALSE(q.try_pop(x));
+  }
+}
+
+TEST_F(TEST_NAME, blocking) {
+  /// the producers and consumers park on a queue mostly full or empty.
+  constexpr static int producers = 3, consumers = 3, per_producer = 5000;
+  esim::core::mpmc_queue<int> q{2};
+  std::atomic<long long> sum{0};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (int i = 0; i < per_producer; ++i) {
+        q.push(p * per_producer + i);
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < per_producer; ++i) {
+        int x;
+        q.pop(x);
+        sum += x;
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  long long total = static_cast<long long>(producers) * per_producer;
+  EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+  EXPECT_TRUE(q.empty());
+}
+
+TEST_F(TEST_NAME, batch) {
+  esim::core::mpmc_queue<int> q{8};
+  std::vector<int> in(12);
+  std::iota(in.begin(), in.end(), 0);
+
+  /// only the leading ones fit.
+  EXPECT_EQ(q.try_push_n(in.begin(), in.size()), 8u);
+  EXPECT_EQ(q.try_push_n(in.begin() + 8, 4), 0u);
+
+  std::vector<int> out(5);
+  EXPECT_EQ(q.try_pop_n(out.begin(), out.size()), 5u);
+  EXPECT_EQ(out, (std::vector<int>{0, 1, 2, 3, 4}));
+  EXPECT_EQ(q.try_push_n(in.begin() + 8, 4), 4u);
+
+  out.assign(16, -1);
+  EXPECT_EQ(q.try_pop_n(out.begin(), out.size()), 7u);
+  EXPECT_EQ(out[0], 5);
+  EXPECT_EQ(out[6], 11);
+  EXPECT_EQ(q.try_pop_n(out.begin(), out.size()), 0u);
+}
+
+TEST_F(TEST_NAME, non_trivial) {
+  auto counter = std::make_shared<int>(0);
+  {
+    esim::core::mpmc_queue<std::shared_ptr<int>> q{4};
+    q.push(counter);
+    q.emplace(counter);
+    std::shared_ptr<int> x;
+    q.pop(x);
+    EXPECT_EQ(counter.use_count(), 3);
+  }
+  /// the remaining items are destroyed with the queue.
+  EXPECT_EQ(counter.use_count(), 1);
+
+  esim::core::mpmc_queue<std::string> q{2};
+  q.push(std::string(64, 'x'));
+  std::string s;
+  EXPECT_TRUE(q.try_pop(s));
+  EXPECT_EQ(s.size(), 64u);
+}
+
+TEST_F(TEST_NAME, concurrent) {
+  constexpr static int producers = 4, consumers = 4, per_producer = 20000;
+  esim::core::mpmc_queue<int> q{64};
+  std::atomic<long long> sum{0};
+  std::atomic<int> popped{0};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (int i = 0; i < per_producer; ++i) {
+        int value = p * per_producer + i;
+        if (0 == (i & 1)) {
+          q.push(value);
+        } else {
+          while (!q.try_push(value)) {
+            std::this_thread::yield();
+          }
+        }
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&]() {
+      int batch[8];
+      while (popped.load() < producers * per_producer) {
+        size_t n = q.try_pop_n(batch, 8);
+        for (size_t i = 0; i < n; ++i) {
+          sum += batch[i];
+        }
+        popped += static_cast<int>(n);
+        if (0 == n) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  long long total = static_cast<long long>(producers) * per_producer;
+  EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+  EXPECT_TRUE(q.empty());
+}
@@ -0,0 +1,155 @@
+#include "core/object_pool.h"
+#include "test_helper.h"
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#define TEST_NAME esim_object_pool_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+namespace {
+
+struct tracked {
+  std::atomic<int> &alive;
+  std::vector<int>  values;
+
+  tracked(std::atomic<int> &counter, int x) : alive{counter}, values(4, x) { ++alive; }
+
+  ~tracked() { --alive; }
+};
+
+} // namespace
+
+TEST_F(TEST_NAME, create_destroy) {
+  std::atomic<int> alive{0};
+  esim::core::object_pool<tracked> pool{8, 4};
+
+  auto target = pool.create(alive, 10);
+  EXPECT_EQ(alive.load(), 1);
+  EXPECT_EQ(target->values[3], 10);
+  EXPECT_EQ(pool.capacity(), 8U);
+
+  pool.destroy(target);
+  EXPECT_EQ(alive.load(), 0);
+
+  /// the slot freed latest is reused first.
+  auto again = pool.create(alive, 20);
+  EXPECT_EQ(again, target);
+  pool.destroy(again);
+  pool.destroy(nullptr);
+}
+
+TEST_F(TEST_NAME, make) {
+  std::atomic<int> alive{0};
+  esim::core::object_pool<tracked> pool;
+  {
+    auto target = pool.make(alive, 1);
+    esim::core::pool_ptr<tracked> moved = std::move(target);
+    EXPECT_EQ(alive.load(), 1);
+  }
+  EXPECT_EQ(alive.load(), 0);
+}
+
+TEST_F(TEST_NAME, contiguous) {
+  /// siblings created together come from the same slab, adjacent.
+  std::atomic<int> alive{0};
+  esim::core::object_pool<tracked> pool{16, 16};
+  std::vector<tracked *> siblings;
+  for (int i = 0; i < 4; ++i) {
+    siblings.emplace_back(pool.create(alive, i));
+  }
+  for (size_t i = 1; i < siblings.size(); ++i) {
+    auto distance = reinterpret_cast<char *>(siblings[i]) - reinterpret_cast<char *>(siblings[i - 1]);
+    EXPECT_EQ(std::abs(distance), static_cast<std::ptrdiff_t>(sizeof(tracked)));
+  }
+  for (auto target : siblings) {
+    pool.destroy(target);
+  }
+}
+
+TEST_F(TEST_NAME, churn_reuses) {
+  std::atomic<int> alive{0};
+  esim::core::object_pool<tracked> pool{8, 4};
+  std::vector<tracked *> created;
+  for (int round = 0; round < 50; ++round) {
+    for (int i = 0; i < 20; ++i) {
+      created.emplace_back(pool.create(alive, i));
+    }
+    for (auto target : created) {
+      pool.destroy(target);
+    }
+    created.clear();
+  }
+  EXPECT_EQ(alive.load(), 0);
+  /// bounded by the peak, the slabs are never carved again.
+  EXPECT_LE(pool.capacity(), 32U);
+}
+
+TEST_F(TEST_NAME, cross_thread) {
+  /// created by the workers, destroyed by another thread, then reused.
+  constexpr static int producers = 3, per_producer = 5000;
+  std::atomic<int> alive{0};
+  esim::core::object_pool<tracked> pool{32, 16};
+  esim::core::unbounded_queue<tracked *> handoff;
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (int i = 0; i < per_producer; ++i) {
+        handoff.push(pool.create(alive, p));
+      }
+    });
+  }
+  std::atomic<int> corrupted{0};
+  std::thread consumer([&]() {
+    for (int i = 0; i < producers * per_producer; ++i) {
+      tracked *target = nullptr;
+      handoff.pop(target);
+      if (target->values.size() != 4 || target->values[0] >= producers) {
+        ++corrupted;
+      }
+      pool.destroy(target);
+    }
+  });
+  for (auto &t : threads) {
+    t.join();
+  }
+  consumer.join();
+
+  EXPECT_EQ(corrupted.load(), 0);
+  EXPECT_EQ(alive.load(), 0);
+
+  /// the slots in depot are reused by another thread, except those
+  /// cached by the threads exited.
+  auto capacity = pool.capacity();
+  std::thread reuser([&]() {
+    std::vector<tracked *> created;
+    for (size_t i = 0; i + (producers + 1) * 16 < capacity; ++i) {
+      created.emplace_back(pool.create(alive, 0));
+    }
+    for (auto target : created) {
+      pool.destroy(target);
+    }
+  });
+  reuser.join();
+  EXPECT_EQ(pool.capacity(), capacity);
+}
+
+TEST_F(TEST_NAME, outlives_threads) {
+  /// destroyed after the thread cached its slots exited, as the static pools.
+  std::atomic<int> alive{0};
+  auto pool = esim::make_uptr<esim::core::object_pool<tracked>>(8, 4);
+  std::thread([&]() { pool->destroy(pool->create(alive, 1)); }).join();
+  pool.reset();
+
+  /// the caches of pools destroyed are dropped, never matched again.
+  for (int i = 0; i < 16; ++i) {
+    esim::core::object_pool<tracked> scoped{4, 4};
+    scoped.destroy(scoped.create(alive, i));
+  }
+  EXPECT_EQ(alive.load(), 0);
+}
@@ -0,0 +1,68 @@
+#include "core/parker.h"
+#include "test_helper.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define TEST_NAME esim_parker_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+TEST_F(TEST_NAME, ready) {
+  esim::core::parker p;
+  p.park_until([]() { return true; });
+  EXPECT_TRUE(p.park_until_for([]() { return true; }, std::chrono::milliseconds{0}));
+}
+
+TEST_F(TEST_NAME, timeout) {
+  using namespace std::chrono;
+  esim::core::parker p;
+  auto start = steady_clock::now();
+  EXPECT_FALSE(p.park_until_for([]() { return false; }, milliseconds{20}));
+  EXPECT_GE(steady_clock::now() - start, milliseconds{20});
+}
+
+TEST_F(TEST_NAME, notify_all) {
+  esim::core::parker p;
+  std::atomic<bool> ready{false};
+  std::atomic<int>  woken{0};
+
+  std::vector<std::thread> waiters;
+  for (int i = 0; i < 4; ++i) {
+    waiters.emplace_back([&]() {
+      p.park_until([&]() { return ready.load(std::memory_order_acquire); });
+      ++woken;
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  ready.store(true, std::memory_order_release);
+  p.notify_all();
+  for (auto &waiter : waiters) {
+    waiter.join();
+  }
+  EXPECT_EQ(woken.load(), 4);
+}
+
+TEST_F(TEST_NAME, ping_pong) {
+  /// every handover parks the other side, none of the notifies gets lost.
+  esim::core::parker p;
+  std::atomic<int> turn{0};
+  constexpr static int rounds = 20000;
+
+  std::thread peer([&]() {
+    for (int i = 0; i < rounds; ++i) {
+      p.park_until([&]() { return turn.load(std::memory_order_acquire) == 2 * i + 1; });
+      turn.store(2 * i + 2, std::memory_order_release);
+      p.notify_all();
+    }
+  });
+  for (int i = 0; i < rounds; ++i) {
+    turn.store(2 * i + 1, std::memory_order_release);
+    p.notify_all();
+    p.park_until([&]() { return turn.load(std::memory_order_acquire) == 2 * i + 2; });
+  }
+  peer.join();
+  EXPECT_EQ(turn.load(), 2 * rounds);
+}
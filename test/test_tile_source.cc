@@ -0,0 +1,144 @@
+#include "details/tile_source.h"
+#include "test_helper.h"
+#include "tile_source_helper.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#define TEST_NAME esim_tile_source_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+namespace {
+
+struct expansion {
+  esim::geo::maptile tile;
+  std::string        expect;
+};
+
+using esim_test::scripted_tile_source;
+
+std::filesystem::path cache_root(std::string_view name) noexcept {
+  std::error_code ec;
+  auto root = std::filesystem::temp_directory_path(ec) / "esim_test_cache" / name;
+  std::filesystem::remove_all(root, ec);
+
+  return root;
+}
+
+void expect_expansions(std::string_view pattern, const std::vector<expansion> &cases) noexcept {
+  esim::tile_template url{pattern};
+  std::string out;
+  for (auto &c : cases) {
+    EXPECT_EQ(url.expand(c.tile), c.expect) << "lod " << int(c.tile.lod) << " x " << c.tile.x << " y " << c.tile.y;
+    /// the buffer reused is cleared first.
+    EXPECT_EQ(url.expand(c.tile, out), c.expect);
+  }
+}
+
+} // namespace
+
+TEST_F(TEST_NAME, xyz) {
+  /// x is the row, north to south, y the column, west to east.
+  expect_expansions("/tile/{z}/{x}/{y}", {
+      {{0, 0, 0}, "/tile/0/0/0"},
+      {{3, 5, 2}, "/tile/3/5/2"},
+      {{18, 214000, 93000}, "/tile/18/214000/93000"},
+  });
+}
+
+TEST_F(TEST_NAME, quadkey) {
+  /// the digit is the column bit plus twice the row bit, as Bing's
+  /// tileX (column) and tileY (row).
+  expect_expansions("{q}", {
+      {{0, 0, 0}, ""},
+      {{1, 0, 0}, "0"},
+      {{1, 0, 1}, "1"},
+      {{1, 1, 0}, "2"},
+      {{1, 1, 1}, "3"},
+      /// Bing tileX 3, tileY 5 at level 3.
+      {{3, 5, 3}, "213"},
+      /// Bing tileX 35210, tileY 21493 at level 16.
+      {{16, 21493, 35210}, "1202102332221212"},
+  });
+}
+
+TEST_F(TEST_NAME, tms_row) {
+  /// the rows counted from the south.
+  expect_expansions("{z}/{y}/{-x}", {
+      {{0, 0, 0}, "0/0/0"},
+      {{1, 0, 1}, "1/1/1"},
+      {{1, 1, 0}, "1/0/0"},
+      {{3, 5, 2}, "3/2/2"},
+      {{10, 0, 7}, "10/7/1023"},
+      {{10, 1023, 7}, "10/7/0"},
+  });
+}
+
+TEST_F(TEST_NAME, literals) {
+  /// the text without placeholders and the unknown ones are kept as-is.
+  expect_expansions("https://host/static.png", {
+      {{4, 1, 2}, "https://host/static.png"},
+  });
+  expect_expansions("/{s}/{z}/{X}{x}{}/{y", {
+      {{2, 3, 1}, "/{s}/2/{X}3{}/{y"},
+  });
+  expect_expansions("", {
+      {{2, 3, 1}, ""},
+  });
+}
+
+TEST_F(TEST_NAME, cache_no_data) {
+  auto root = cache_root("no_data");
+  auto upstream = esim::make_uptr<scripted_tile_source>(esim::TILE_NO_DATA);
+  auto missing = upstream.get();
+  esim::cache_tile_source cache{root.string(), std::move(upstream)};
+  esim::geo::maptile tile{5, 11, 20};
+  std::string data;
+
+  /// recorded as an empty file even if not written back, never fetched again.
+  EXPECT_FALSE(cache.contains(tile));
+  EXPECT_EQ(cache.fetch(tile, data), esim::TILE_NO_DATA);
+  EXPECT_TRUE(cache.contains(tile));
+  EXPECT_EQ(std::filesystem::file_size(root / "5" / "11" / "20.tile"), 0u);
+  EXPECT_EQ(cache.fetch(tile, data), esim::TILE_NO_DATA);
+  EXPECT_EQ(missing->fetches, 1u);
+
+  /// a fresh cache over the same directory remembers it.
+  upstream = esim::make_uptr<scripted_tile_source>(esim::TILE_SUCCESS);
+  auto present = upstream.get();
+  esim::cache_tile_source reopened{root.string(), std::move(upstream)};
+  EXPECT_EQ(reopened.fetch(tile, data), esim::TILE_NO_DATA);
+  EXPECT_EQ(present->fetches, 0u);
+  std::error_code ec;
+  std::filesystem::remove_all(root, ec);
+}
+
+TEST_F(TEST_NAME, cache_write_back) {
+  auto root = cache_root("write_back");
+  esim::geo::maptile tile{5, 11, 20};
+  std::string data;
+
+  /// the failures are never recorded, those with data only if written back.
+  esim::cache_tile_source failing{root.string(), esim::make_uptr<scripted_tile_source>(esim::TILE_FAILURE)};
+  EXPECT_EQ(failing.fetch(tile, data), esim::TILE_FAILURE);
+  EXPECT_FALSE(failing.contains(tile));
+
+  esim::cache_tile_source passing{root.string(), esim::make_uptr<scripted_tile_source>(esim::TILE_SUCCESS)};
+  EXPECT_EQ(passing.fetch(tile, data), esim::TILE_SUCCESS);
+  EXPECT_FALSE(passing.contains(tile));
+
+  auto upstream = esim::make_uptr<scripted_tile_source>(esim::TILE_SUCCESS);
+  auto written = upstream.get();
+  esim::cache_tile_source writing{root.string(), std::move(upstream), true};
+  EXPECT_EQ(writing.fetch(tile, data), esim::TILE_SUCCESS);
+  EXPECT_TRUE(writing.contains(tile));
+  data.clear();
+  EXPECT_EQ(writing.fetch(tile, data), esim::TILE_SUCCESS);
+  EXPECT_EQ(data, "encoded");
+  EXPECT_EQ(written->fetches, 1u);
+  std::error_code ec;
+  std::filesystem::remove_all(root, ec);
+}
@@ -37,4 +37,23 @@ TEST_P(TEST_NAME, ecef_long_lat_repeatly) {
     EXPECT_NEAR(pos.z, expect.z, 0.01);
 }
 
+TEST_P(TEST_NAME, geo_maptile_repeatly) {
+  auto rng = get_testcase(GetParam());
+  uint8_t lod = static_cast<uint8_t>(esim_test::random<int>(rng, 0, 20));
+  uint32_t last = (1u << lod) - 1;
+  glm::dvec3 corner{
+      static_cast<double>(esim_test::random<uint32_t>(rng, 0, last)),
+      static_cast<double>(esim_test::random<uint32_t>(rng, 0, last)),
+      static_cast<double>(lod)},
+      geo;
+
+  /// probe slightly inside the north-west corner of the tile.
+  esim::geo::maptile_to_geo(corner + glm::dvec3{0.5, 0.5, 0.0}, geo);
+  auto tile = esim::geo::geo_to_maptile(glm::dvec2{geo.x, geo.y}, lod);
+
+  EXPECT_EQ(tile.lod, lod);
+  EXPECT_EQ(tile.x, static_cast<uint32_t>(corner.x));
+  EXPECT_EQ(tile.y, static_cast<uint32_t>(corner.y));
+}
+
 INSTANTIATE_TEST_SUITE_P(esim, TEST_NAME, testing::Values(0, 0, 0, 0));
@@ -0,0 +1,89 @@
+#include "core/triple_buffer.h"
+#include "test_helper.h"
+#include <chrono>
+#include <thread>
+
+#define TEST_NAME esim_triple_buffer_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+TEST_F(TEST_NAME, initial) {
+  esim::core::triple_buffer<int> buffer{7};
+  EXPECT_FALSE(buffer.dirty());
+  EXPECT_FALSE(buffer.acquire());
+  EXPECT_EQ(buffer.read_buffer(), 7);
+}
+
+TEST_F(TEST_NAME, publish_acquire) {
+  auto rng = esim_test::gen_testcase();
+  esim::core::triple_buffer<int> buffer;
+  int x = esim_test::random(rng, 1, 1000);
+
+  buffer.publish(x);
+  EXPECT_TRUE(buffer.dirty());
+  EXPECT_TRUE(buffer.acquire());
+  EXPECT_EQ(buffer.read_buffer(), x);
+  EXPECT_FALSE(buffer.dirty());
+  EXPECT_FALSE(buffer.acquire());
+  EXPECT_EQ(buffer.read_buffer(), x);
+}
+
+TEST_F(TEST_NAME, latest_wins) {
+  esim::core::triple_buffer<int> buffer;
+  for (int i = 1; i <= 10; ++i) {
+    buffer.write_buffer() = i;
+    buffer.publish();
+  }
+
+  EXPECT_TRUE(buffer.acquire());
+  EXPECT_EQ(buffer.read_buffer(), 10);
+
+  buffer.publish(11);
+  buffer.publish(12);
+  EXPECT_TRUE(buffer.acquire());
+  EXPECT_EQ(buffer.read_buffer(), 12);
+}
+
+TEST_F(TEST_NAME, acquire_for) {
+  using namespace std::chrono;
+  esim::core::triple_buffer<int> buffer;
+
+  EXPECT_FALSE(buffer.acquire_for(milliseconds{10}));
+
+  std::thread writer([&]() {
+    std::this_thread::sleep_for(milliseconds{10});
+    buffer.publish(42);
+  });
+  EXPECT_TRUE(buffer.acquire_for(seconds{5}));
+  EXPECT_EQ(buffer.read_buffer(), 42);
+  writer.join();
+}
+
+TEST_F(TEST_NAME, monotonic) {
+  /// the reader never sees a value older than the one before, nor a torn one.
+  struct pair {
+    int first, second;
+  };
+  esim::core::triple_buffer<pair> buffer{pair{0, 0}};
+  constexpr static int count = 100000;
+
+  std::thread writer([&]() {
+    for (int i = 1; i <= count; ++i) {
+      buffer.write_buffer() = pair{i, -i};
+      buffer.publish();
+    }
+  });
+
+  int last = 0;
+  while (last < count) {
+    if (buffer.acquire_for(std::chrono::seconds{5})) {
+      auto &value = buffer.read_buffer();
+      ASSERT_EQ(value.first, -value.second);
+      ASSERT_GT(value.first, last);
+      last = value.first;
+    }
+  }
+  writer.join();
+}
@@ -0,0 +1,154 @@
+#include "core/unbounded_queue.h"
+#include "test_helper.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#define TEST_NAME esim_unbounded_queue_test
+
+class TEST_NAME : public testing::Test {
+
+};
+
+TEST_F(TEST_NAME, empty) {
+  esim::core::unbounded_queue<int> q;
+  EXPECT_TRUE(q.empty());
+
+  int x = 0;
+  EXPECT_FALSE(q.try_pop(x));
+}
+
+TEST_F(TEST_NAME, push_pop) {
+  /// crosses many segments, the order kept.
+  auto rng = esim_test::gen_testcase();
+  std::vector<int> expect, actual;
+  esim::core::unbounded_queue<int> q{4, 2};
+
+  for (size_t i = 0; i < 100; ++i) {
+    int x = esim_test::random(rng, 0, 2000);
+    q.push(x);
+    expect.emplace_back(x);
+  }
+  EXPECT_FALSE(q.empty());
+
+  int x;
+  while (q.try_pop(x)) {
+    actual.emplace_back(x);
+  }
+  EXPECT_TRUE(q.empty());
+  EXPECT_EQ(actual, expect);
+}
+
+TEST_F(TEST_NAME, bursts) {
+  /// segments recycled by the pool, each burst drained before the next.
+  esim::core::unbounded_queue<int> q{8, 4};
+  for (int burst = 0; burst < 10; ++burst) {
+    for (int i = 0; i < 100; ++i) {
+      q.emplace(burst * 100 + i);
+    }
+    int x;
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_TRUE(q.try_pop(x));
+      ASSERT_EQ(x, burst * 100 + i);
+    }
+    EXPECT_FALSE(q.try_pop(x));
+  }
+}
+
+TEST_F(TEST_NAME, non_trivial) {
+  auto value = std::make_shared<int>(10);
+  {
+    esim::core::unbounded_queue<std::shared_ptr<int>> q{4};
+    for (int i = 0; i < 10; ++i) {
+      q.push(value);
+    }
+    std::shared_ptr<int> out;
+    EXPECT_TRUE(q.try_pop(out));
+    EXPECT_EQ(value.use_count(), 11);
+  }
+  EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST_F(TEST_NAME, try_pop_for) {
+  using namespace std::chrono;
+  esim::core::unbounded_queue<int> q;
+  int x = 0;
+
+  EXPECT_FALSE(q.try_pop_for(x, milliseconds{10}));
+
+  std::thread producer([&]() {
+    std::this_thread::sleep_for(milliseconds{10});
+    q.push(42);
+  });
+  EXPECT_TRUE(q.try_pop_for(x, seconds{5}));
+  EXPECT_EQ(x, 42);
+  producer.join();
+}
+
+TEST_F(TEST_NAME, pool_of_one) {
+  /// the segments recycled through the smallest pools, kept at least 2.
+  for (uint32_t pool_size : {0U, 1U}) {
+    constexpr static long count = 100000;
+    esim::core::unbounded_queue<long> q{256, pool_size};
+    std::thread producer([&]() {
+      for (long i = 0; i < count; ++i) {
+        q.push(i);
+      }
+    });
+    long sum = 0, x = 0;
+    for (long i = 0; i < count; ++i) {
+      q.pop(x);
+      sum += x;
+    }
+    producer.join();
+    EXPECT_EQ(sum, count * (count - 1) / 2);
+    EXPECT_TRUE(q.empty());
+  }
+}
+
+TEST_F(TEST_NAME, concurrent) {
+  constexpr static int producers = 4, consumers = 4, per_producer = 20000;
+  esim::core::unbounded_queue<int> q{32, 4};
+  std::atomic<long long> sum{0};
+  std::atomic<int> popped{0};
+  /// the items of a producer are popped in order by any consumer.
+  std::vector<std::vector<int>> seen(consumers);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (int i = 0; i < per_producer; ++i) {
+        q.push(p * per_producer + i);
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c]() {
+      std::vector<int> last(producers, -1);
+      int x;
+      while (popped.load() < producers * per_producer) {
+        if (!q.try_pop_for(x, std::chrono::milliseconds{1})) {
+          continue;
+        }
+        int p = x / per_producer;
+        if (x <= last[p]) {
+          seen[c].emplace_back(x);
+        }
+        last[p] = x;
+        sum += x;
+        ++popped;
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  long long total = static_cast<long long>(producers) * per_producer;
+  EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+  for (auto &disorder : seen) {
+    EXPECT_TRUE(disorder.empty());
+  }
+  EXPECT_TRUE(q.empty());
+}
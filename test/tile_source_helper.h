@@ -0,0 +1,31 @@
+#ifndef __ESIM_TEST_TILE_SOURCE_HELPER_H_
+#define __ESIM_TEST_TILE_SOURCE_HELPER_H_
+
+#include "details/tile_source.h"
+#include <string>
+
+namespace esim_test {
+
+/**
+ * @brief Tile source answering every fetch with the status scripted,
+ * counting the fetches.
+ *
+ */
+class scripted_tile_source final : public esim::tile_source {
+public:
+  status fetch(const esim::geo::maptile &, std::string &data) noexcept final {
+    ++fetches;
+    data = esim::TILE_SUCCESS == result ? "encoded" : "";
+
+    return result;
+  }
+
+  explicit scripted_tile_source(status s) noexcept : result{s} {}
+
+  status result;
+  size_t fetches = 0;
+};
+
+} // namespace esim_test
+
+#endif